@@ -0,0 +1,246 @@
+/**
+ * Operator Performance Regression Gate
+ * Records baseline operator timings (see benchmark-operators.js) per
+ * heuristic file and instance size, and checks later builds against them.
+ * Each benchmark is repeated in several processes (timings shift by 10-30%
+ * between processes with memory layout alone); the ratio current/baseline of
+ * the mean time per call gets a bootstrap 95% confidence interval over all
+ * samples, and a benchmark fails the gate when the whole interval lies above
+ * 1 + threshold.
+ *
+ * Usage: node benchmark-gate.js record|check [options]
+ *   --types, --sets, --filter, --sizes, --families, --instance, --min-time
+ *                              as in benchmark-operators.js (default: optimized heuristics, clustered 100/1k/10k)
+ *   --repetitions <n>          samples per benchmark and process (default 10)
+ *   --processes <n>            benchmark processes per heuristic (default 3)
+ *   --threshold <fraction>     tolerated slowdown (default 0.5, i.e. 1.5x)
+ *   --baseline-dir <dir>       baselines, one JSON file per heuristic (default build/bench/baselines)
+ *   --report <file>            diff table in Markdown (default build/bench/regression.md)
+ *
+ * check exits with status 1 when any benchmark regressed.
+ */
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+const { listHeuristics, benchmarkHeuristic, parseArgs } = require('./benchmark-operators');
+
+const colors = {
+  reset: '\x1b[0m',
+  green: '\x1b[32m',
+  red: '\x1b[31m',
+  yellow: '\x1b[33m',
+  blue: '\x1b[36m',
+  bold: '\x1b[1m'
+};
+
+function log(message, color = 'reset') {
+  console.log(`${colors[color]}${message}${colors.reset}`);
+}
+
+const BOOTSTRAP_RESAMPLES = 2000;
+
+function parseGateArgs(argv) {
+  const [command, ...rest] = argv;
+  if (command !== 'record' && command !== 'check') {
+    throw new Error('Usage: node benchmark-gate.js record|check [options]');
+  }
+
+  const gate = {
+    threshold: 0.5,
+    processes: 3,
+    baselineDir: path.join(__dirname, 'build', 'bench', 'baselines'),
+    report: path.join(__dirname, 'build', 'bench', 'regression.md')
+  };
+  const passthrough = ['--sets', 'optimized', '--families', 'clustered', '--repetitions', '10', '--min-time', '0.05'];
+  for (let i = 0; i < rest.length; i++) {
+    switch (rest[i]) {
+      case '--threshold': gate.threshold = parseFloat(rest[++i]); break;
+      case '--processes': gate.processes = parseInt(rest[++i], 10); break;
+      case '--baseline-dir': gate.baselineDir = path.resolve(rest[++i]); break;
+      case '--report': gate.report = path.resolve(rest[++i]); break;
+      default: passthrough.push(rest[i]);
+    }
+  }
+  // Later occurrences win, so explicit options override the defaults above
+  const options = parseArgs(passthrough);
+  return { command, gate, options: { ...options, aggregatesOnly: false, interleave: true } };
+}
+
+// Deterministic PRNG so that a gate verdict is reproducible for the same samples
+function mulberry32(seed) {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+const mean = values => values.reduce((sum, v) => sum + v, 0) / values.length;
+
+/**
+ * Bootstrap percentile interval of mean(current) / mean(baseline),
+ * resampling both sample sets independently.
+ */
+function bootstrapRatio(baseline, current, random) {
+  const resampledMean = samples => {
+    let sum = 0;
+    for (let i = 0; i < samples.length; i++) {
+      sum += samples[Math.floor(random() * samples.length)];
+    }
+    return sum / samples.length;
+  };
+  const ratios = [];
+  for (let b = 0; b < BOOTSTRAP_RESAMPLES; b++) {
+    ratios.push(resampledMean(current) / resampledMean(baseline));
+  }
+  ratios.sort((a, b) => a - b);
+  return {
+    ratio: mean(current) / mean(baseline),
+    low: ratios[Math.floor(0.025 * BOOTSTRAP_RESAMPLES)],
+    high: ratios[Math.ceil(0.975 * BOOTSTRAP_RESAMPLES) - 1]
+  };
+}
+
+// Per-repetition ns/call samples, keyed by operator/instance/numCustomers
+function collectSamples(result, samples = {}) {
+  for (const benchmark of result.benchmarks) {
+    if (benchmark.aggregate !== null || benchmark.error) continue;
+    const key = `${benchmark.operator}/${benchmark.instance}/${benchmark.numCustomers}`;
+    (samples[key] = samples[key] || []).push(benchmark.nsPerCall);
+  }
+  return samples;
+}
+
+function baselineFile(gate, heuristic) {
+  return path.join(gate.baselineDir, heuristic.type, `${heuristic.name}.json`);
+}
+
+function sourceHash(heuristic) {
+  return crypto.createHash('sha256').update(fs.readFileSync(heuristic.source)).digest('hex');
+}
+
+function compare(heuristic, baseline, samples, gate, random) {
+  const rows = [];
+  for (const key of Object.keys(samples)) {
+    const row = { heuristic: heuristic.name, benchmark: key, current: mean(samples[key]) };
+    const reference = baseline && baseline.samples[key];
+    if (!reference) {
+      rows.push({ ...row, verdict: 'new' });
+      continue;
+    }
+    const interval = bootstrapRatio(reference, samples[key], random);
+    let verdict = 'ok';
+    if (interval.low > 1 + gate.threshold) verdict = 'SLOWER';
+    else if (interval.high < 1 / (1 + gate.threshold)) verdict = 'faster';
+    rows.push({ ...row, baseline: mean(reference), ...interval, verdict });
+  }
+  return rows;
+}
+
+function formatNs(ns) {
+  if (ns === undefined) return '-';
+  return ns >= 1e6 ? `${(ns / 1e6).toFixed(2)} ms` : ns >= 1e3 ? `${(ns / 1e3).toFixed(2)} µs` : `${ns.toFixed(0)} ns`;
+}
+
+function writeReport(gate, rows, failures) {
+  const lines = [
+    '# Operator performance regression report',
+    '',
+    `Threshold: ${(gate.threshold * 100).toFixed(0)}% slowdown, 95% bootstrap confidence interval of the mean ratio.`,
+    '',
+    '| Heuristic | Benchmark | Baseline | Current | Ratio | 95% CI | Verdict |',
+    '|-----------|-----------|---------:|--------:|------:|--------|---------|'
+  ];
+  for (const row of rows) {
+    const ratio = row.ratio === undefined ? '-' : `${row.ratio.toFixed(2)}x`;
+    const ci = row.low === undefined ? '-' : `[${row.low.toFixed(2)}, ${row.high.toFixed(2)}]`;
+    const verdict = row.verdict === 'SLOWER' ? '**SLOWER**' : row.verdict;
+    lines.push(`| ${row.heuristic} | ${row.benchmark} | ${formatNs(row.baseline)} | ${formatNs(row.current)} | ${ratio} | ${ci} | ${verdict} |`);
+  }
+  if (failures.length) {
+    lines.push('', '## Not benchmarked', '');
+    for (const failure of failures) {
+      lines.push(`- ${failure.name}: ${failure.status} (${failure.error.split('\n')[0]})`);
+    }
+  }
+  fs.mkdirSync(path.dirname(gate.report), { recursive: true });
+  fs.writeFileSync(gate.report, lines.join('\n') + '\n');
+}
+
+async function runGate() {
+  const { command, gate, options } = parseGateArgs(process.argv.slice(2));
+  const heuristics = listHeuristics(options);
+  log(`\n${command === 'record' ? 'Recording baselines' : 'Checking'} for ${heuristics.length} heuristics ` +
+      `(${gate.processes} x ${options.repetitions} repetitions, ${options.families} x ${options.sizes})`, 'bold');
+
+  const random = mulberry32(0x5eed);
+  const rows = [];
+  const failures = [];
+  for (const heuristic of heuristics) {
+    let result;
+    const samples = {};
+    for (let p = 0; p < gate.processes; p++) {
+      result = await benchmarkHeuristic(heuristic, options);
+      if (result.status !== 'ok') break;
+      collectSamples(result, samples);
+    }
+    if (result.status !== 'ok') {
+      log(`✗ ${heuristic.name}: ${result.status}`, 'red');
+      failures.push(result);
+      continue;
+    }
+
+    if (command === 'record') {
+      const file = baselineFile(gate, heuristic);
+      fs.mkdirSync(path.dirname(file), { recursive: true });
+      fs.writeFileSync(file, JSON.stringify({
+        name: heuristic.name,
+        source: result.source,
+        sourceHash: sourceHash(heuristic),
+        date: new Date().toISOString(),
+        host: result.context && result.context.host_name,
+        samples
+      }, null, 2));
+      log(`✓ ${heuristic.name}: baseline recorded`, 'green');
+      continue;
+    }
+
+    const file = baselineFile(gate, heuristic);
+    const baseline = fs.existsSync(file) ? JSON.parse(fs.readFileSync(file, 'utf8')) : null;
+    const heuristicRows = compare(heuristic, baseline, samples, gate, random);
+    const slower = heuristicRows.filter(row => row.verdict === 'SLOWER');
+    const changed = baseline && baseline.sourceHash !== sourceHash(heuristic) ? ' (source changed since baseline)' : '';
+    if (slower.length) {
+      log(`✗ ${heuristic.name}: ${slower.map(row => `${row.benchmark} ${row.ratio.toFixed(2)}x`).join(', ')}${changed}`, 'red');
+    } else {
+      log(`✓ ${heuristic.name}${baseline ? '' : ': no baseline'}${changed}`, baseline ? 'green' : 'yellow');
+    }
+    rows.push(...heuristicRows);
+  }
+
+  if (command === 'record') {
+    log(`\nBaselines written to ${path.relative(process.cwd(), gate.baselineDir)}`, 'blue');
+    return;
+  }
+
+  writeReport(gate, rows, failures);
+  const regressions = rows.filter(row => row.verdict === 'SLOWER');
+  console.log('\n' + '='.repeat(60));
+  log(`✓ Within threshold: ${rows.filter(row => row.verdict === 'ok' || row.verdict === 'faster').length}`, 'green');
+  log(`ℹ Without baseline: ${rows.filter(row => row.verdict === 'new').length}`, 'yellow');
+  log(`✗ Regressed: ${regressions.length}`, regressions.length ? 'red' : 'green');
+  log(`\nDiff table written to ${path.relative(process.cwd(), gate.report)}`, 'blue');
+  console.log('='.repeat(60) + '\n');
+  if (regressions.length || failures.length) {
+    process.exitCode = 1;
+  }
+}
+
+runGate().catch(error => {
+  console.error('Gate error:', error.message);
+  process.exit(1);
+});
@@ -0,0 +1,225 @@
+/**
+ * Operator Microbenchmarks
+ * Builds every generated heuristic (optimized and example start population)
+ * against backend/native/operator_bench.cpp and measures select_by_llm_1 /
+ * sort_by_llm_1 per call: time, allocations and cache misses, on synthetic
+ * instances of 100/1k/10k customers and optional CVRPLIB files.
+ *
+ * Usage: node benchmark-operators.js [options]
+ *   --types cvrp,pcvrp,vrptw        problem variants to include
+ *   --sets optimized,population     heuristic sets to include
+ *   --filter <text>                 only heuristics whose name contains text
+ *   --sizes 100,1000,10000          synthetic instance sizes
+ *   --families uniform,clustered    synthetic instance families
+ *   --instance <file.vrp>           CVRPLIB instance, repeatable
+ *   --min-time <seconds>            Google Benchmark min time per benchmark (default 0.2)
+ *   --repetitions <n>               Google Benchmark repetitions (default 1)
+ *   --budget-ns <ns>                flag heuristics whose select + sort exceed this per call (default 20000)
+ *   --out <file>                    JSON report (default build/bench/operators.json)
+ */
+
+const { execFile } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const { promisify } = require('util');
+const { compileHeuristic, HEURISTICS_DIR } = require('./solver/compiler');
+
+const execFileAsync = promisify(execFile);
+
+const colors = {
+  reset: '\x1b[0m',
+  green: '\x1b[32m',
+  red: '\x1b[31m',
+  yellow: '\x1b[33m',
+  blue: '\x1b[36m',
+  bold: '\x1b[1m'
+};
+
+function log(message, color = 'reset') {
+  console.log(`${colors[color]}${message}${colors.reset}`);
+}
+
+const RUN_TIMEOUT_MS = 15 * 60 * 1000;
+
+function parseArgs(argv) {
+  const options = {
+    types: ['cvrp', 'pcvrp', 'vrptw'],
+    sets: ['optimized', 'population'],
+    filter: '',
+    sizes: '100,1000,10000',
+    families: 'uniform,clustered',
+    instances: [],
+    minTime: 0.2,
+    repetitions: 1,
+    budgetNs: 20000,
+    out: path.join(__dirname, 'build', 'bench', 'operators.json')
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const value = argv[i + 1];
+    switch (argv[i]) {
+      case '--types': options.types = value.split(','); i++; break;
+      case '--sets': options.sets = value.split(','); i++; break;
+      case '--filter': options.filter = value; i++; break;
+      case '--sizes': options.sizes = value; i++; break;
+      case '--families': options.families = value; i++; break;
+      case '--instance': options.instances.push(path.resolve(value)); i++; break;
+      case '--min-time': options.minTime = parseFloat(value); i++; break;
+      case '--repetitions': options.repetitions = parseInt(value, 10); i++; break;
+      case '--budget-ns': options.budgetNs = parseFloat(value); i++; break;
+      case '--out': options.out = path.resolve(value); i++; break;
+      default: throw new Error(`Unknown option ${argv[i]}`);
+    }
+  }
+  return options;
+}
+
+// Every heuristic source of the selected types and sets, as { name, type, set, source }
+function listHeuristics(options) {
+  const heuristics = [];
+  for (const type of options.types) {
+    const optimizedDir = path.join(HEURISTICS_DIR, type, 'optimized_heuristics');
+    if (options.sets.includes('optimized') && fs.existsSync(optimizedDir)) {
+      for (const file of fs.readdirSync(optimizedDir).filter(f => f.endsWith('.cpp')).sort()) {
+        const score = file.replace('best_solution_', '').replace('.cpp', '');
+        heuristics.push({ name: `${type}_${score}`, type, set: 'optimized', source: path.join(optimizedDir, file) });
+      }
+    }
+    const populationDir = path.join(HEURISTICS_DIR, type, 'example_start_population');
+    if (options.sets.includes('population') && fs.existsSync(populationDir)) {
+      const individuals = fs.readdirSync(populationDir)
+        .filter(dir => fs.existsSync(path.join(populationDir, dir, 'code.cpp')))
+        .sort((a, b) => a.localeCompare(b, undefined, { numeric: true }));
+      for (const dir of individuals) {
+        heuristics.push({ name: `${type}_${dir}`, type, set: 'population', source: path.join(populationDir, dir, 'code.cpp') });
+      }
+    }
+  }
+  return heuristics.filter(h => h.name.includes(options.filter));
+}
+
+// Google Benchmark JSON entry -> per-call record
+function toRecord(benchmark) {
+  const [operator, instance, numCustomers] = benchmark.run_name.split('/');
+  const scale = { ns: 1, us: 1e3, ms: 1e6, s: 1e9 }[benchmark.time_unit];
+  return {
+    operator,
+    instance,
+    numCustomers: parseInt(numCustomers, 10),
+    aggregate: benchmark.aggregate_name || null,
+    iterations: benchmark.iterations,
+    nsPerCall: benchmark.real_time * scale,
+    cpuNsPerCall: benchmark.cpu_time * scale,
+    allocsPerCall: benchmark.allocs,
+    allocBytesPerCall: benchmark.alloc_bytes,
+    cacheMissesPerCall: benchmark.cache_misses === undefined ? null : benchmark.cache_misses,
+    selected: benchmark.selected,
+    error: benchmark.error_occurred ? benchmark.error_message : null
+  };
+}
+
+async function benchmarkHeuristic(heuristic, options) {
+  const result = { name: heuristic.name, type: heuristic.type, set: heuristic.set, source: path.relative(path.join(__dirname, '..'), heuristic.source) };
+  let binary;
+  try {
+    binary = await compileHeuristic(heuristic, 'bench');
+  } catch (error) {
+    return { ...result, status: 'compile_error', error: (error.stderr || error.message).split('\n').slice(0, 5).join('\n') };
+  }
+
+  const args = [
+    `--type=${heuristic.type}`,
+    `--sizes=${options.sizes}`,
+    `--families=${options.families}`,
+    ...options.instances.map(file => `--instance=${file}`),
+    '--benchmark_format=json',
+    `--benchmark_min_time=${options.minTime}`,
+    `--benchmark_repetitions=${options.repetitions}`
+  ];
+  // The regression gate keeps every repetition as a sample (aggregatesOnly: false)
+  if (options.repetitions > 1 && options.aggregatesOnly !== false) args.push('--benchmark_report_aggregates_only=true');
+  if (options.repetitions > 1 && options.interleave) args.push('--benchmark_enable_random_interleaving=true');
+
+  try {
+    const { stdout } = await execFileAsync(binary, args, { timeout: RUN_TIMEOUT_MS, maxBuffer: 64 * 1024 * 1024 });
+    const report = JSON.parse(stdout);
+    return { ...result, status: 'ok', context: report.context, benchmarks: report.benchmarks.map(toRecord) };
+  } catch (error) {
+    const reason = error.killed ? 'timed out' : error.signal ? `killed by ${error.signal}` : (error.stderr || error.message).trim();
+    return { ...result, status: 'run_error', error: reason };
+  }
+}
+
+// Mean per-call time of one operator on one instance (the mean aggregate when repeating)
+function callTime(heuristic, operator, instance, numCustomers) {
+  const match = heuristic.benchmarks.find(b =>
+    b.operator === operator && b.instance === instance && b.numCustomers === numCustomers &&
+    (b.aggregate === null || b.aggregate === 'mean'));
+  return match ? match.nsPerCall : NaN;
+}
+
+function printSummary(results, options) {
+  console.log('\n' + '='.repeat(100));
+  log('Operator Benchmark Summary (ns/call, select + sort)', 'bold');
+  console.log('='.repeat(100));
+
+  const ok = results.filter(r => r.status === 'ok');
+  const columns = [...new Set(ok.flatMap(r => r.benchmarks.map(b => `${b.instance}/${b.numCustomers}`)))];
+  console.log('Heuristic'.padEnd(28) + columns.map(c => c.padStart(22)).join(''));
+
+  let overBudget = 0;
+  for (const heuristic of ok) {
+    let over = false;
+    const cells = columns.map(column => {
+      const [instance, numCustomers] = column.split('/');
+      const select = callTime(heuristic, 'select', instance, parseInt(numCustomers, 10));
+      const sort = callTime(heuristic, 'sort', instance, parseInt(numCustomers, 10));
+      if (select + sort > options.budgetNs) over = true;
+      return `${select.toFixed(0)} + ${sort.toFixed(0)}`.padStart(22);
+    });
+    if (over) overBudget++;
+    log(heuristic.name.padEnd(28) + cells.join(''), over ? 'red' : 'reset');
+  }
+
+  console.log('='.repeat(100));
+  log(`✓ Benchmarked: ${ok.length}`, 'green');
+  log(`⚠ Over ${options.budgetNs} ns/call budget: ${overBudget}`, overBudget ? 'yellow' : 'green');
+  const failed = results.filter(r => r.status !== 'ok');
+  log(`✗ Failed: ${failed.length}`, failed.length ? 'red' : 'green');
+  for (const heuristic of failed) {
+    log(`  ${heuristic.name} (${heuristic.status}): ${heuristic.error.split('\n')[0]}`, 'red');
+  }
+}
+
+async function runBenchmarks() {
+  const options = parseArgs(process.argv.slice(2));
+  const heuristics = listHeuristics(options);
+  log(`\nBenchmarking ${heuristics.length} heuristics on ${options.families} x ${options.sizes}` +
+      (options.instances.length ? ` and ${options.instances.length} instance files` : ''), 'bold');
+
+  // Benchmarks run one at a time so they do not disturb each other's timings
+  const results = [];
+  for (const heuristic of heuristics) {
+    const result = await benchmarkHeuristic(heuristic, options);
+    log(`${result.status === 'ok' ? '✓' : '✗'} ${heuristic.name}`, result.status === 'ok' ? 'green' : 'red');
+    results.push(result);
+  }
+
+  printSummary(results, options);
+
+  fs.mkdirSync(path.dirname(options.out), { recursive: true });
+  fs.writeFileSync(options.out, JSON.stringify({
+    date: new Date().toISOString(),
+    options: { ...options, out: undefined },
+    heuristics: results
+  }, null, 2));
+  log(`\nReport written to ${path.relative(process.cwd(), options.out)}`, 'blue');
+}
+
+if (require.main === module) {
+  runBenchmarks().catch(error => {
+    console.error('Benchmark error:', error);
+    process.exit(1);
+  });
+}
+
+module.exports = { listHeuristics, benchmarkHeuristic, parseArgs };
@@ -0,0 +1,658 @@
+/**
+ * Generation Evaluation
+ * Scores a whole generation of evolved heuristics (by default every
+ * individual of generated_heuristics/<type>/example_start_population) and
+ * appends the results to the generation's evaluation store
+ * (<population dir>/evaluations.store, see solver/evaluationStore.js):
+ * objective per instance, wall and CPU time, iterations per second, peak
+ * RSS, operator latency percentiles and the failure reason.
+ *
+ * Every individual runs the same LNS (backend/native/anytime_profile.cpp) on
+ * the same fixed batch of instances and seeds. Runs stop after a number of
+ * iterations rather than after a time budget, so a fitness does not depend
+ * on how busy the machine was; --budget-ms only caps runaway runs, and a run
+ * stopped by it is marked truncated. Fitness is the mean final objective over
+ * all runs (lower is better, as for every problem type); an individual that
+ * fails to compile, crashes or overruns its cap gets fitness null.
+ *
+ * The heuristic code runs in a sandbox (native/Sandbox.h): a forked child
+ * of the profiler with CPU time and address space limits, a seccomp filter
+ * and a watchdog, so an individual that loops, allocates without bound or
+ * tries to exec, fork or open sockets is stopped and recorded with status
+ * timeout, cpu_limit, out_of_memory, violation or crashed instead of
+ * stalling or taking down the batch. --no-sandbox runs it unconfined.
+ *
+ * Pipeline: all individuals are compiled first, then evaluated, each stage by
+ * a pool of --jobs concurrent processes (one per core by default). On Linux
+ * each individual is built as a plugin that only holds its own code and
+ * runs in one prebuilt profiler host (solver/compiler.js; SOLVER_LINK=static
+ * links a profiler per individual instead). Objects are cached by content,
+ * and an individual whose latest stored row was produced by the same sources
+ * and settings is not evaluated again unless --force is given.
+ *
+ * With --race the generation is first raced (F-race, Birattari et al. 2002):
+ * all candidates run the instance/seed pairs of the batch one at a time
+ * with a fraction of the iterations, and after every pair a Friedman test
+ * over the objectives, followed by its post-hoc comparison, discards the
+ * candidates that are significantly worse than the best. The race stops
+ * when the pairs run out or --race-keep candidates are left; only the
+ * survivors get the full evaluation, so their fitness is the same as
+ * without racing. Eliminated individuals get status 'eliminated'.
+ *
+ * Usage: node evaluate-generation.js [options]
+ *   --types cvrp,pcvrp,vrptw        problem variants to evaluate
+ *   --dir <population dir>          evaluate this directory of individuals (needs a single --types)
+ *   --filter <text>                 only individuals whose name contains text
+ *   --sizes 100                     synthetic instance sizes
+ *   --families uniform,clustered    synthetic instance families
+ *   --instance <file.vrp>           CVRPLIB instance, repeatable
+ *   --seeds <n>|<a,b,c>             number of seeds (1..n) or explicit list (default 3)
+ *   --iterations <n>                LNS iterations per run (default 2000)
+ *   --budget-ms <ms>                wall-clock cap per run (default 10000)
+ *   --instance-seed <n>             seed of the synthetic instances (default 1)
+ *   --jobs <n>                      concurrent compilations and evaluations (default CPU count)
+ *   --force                         re-evaluate individuals with an up-to-date stored row
+ *   --memory-mb 2048                address space limit of the sandbox
+ *   --no-sandbox                    run heuristics without the sandbox
+ *   --race                          race the generation before the full evaluation
+ *   --race-budget 0.25              fraction of --iterations per race run
+ *   --race-min-blocks 8             instance/seed pairs before the first elimination
+ *   --race-alpha 0.05               significance level of the Friedman test
+ *   --race-keep 20                  never eliminate below this many candidates
+ *
+ * Appends to <population dir>/evaluations.store and writes a ranking of
+ * every evaluated population to build/evaluation/<type>-<population>.json.
+ */
+
+const { execFile } = require('child_process');
+const crypto = require('crypto');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+const { promisify } = require('util');
+const {
+  compileHeuristic,
+  compilePluginHost,
+  pluginHostPath,
+  usePlugins,
+  solverFingerprint,
+  HEURISTICS_DIR,
+  PLUGIN_ENV
+} = require('./solver/compiler');
+const { StoreWriter, storePath, loadStore, latestRows } = require('./solver/evaluationStore');
+
+const execFileAsync = promisify(execFile);
+
+const colors = {
+  reset: '\x1b[0m',
+  green: '\x1b[32m',
+  red: '\x1b[31m',
+  yellow: '\x1b[33m',
+  blue: '\x1b[36m',
+  bold: '\x1b[1m'
+};
+
+function log(message, color = 'reset') {
+  console.log(`${colors[color]}${message}${colors.reset}`);
+}
+
+function parseArgs(argv) {
+  const options = {
+    types: ['cvrp', 'pcvrp', 'vrptw'],
+    dir: null,
+    filter: '',
+    sizes: '100',
+    families: 'uniform,clustered',
+    instances: [],
+    seeds: [1, 2, 3],
+    iterations: 2000,
+    budgetMs: 10000,
+    instanceSeed: 1,
+    jobs: os.cpus().length,
+    force: false,
+    sandbox: true,
+    memoryMb: 2048,
+    race: false,
+    raceBudget: 0.25,
+    raceMinBlocks: 8,
+    raceAlpha: 0.05,
+    raceKeep: 20,
+    outDir: path.join(__dirname, 'build', 'evaluation')
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const value = argv[i + 1];
+    switch (argv[i]) {
+      case '--types': options.types = value.split(','); i++; break;
+      case '--dir': options.dir = path.resolve(value); i++; break;
+      case '--filter': options.filter = value; i++; break;
+      case '--sizes': options.sizes = value; i++; break;
+      case '--families': options.families = value; i++; break;
+      case '--instance': options.instances.push(path.resolve(value)); i++; break;
+      case '--seeds':
+        options.seeds = value.includes(',')
+          ? value.split(',').map(seed => parseInt(seed, 10))
+          : Array.from({ length: parseInt(value, 10) }, (_, k) => k + 1);
+        i++;
+        break;
+      case '--iterations': options.iterations = parseInt(value, 10); i++; break;
+      case '--budget-ms': options.budgetMs = parseFloat(value); i++; break;
+      case '--instance-seed': options.instanceSeed = parseInt(value, 10); i++; break;
+      case '--jobs': options.jobs = Math.max(1, parseInt(value, 10)); i++; break;
+      case '--force': options.force = true; break;
+      case '--memory-mb': options.memoryMb = parseInt(value, 10); i++; break;
+      case '--no-sandbox': options.sandbox = false; break;
+      case '--race': options.race = true; break;
+      case '--race-budget': options.raceBudget = parseFloat(value); i++; break;
+      case '--race-min-blocks': options.raceMinBlocks = Math.max(2, parseInt(value, 10)); i++; break;
+      case '--race-alpha': options.raceAlpha = parseFloat(value); i++; break;
+      case '--race-keep': options.raceKeep = Math.max(1, parseInt(value, 10)); i++; break;
+      default: throw new Error(`Unknown option ${argv[i]}`);
+    }
+  }
+  if (options.dir && options.types.length !== 1) {
+    throw new Error('--dir needs exactly one --types');
+  }
+  return options;
+}
+
+// Individuals { name, type, population, dir, source }: subdirectories holding a code.cpp
+function listIndividuals(options) {
+  const individuals = [];
+  for (const type of options.types) {
+    const populationDir = options.dir || path.join(HEURISTICS_DIR, type, 'example_start_population');
+    if (!fs.existsSync(populationDir)) continue;
+    const population = path.basename(populationDir);
+    const dirs = fs.readdirSync(populationDir)
+      .filter(dir => fs.existsSync(path.join(populationDir, dir, 'code.cpp')))
+      .sort((a, b) => a.localeCompare(b, undefined, { numeric: true }));
+    for (const dir of dirs) {
+      individuals.push({
+        name: `${type}_${dir}`,
+        type,
+        population,
+        dir: path.join(populationDir, dir),
+        source: path.join(populationDir, dir, 'code.cpp')
+      });
+    }
+  }
+  return individuals.filter(individual => individual.name.includes(options.filter));
+}
+
+// Settings that determine a fitness; part of the evaluation key
+function evaluationSettings(options) {
+  return {
+    sizes: options.sizes,
+    families: options.families,
+    instances: options.instances.map(file => path.basename(file)),
+    seeds: options.seeds,
+    iterations: options.iterations,
+    budgetMs: options.budgetMs,
+    instanceSeed: options.instanceSeed,
+    sandbox: options.sandbox ? { memoryMb: options.memoryMb } : null
+  };
+}
+
+function raceSettings(options) {
+  return {
+    budget: options.raceBudget,
+    minBlocks: options.raceMinBlocks,
+    alpha: options.raceAlpha,
+    keep: options.raceKeep
+  };
+}
+
+// A full evaluation is keyed by sources and settings; an elimination also by the race settings
+function evaluationKey(individual, options, raced = false) {
+  const hash = crypto.createHash('sha256')
+    .update(solverFingerprint(individual))
+    .update(JSON.stringify(evaluationSettings(options)));
+  if (raced) {
+    hash.update(JSON.stringify(raceSettings(options)));
+  }
+  return hash.digest('hex');
+}
+
+const populationDir = individual => path.dirname(individual.dir);
+
+/**
+ * Runs task(item) for every item with at most `jobs` running at once and
+ * resolves to the results in item order. Tasks must not reject.
+ */
+async function runPool(items, jobs, task) {
+  const results = new Array(items.length);
+  let next = 0;
+  const lanes = Array.from({ length: Math.min(jobs, items.length) }, async () => {
+    while (next < items.length) {
+      const index = next++;
+      results[index] = await task(items[index], index);
+    }
+  });
+  await Promise.all(lanes);
+  return results;
+}
+
+function firstLine(text) {
+  return String(text || '').split('\n').find(line => line.trim()) || '';
+}
+
+// The whole evaluation batch: every instance with every seed
+function fullBatch(options) {
+  const numInstances = options.sizes.split(',').length * options.families.split(',').length + options.instances.length;
+  return {
+    args: [
+      `--sizes=${options.sizes}`,
+      `--families=${options.families}`,
+      ...options.instances.map(file => `--instance=${file}`),
+      `--seeds=${options.seeds.join(',')}`
+    ],
+    numRuns: numInstances * options.seeds.length,
+    iterations: options.iterations
+  };
+}
+
+// The batch as single instance/seed pairs, seed-major so that the first blocks of a race cover every instance
+function raceBlocks(options, iterations) {
+  const instances = [];
+  for (const family of options.families.split(',')) {
+    for (const size of options.sizes.split(',')) {
+      instances.push([`--sizes=${size}`, `--families=${family}`]);
+    }
+  }
+  for (const file of options.instances) {
+    instances.push(['--sizes=', '--families=', `--instance=${file}`]);
+  }
+  const blocks = [];
+  for (const seed of options.seeds) {
+    for (const args of instances) {
+      blocks.push({ args: [...args, `--seeds=${seed}`], numRuns: 1, iterations });
+    }
+  }
+  return blocks;
+}
+
+// The sandbox verdict line a profiler run ends with, or null
+function sandboxVerdict(stdout) {
+  const last = (stdout || '').trimEnd().split('\n').pop();
+  try {
+    return JSON.parse(last).sandbox || null;
+  } catch (error) {
+    return null;
+  }
+}
+
+/**
+ * Runs one compiled individual on a batch. Resolves to { runs, metrics,
+ * sandbox }: runs { instance, numCustomers, seed, objective, iterations,
+ * elapsedMs, truncated }, the phase totals of the profiler (Metrics.h) and
+ * the sandbox verdict (null without the sandbox). Rejects with the process
+ * error, or with an error carrying .sandbox when the sandbox stopped the
+ * heuristic.
+ */
+async function runProfiler(binary, individual, batch, options) {
+  const args = [
+    `--type=${individual.type}`,
+    ...batch.args,
+    `--budget-ms=${options.budgetMs}`,
+    `--max-iterations=${batch.iterations}`,
+    `--instance-seed=${options.instanceSeed}`
+  ];
+  // The per-run cap plus an allowance for instance construction: a spinning operator call exhausts the
+  // CPU limit, a blocked one the watchdog; the exec timeout only backs up the sandbox
+  const capMs = batch.numRuns * options.budgetMs * 1.5 + 30000;
+  if (options.sandbox) {
+    args.push('--sandbox', `--wall-ms=${capMs}`, `--cpu-seconds=${Math.ceil(capMs / 1000) - 10}`, `--memory-mb=${options.memoryMb}`);
+  }
+  const execOptions = { timeout: options.sandbox ? capMs + 30000 : capMs, killSignal: 'SIGKILL', maxBuffer: 256 * 1024 * 1024 };
+  let stdout;
+  try {
+    ({ stdout } = binary.endsWith('.so')
+      ? await execFileAsync(pluginHostPath('profile'), args, { ...execOptions, env: { ...process.env, [PLUGIN_ENV]: binary } })
+      : await execFileAsync(binary, args, execOptions));
+  } catch (error) {
+    const sandbox = !error.killed && sandboxVerdict(error.stdout);
+    if (!sandbox || sandbox.status === 'ok') {
+      throw error;
+    }
+    throw Object.assign(new Error(sandbox.detail), { sandbox, stderr: error.stderr });
+  }
+  const lines = stdout.split('\n').filter(Boolean).map(line => JSON.parse(line));
+  const metricsLine = lines.find(line => line.metrics);
+  const sandboxLine = lines.find(line => line.sandbox);
+  const runs = lines.filter(line => line.objectives).map(run => ({
+    instance: run.instance,
+    numCustomers: run.numCustomers,
+    seed: run.seed,
+    objective: run.objectives.length ? run.objectives[run.objectives.length - 1] : null,
+    iterations: run.iterations,
+    elapsedMs: run.elapsedMs,
+    truncated: run.iterations < batch.iterations
+  }));
+  return { runs, metrics: metricsLine ? metricsLine.metrics : null, sandbox: sandboxLine ? sandboxLine.sandbox : null };
+}
+
+const validObjective = run => run.objective !== null && Number.isFinite(run.objective);
+
+function failureOf(error) {
+  if (error.sandbox) {
+    const cause = firstLine(error.stderr || '');
+    return { status: error.sandbox.status, error: cause ? `${error.sandbox.detail}: ${cause}` : error.sandbox.detail, sandbox: error.sandbox };
+  }
+  if (error.killed) {
+    return { status: 'timeout', error: 'killed after exceeding the evaluation time cap' };
+  }
+  if (error.signal) {
+    return { status: 'crashed', error: `terminated by ${error.signal}${error.stderr ? `: ${firstLine(error.stderr)}` : ''}` };
+  }
+  return { status: 'failed', error: firstLine(error.stderr || error.message) };
+}
+
+function fitnessRecord(individual, key, options, outcome) {
+  return {
+    name: individual.name,
+    type: individual.type,
+    fitness: outcome.fitness === undefined ? null : outcome.fitness,
+    status: outcome.status,
+    error: outcome.error,
+    evaluationKey: key,
+    settings: evaluationSettings(options),
+    race: outcome.race,
+    sandbox: outcome.sandbox,
+    metrics: outcome.metrics,
+    evaluatedAt: new Date().toISOString(),
+    evaluationMs: outcome.evaluationMs,
+    runs: outcome.runs
+  };
+}
+
+async function evaluateIndividual(individual, binary, key, options) {
+  const start = Date.now();
+  try {
+    const { runs, metrics, sandbox } = await runProfiler(binary, individual, fullBatch(options), options);
+    if (!runs.length || !runs.every(validObjective)) {
+      return fitnessRecord(individual, key, options, {
+        status: 'invalid',
+        error: 'missing or non-finite objective',
+        runs,
+        metrics,
+        sandbox,
+        evaluationMs: Date.now() - start
+      });
+    }
+    const fitness = runs.reduce((sum, run) => sum + run.objective, 0) / runs.length;
+    return fitnessRecord(individual, key, options, {
+      fitness,
+      status: runs.some(run => run.truncated) ? 'truncated' : 'ok',
+      runs,
+      metrics,
+      sandbox,
+      evaluationMs: Date.now() - start
+    });
+  } catch (error) {
+    return fitnessRecord(individual, key, options, { ...failureOf(error), runs: [], evaluationMs: Date.now() - start });
+  }
+}
+
+// Single-threaded solver time of a record's runs
+const solverMs = record => (record.runs || []).reduce((sum, run) => sum + run.elapsedMs, 0);
+
+// Ranks within one block, 1 = lowest objective; ties share their mean rank
+function blockRanks(values) {
+  const order = values.map((value, j) => j).sort((a, b) => values[a] - values[b]);
+  const ranks = new Array(values.length);
+  for (let i = 0; i < order.length;) {
+    let k = i;
+    while (k + 1 < order.length && values[order[k + 1]] === values[order[i]]) k++;
+    for (let t = i; t <= k; t++) ranks[order[t]] = (i + k) / 2 + 1;
+    i = k + 1;
+  }
+  return ranks;
+}
+
+// Upper standard normal quantile, p >= 0.5 (Abramowitz & Stegun 26.2.23, error < 4.5e-4)
+function normalQuantile(p) {
+  const t = Math.sqrt(-2 * Math.log(1 - p));
+  return t - (2.515517 + 0.802853 * t + 0.010328 * t * t) / (1 + 1.432788 * t + 0.189269 * t * t + 0.001308 * t * t * t);
+}
+
+// Wilson-Hilferty approximation
+function chiSquareQuantile(p, df) {
+  const z = normalQuantile(p);
+  return df * (1 - 2 / (9 * df) + z * Math.sqrt(2 / (9 * df))) ** 3;
+}
+
+// Cornish-Fisher expansion around the normal quantile
+function tQuantile(p, df) {
+  const z = normalQuantile(p);
+  return z + (z ** 3 + z) / (4 * df) + (5 * z ** 5 + 16 * z ** 3 + 3 * z) / (96 * df * df);
+}
+
+/**
+ * Friedman test over a blocks x candidates matrix of objectives (lower is
+ * better) with the post-hoc comparison of F-race. Returns the candidates
+ * significantly worse than the best one, worst first, with the rank sums;
+ * none when the test finds no difference at level alpha.
+ */
+function friedmanDominated(matrix, alpha) {
+  const n = matrix.length;
+  const m = matrix[0].length;
+  const rankSums = new Array(m).fill(0);
+  let sumSquares = 0;
+  for (const row of matrix) {
+    blockRanks(row).forEach((rank, j) => {
+      rankSums[j] += rank;
+      sumSquares += rank * rank;
+    });
+  }
+  const spread = sumSquares - n * m * (m + 1) ** 2 / 4;
+  if (n < 2 || m < 2 || spread <= 0) {
+    return { dominated: [], rankSums };
+  }
+  const statistic = (m - 1) * rankSums.reduce((sum, r) => sum + (r - n * (m + 1) / 2) ** 2, 0) / spread;
+  if (statistic <= chiSquareQuantile(1 - alpha, m - 1)) {
+    return { dominated: [], rankSums };
+  }
+  const best = Math.min(...rankSums);
+  const threshold = tQuantile(1 - alpha / 2, (n - 1) * (m - 1)) *
+    Math.sqrt(2 * n * Math.max(0, 1 - statistic / (n * (m - 1))) * spread / ((n - 1) * (m - 1)));
+  const dominated = rankSums.map((r, j) => j).filter(j => rankSums[j] - best > threshold);
+  return { dominated: dominated.sort((a, b) => rankSums[b] - rankSums[a]), rankSums };
+}
+
+/**
+ * Races the compiled candidates ({ index, binary }) block by block with
+ * a reduced iteration budget. Resolves to the surviving indices and, per
+ * dropped index, its outcome { status, error, runs, race }, and the
+ * solver time spent on all race runs.
+ */
+async function raceCandidates(individuals, candidates, options) {
+  const iterations = Math.max(1, Math.round(options.iterations * options.raceBudget));
+  const blocks = raceBlocks(options, iterations);
+  const runs = new Map(candidates.map(candidate => [candidate.index, []]));
+  const dropped = new Map();
+  let alive = candidates;
+
+  for (let b = 0; b < blocks.length && alive.length > options.raceKeep; b++) {
+    const results = await runPool(alive, options.jobs, async candidate => {
+      try {
+        const { runs: [run] } = await runProfiler(candidate.binary, individuals[candidate.index], blocks[b], options);
+        return run && validObjective(run) ? run : { failure: { status: 'invalid', error: 'missing or non-finite objective' } };
+      } catch (error) {
+        return { failure: failureOf(error) };
+      }
+    });
+    const next = [];
+    alive.forEach((candidate, k) => {
+      if (results[k].failure) {
+        dropped.set(candidate.index, { ...results[k].failure, runs: runs.get(candidate.index), race: { iterations, blocks: b + 1 } });
+      } else {
+        runs.get(candidate.index).push(results[k]);
+        next.push(candidate);
+      }
+    });
+    alive = next;
+
+    if (b + 1 >= options.raceMinBlocks && alive.length > options.raceKeep) {
+      const matrix = Array.from({ length: b + 1 }, (_, row) => alive.map(candidate => runs.get(candidate.index)[row].objective));
+      const { dominated, rankSums } = friedmanDominated(matrix, options.raceAlpha);
+      const discarded = new Set(dominated.slice(0, alive.length - options.raceKeep));
+      for (const j of discarded) {
+        const meanRank = rankSums[j] / (b + 1);
+        dropped.set(alive[j].index, {
+          status: 'eliminated',
+          error: `dominated after ${b + 1} race blocks (mean rank ${meanRank.toFixed(2)} of ${alive.length})`,
+          runs: runs.get(alive[j].index),
+          race: { iterations, blocks: b + 1, meanRank, candidates: alive.length }
+        });
+      }
+      alive = alive.filter((_, j) => !discarded.has(j));
+    }
+    log(`Race block ${b + 1}/${blocks.length}: ${alive.length} candidates left`, 'blue');
+  }
+  let raceMs = 0;
+  for (const candidateRuns of runs.values()) {
+    raceMs += solverMs({ runs: candidateRuns });
+  }
+  return { survivors: alive.map(candidate => candidate.index), dropped, solverMs: raceMs };
+}
+
+const populationKey = individual => `${individual.type}-${individual.population}`;
+
+async function runEvaluation() {
+  const options = parseArgs(process.argv.slice(2));
+  const individuals = listIndividuals(options);
+  const started = Date.now();
+  log(`\nEvaluating ${individuals.length} individuals on ${options.families} x ${options.sizes}` +
+      (options.instances.length ? ` and ${options.instances.length} instance files` : '') +
+      `, ${options.seeds.length} seeds x ${options.iterations} iterations, ${options.jobs} jobs` +
+      (options.race ? `, raced at ${options.raceBudget} x iterations` : ''), 'bold');
+
+  const keys = individuals.map(individual => evaluationKey(individual, options));
+  const raceKeys = individuals.map(individual => evaluationKey(individual, options, true));
+  // Latest stored row per individual, from one store per population directory
+  const stored = new Map();
+  for (const dir of new Set(individuals.map(populationDir))) {
+    stored.set(dir, latestRows(loadStore(storePath(dir)), ['name', 'status', 'fitness', 'evaluationKey']));
+  }
+  const records = individuals.map((individual, i) => {
+    const previous = options.force ? null : stored.get(populationDir(individual)).get(individual.name);
+    const upToDate = previous && (previous.evaluationKey === keys[i] || (options.race && previous.evaluationKey === raceKeys[i]));
+    return upToDate ? previous : null;
+  });
+  const pending = individuals.map((_, i) => i).filter(i => !records[i]);
+  if (pending.length < individuals.length) {
+    log(`${individuals.length - pending.length} individuals are up to date`, 'blue');
+  }
+
+  // Stage 1: compile. Evaluations wait for it so that compilers do not steal time from running solvers
+  const plugins = usePlugins();
+  if (plugins && pending.length) {
+    await compilePluginHost('profile');
+  }
+  const binaries = await runPool(pending, options.jobs, async i => {
+    try {
+      return await compileHeuristic(individuals[i], plugins ? 'plugin' : 'profile');
+    } catch (error) {
+      records[i] = fitnessRecord(individuals[i], keys[i], options, {
+        status: 'compile_error',
+        error: (String(error.stderr || '').split('\n').find(line => line.includes('error:')) || firstLine(error.message)).trim(),
+        runs: [],
+        evaluationMs: 0
+      });
+      log(`✗ ${individuals[i].name}: does not compile`, 'red');
+      return null;
+    }
+  });
+  const binaryOf = new Map(pending.map((i, k) => [i, binaries[k]]));
+  let runnable = pending.filter(i => binaryOf.get(i));
+  const compiled = Date.now();
+
+  // Stage 2: race each population, so that only candidates of one type are ranked against each other
+  let raceSolverMs = 0;
+  if (options.race) {
+    const survivors = [];
+    for (const key of [...new Set(runnable.map(i => populationKey(individuals[i])))]) {
+      const group = runnable.filter(i => populationKey(individuals[i]) === key);
+      log(`\nRacing ${group.length} individuals of ${key}`, 'bold');
+      const race = await raceCandidates(individuals, group.map(i => ({ index: i, binary: binaryOf.get(i) })), options);
+      survivors.push(...race.survivors);
+      for (const [i, outcome] of race.dropped) {
+        records[i] = fitnessRecord(individuals[i], raceKeys[i], options, { ...outcome, evaluationMs: 0 });
+      }
+      raceSolverMs += race.solverMs;
+    }
+    log(`${survivors.length} of ${runnable.length} individuals survived the race\n`, 'bold');
+    runnable = survivors;
+  }
+  const raced = Date.now();
+
+  // Stage 3: full evaluation, one single-threaded solver process per job
+  const writers = new Map();
+  const writeRecord = (individual, record) => {
+    const dir = populationDir(individual);
+    if (!writers.has(dir)) {
+      writers.set(dir, new StoreWriter(storePath(dir), { settings: evaluationSettings(options) }));
+    }
+    writers.get(dir).add(record);
+  };
+  let done = 0;
+  await runPool(runnable, options.jobs, async i => {
+    const record = await evaluateIndividual(individuals[i], binaryOf.get(i), keys[i], options);
+    records[i] = record;
+    writeRecord(individuals[i], record);
+    done++;
+    const label = `[${done}/${runnable.length}] ${individuals[i].name}`;
+    if (record.fitness === null) {
+      log(`✗ ${label}: ${record.status}, ${record.error}`, 'red');
+    } else {
+      log(`✓ ${label}: ${record.fitness.toFixed(4)}${record.status === 'truncated' ? ' (truncated)' : ''}`,
+        record.status === 'ok' ? 'green' : 'yellow');
+    }
+  });
+  const evaluated = new Set(runnable);
+  for (const i of pending.filter(i => !evaluated.has(i))) {
+    writeRecord(individuals[i], records[i]);
+  }
+  for (const writer of writers.values()) {
+    writer.flush();
+  }
+
+  // Rankings per population
+  fs.mkdirSync(options.outDir, { recursive: true });
+  const populations = new Map();
+  individuals.forEach((individual, i) => {
+    const key = populationKey(individual);
+    if (!populations.has(key)) populations.set(key, []);
+    populations.get(key).push({ name: individual.name, fitness: records[i].fitness, status: records[i].status });
+  });
+  console.log('\n' + '='.repeat(70));
+  log('Generation Summary (fitness = mean final objective, lower is better)', 'bold');
+  console.log('='.repeat(70));
+  for (const [key, ranking] of populations) {
+    ranking.sort((a, b) => (a.fitness === null) - (b.fitness === null) || a.fitness - b.fitness);
+    fs.writeFileSync(path.join(options.outDir, `${key}.json`), JSON.stringify({
+      date: new Date().toISOString(),
+      settings: evaluationSettings(options),
+      race: options.race ? raceSettings(options) : null,
+      individuals: ranking
+    }, null, 2));
+    const eliminated = ranking.filter(entry => entry.status === 'eliminated').length;
+    const failed = ranking.filter(entry => entry.fitness === null).length - eliminated;
+    console.log(`${key.padEnd(40)} best ${ranking[0].fitness === null ? '-' : `${ranking[0].name} ${ranking[0].fitness.toFixed(4)}`}` +
+      (eliminated ? `, ${eliminated} eliminated` : '') + (failed ? `, ${failed} failed` : ''));
+  }
+  console.log('='.repeat(70));
+  const totalSolverMs = runnable.reduce((sum, i) => sum + solverMs(records[i]), 0) + raceSolverMs;
+  log(`Compiled in ${((compiled - started) / 1000).toFixed(1)}s` +
+      (options.race ? `, raced in ${((raced - compiled) / 1000).toFixed(1)}s` : '') +
+      `, evaluated in ${((Date.now() - raced) / 1000).toFixed(1)}s; solver time ${(totalSolverMs / 1000).toFixed(1)}s`, 'blue');
+  log(`Rankings written to ${path.relative(process.cwd(), options.outDir)}`, 'blue');
+}
+
+if (require.main === module) {
+  runEvaluation().catch(error => {
+    console.error('Evaluation error:', error);
+    process.exit(1);
+  });
+}
+
+module.exports = { parseArgs, listIndividuals, evaluationKey, runPool, evaluateIndividual, friedmanDominated };
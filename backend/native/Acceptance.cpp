@@ -0,0 +1,131 @@
+#include "Acceptance.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// exp(-x) sampled every 1/256 on [0, 16); beyond that the probability is below 1.2e-7 and counts as 0
+constexpr int kExpSteps = 256;
+constexpr int kExpTableSize = 16 * kExpSteps;
+// The SA temperature steps down every 1/kCoolingSteps of the run, by 0.4% with the default temperatures
+constexpr int kCoolingSteps = 1024;
+
+const std::array<float, kExpTableSize>& expTable() {
+    static const std::array<float, kExpTableSize> table = [] {
+        std::array<float, kExpTableSize> values{};
+        for (int i = 0; i < kExpTableSize; ++i) {
+            values[static_cast<size_t>(i)] = static_cast<float>(std::exp(-(i + 0.5) / kExpSteps));
+        }
+        return values;
+    }();
+    return table;
+}
+
+}
+
+AcceptanceKind parseAcceptanceKind(const std::string& name) {
+    if (name == "greedy") {
+        return AcceptanceKind::Greedy;
+    }
+    if (name == "sa") {
+        return AcceptanceKind::SimulatedAnnealing;
+    }
+    if (name == "rrt") {
+        return AcceptanceKind::RecordToRecord;
+    }
+    if (name == "lahc") {
+        return AcceptanceKind::LateAcceptance;
+    }
+    throw std::runtime_error("unknown acceptance " + name);
+}
+
+const char* acceptanceKindName(AcceptanceKind kind) {
+    switch (kind) {
+    case AcceptanceKind::Greedy:
+        return "greedy";
+    case AcceptanceKind::SimulatedAnnealing:
+        return "sa";
+    case AcceptanceKind::RecordToRecord:
+        return "rrt";
+    case AcceptanceKind::LateAcceptance:
+        return "lahc";
+    }
+    return "greedy";
+}
+
+uint32_t acceptanceSeed(uint32_t seed, uint32_t stream) {
+    // splitmix64 finalizer over the seed, offset by the golden ratio, and the stream index
+    uint64_t z = (static_cast<uint64_t>(seed ^ 0x9E3779B9u) << 32 | stream) + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+}
+
+Acceptance::Acceptance(const AcceptanceConfig& config, uint32_t seed) : config_(config), rng_(seed) {
+    expTable();
+}
+
+void Acceptance::start(float objective, int numCustomers) {
+    scale_ = std::max(std::fabs(objective) / static_cast<float>(std::max(1, numCustomers)), 1e-6f);
+    record_ = objective;
+    decisions_ = 0;
+    if (config_.kind == AcceptanceKind::LateAcceptance) {
+        history_.assign(static_cast<size_t>(std::max(1, config_.lateAcceptanceLength)), objective);
+    }
+    if (config_.kind == AcceptanceKind::SimulatedAnnealing) {
+        // Once per run, so that setProgress on every iteration is a lookup
+        inverseTemperatures_.resize(kCoolingSteps + 1);
+        double ratio = config_.endTemperature / config_.startTemperature;
+        for (int step = 0; step <= kCoolingSteps; ++step) {
+            double temperature = config_.startTemperature * std::pow(ratio, static_cast<double>(step) / kCoolingSteps);
+            inverseTemperatures_[static_cast<size_t>(step)] = static_cast<float>(1 / (temperature * scale_));
+        }
+    }
+    setProgress(0);
+}
+
+void Acceptance::setProgress(double progress) {
+    progress = std::min(1.0, std::max(0.0, progress));
+    if (config_.kind == AcceptanceKind::SimulatedAnnealing) {
+        inverseTemperature_ = inverseTemperatures_[static_cast<size_t>(progress * kCoolingSteps)];
+    } else if (config_.kind == AcceptanceKind::RecordToRecord) {
+        deviation_ = static_cast<float>(config_.startDeviation +
+                                        (config_.endDeviation - config_.startDeviation) * progress);
+    }
+}
+
+float Acceptance::acceptanceProbability(float delta) const {
+    float x = delta * inverseTemperature_ * kExpSteps;
+    return x < kExpTableSize ? expTable()[static_cast<size_t>(x)] : 0.0f;
+}
+
+bool Acceptance::accept(float current, float delta) {
+    float candidate = current + delta;
+    bool accepted = delta <= 0;
+    switch (config_.kind) {
+    case AcceptanceKind::Greedy:
+        break;
+    case AcceptanceKind::SimulatedAnnealing:
+        if (!accepted) {
+            accepted = static_cast<float>(rng_() >> 8) * (1.0f / 16777216.0f) < acceptanceProbability(delta);
+        }
+        break;
+    case AcceptanceKind::RecordToRecord:
+        accepted = accepted || candidate <= record_ + deviation_ * std::fabs(record_);
+        break;
+    case AcceptanceKind::LateAcceptance: {
+        float& late = history_[static_cast<size_t>(decisions_ % history_.size())];
+        accepted = accepted || candidate <= late;
+        late = accepted ? candidate : current;
+        break;
+    }
+    }
+    ++decisions_;
+    if (accepted) {
+        record_ = std::min(record_, candidate);
+    }
+    return accepted;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// Acceptance criteria of the LNS loops (LNSConfig::acceptance). They only see objective values and the delta
+// of a candidate, both of which the mutation primitives keep up to date while the candidate is built
+// (Solution::objective), so deciding never re-sums the tours.
+//   greedy  keep candidates that are not worse than the current solution
+//   sa      simulated annealing: also keep a worse candidate with probability exp(-delta / T); T cools
+//           exponentially from startTemperature to endTemperature over the run, in 1024 steps
+//   rrt     record-to-record travel: keep candidates within a deviation above the best objective accepted
+//           so far; the deviation shrinks linearly from startDeviation to endDeviation
+//   lahc    late acceptance hill climbing: keep candidates not worse than the current solution was
+//           lateAcceptanceLength decisions ago
+// Temperatures are in units of the initial objective per customer and deviations relative to the best
+// objective, so one setting fits every instance size.
+enum class AcceptanceKind { Greedy, SimulatedAnnealing, RecordToRecord, LateAcceptance };
+
+AcceptanceKind parseAcceptanceKind(const std::string& name); // "greedy", "sa", "rrt" or "lahc"; throws otherwise
+const char* acceptanceKindName(AcceptanceKind kind);
+
+struct AcceptanceConfig {
+    AcceptanceKind kind = AcceptanceKind::Greedy;
+    double startTemperature = 0.1;
+    double endTemperature = 0.002;
+    double startDeviation = 0.003;
+    double endDeviation = 0;
+    int lateAcceptanceLength = 100;
+};
+
+// Seed of the acceptance stream of thread or island `stream` in a run seeded with seed (LNSConfig::seed). Hashed,
+// so it is very unlikely to equal a seed the operators' generators get (seedRandomGenerators(seed + i)) and the
+// criterion's draws do not replay the destroy and repair stream.
+uint32_t acceptanceSeed(uint32_t seed, uint32_t stream = 0);
+
+// Per-thread state of one criterion: its random stream, the current temperature or deviation and the
+// late acceptance history.
+class Acceptance {
+public:
+    Acceptance(const AcceptanceConfig& config, uint32_t seed);
+
+    // Starts a run from a solution of the given objective
+    void start(float objective, int numCustomers);
+    // Fraction of the run that is spent, in [0, 1]: of the time budget or the iteration limit, whichever is
+    // further along. Only after start.
+    void setProgress(double progress);
+    // Decides on a candidate of objective current + delta and records the decision
+    bool accept(float current, float delta);
+
+private:
+    float acceptanceProbability(float delta) const;
+
+    AcceptanceConfig config_;
+    std::mt19937 rng_;
+    float scale_ = 1; // Initial objective per customer
+    float inverseTemperature_ = 0;
+    std::vector<float> inverseTemperatures_; // SA: 1 / T at every cooling step of the run, from start()
+    float deviation_ = 0;
+    float record_ = 0; // Best objective accepted so far
+    std::vector<float> history_;
+    uint64_t decisions_ = 0;
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+
+#include "Instance.h"
+#include "Metrics.h"
+#include "Solution.h"
+#include "Utils.h"
+
+// The two operators every generated heuristic provides.
+// select_by_llm_1 picks the customers to remove from sol, sort_by_llm_1 orders them for reinsertion.
+// Operators may count their own events (e.g. rejected candidates) with an OperatorCounter from Metrics.h.
+std::vector<int> select_by_llm_1(const Solution& sol);
+void sort_by_llm_1(std::vector<int>& customers, const Instance& instance);
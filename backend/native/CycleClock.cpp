@@ -0,0 +1,29 @@
+#include "CycleClock.h"
+
+#include <chrono>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Reference point for converting cycles to time; the longer the process runs, the more precise the ratio
+const uint64_t startCycles = readCycleCounter();
+const Clock::time_point startTime = Clock::now();
+
+double elapsedNs(Clock::time_point since) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - since).count();
+}
+
+}
+
+double cyclesPerNs() {
+    double ns = elapsedNs(startTime);
+    if (ns < 1e7) {
+        uint64_t cycles = readCycleCounter();
+        Clock::time_point time = Clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return static_cast<double>(readCycleCounter() - cycles) / elapsedNs(time);
+    }
+    return static_cast<double>(readCycleCounter() - startCycles) / ns;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Time stamp counter where available (a few ns to read), steady_clock nanoseconds elsewhere.
+inline uint64_t readCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// Cycle counter ticks per nanosecond, measured against steady_clock since process start
+// (over a 10 ms sleep when called right after startup).
+double cyclesPerNs();
@@ -0,0 +1,365 @@
+#include "Decomposition.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <thread>
+
+#include "TaskScheduler.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kGoldenAngle = 2.399963229728653; // pi * (3 - sqrt(5))
+constexpr double kTwoPi = 6.283185307179586;
+
+// Same float arithmetic as Instance::finalize, so subproblem matrices agree with the checks below
+float nodeDistance(const Instance& instance, int a, int b) {
+    float dx = instance.nodePositions[a][0] - instance.nodePositions[b][0];
+    float dy = instance.nodePositions[a][1] - instance.nodePositions[b][1];
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+double travelDistance(const Instance& instance, const std::vector<std::vector<int>>& tours) {
+    double distance = 0;
+    for (const std::vector<int>& tour : tours) {
+        int prev = 0;
+        for (int c : tour) {
+            distance += nodeDistance(instance, prev, c);
+            prev = c;
+        }
+        distance += nodeDistance(instance, prev, 0);
+    }
+    return distance;
+}
+
+// A route of the current solution at its barycenter, or a single customer at its position
+struct Unit {
+    double x = 0; // Rotated around the depot by the round's angle
+    double y = 0;
+    int weight = 1; // Customers
+    int tour = -1; // Index into the current tours, or -1
+    int customer = 0; // Customer of a single-customer unit
+};
+
+struct Subproblem {
+    std::vector<int> customers; // Instance ids; customers[i] is node i + 1 of the subproblem
+    std::vector<std::vector<int>> tours; // Warm start going in, solution coming out; instance ids
+    uint64_t iterations = 0;
+    bool improved = false;
+};
+
+void collectUnits(const Instance& instance, const std::vector<std::vector<int>>& tours, int round,
+                  std::vector<Unit>& units) {
+    double angle = round * kGoldenAngle;
+    double cosA = std::cos(angle);
+    double sinA = std::sin(angle);
+    double depotX = instance.nodePositions[0][0];
+    double depotY = instance.nodePositions[0][1];
+    auto add = [&](double x, double y, int weight, int tour, int customer) {
+        x -= depotX;
+        y -= depotY;
+        units.push_back({cosA * x - sinA * y, sinA * x + cosA * y, weight, tour, customer});
+    };
+
+    units.clear();
+    std::vector<char> served(static_cast<size_t>(instance.numNodes), 0);
+    for (size_t t = 0; t < tours.size(); ++t) {
+        double x = 0;
+        double y = 0;
+        for (int c : tours[t]) {
+            x += instance.nodePositions[c][0];
+            y += instance.nodePositions[c][1];
+            served[c] = 1;
+        }
+        double n = static_cast<double>(tours[t].size());
+        add(x / n, y / n, static_cast<int>(tours[t].size()), static_cast<int>(t), 0);
+    }
+    // Every customer in the first round; later the ones a PCVRP solution leaves unserved
+    for (int c = 1; c <= instance.numCustomers; ++c) {
+        if (!served[c]) {
+            add(instance.nodePositions[c][0], instance.nodePositions[c][1], 1, -1, c);
+        }
+    }
+}
+
+// Ties broken by the unit's identity, so the partition does not depend on the sort implementation
+bool unitBefore(const Unit& a, const Unit& b, double keyA, double keyB) {
+    if (keyA != keyB) {
+        return keyA < keyB;
+    }
+    return a.tour != b.tour ? a.tour < b.tour : a.customer < b.customer;
+}
+
+void partitionSectors(std::vector<Unit>& units, int size, std::vector<std::vector<int>>& groups) {
+    auto angleOf = [](const Unit& unit) {
+        double angle = std::atan2(unit.y, unit.x);
+        return angle < 0 ? angle + kTwoPi : angle;
+    };
+    std::sort(units.begin(), units.end(),
+              [&](const Unit& a, const Unit& b) { return unitBefore(a, b, angleOf(a), angleOf(b)); });
+
+    long long total = 0;
+    for (const Unit& unit : units) {
+        total += unit.weight;
+    }
+    long long numGroups = std::max(1LL, (total + size - 1) / size);
+    long long cumulative = 0;
+    groups.assign(1, {});
+    for (int i = 0; i < static_cast<int>(units.size()); ++i) {
+        // Cut once the group reaches its share of the customers, measured at the unit's midpoint
+        long long group = std::min(numGroups - 1, (cumulative * 2 + units[i].weight) * numGroups / (total * 2));
+        if (group >= static_cast<long long>(groups.size())) {
+            groups.emplace_back();
+        }
+        groups.back().push_back(i);
+        cumulative += units[i].weight;
+    }
+}
+
+void bisect(std::vector<Unit>& units, int begin, int end, bool alongX, int size, std::vector<std::vector<int>>& groups) {
+    long long total = 0;
+    for (int i = begin; i < end; ++i) {
+        total += units[i].weight;
+    }
+    if (total <= size || end - begin == 1) {
+        groups.emplace_back(static_cast<size_t>(end - begin));
+        std::iota(groups.back().begin(), groups.back().end(), begin);
+        return;
+    }
+    std::sort(units.begin() + begin, units.begin() + end, [alongX](const Unit& a, const Unit& b) {
+        return alongX ? unitBefore(a, b, a.x, b.x) : unitBefore(a, b, a.y, b.y);
+    });
+    int middle = begin + 1;
+    long long half = units[begin].weight;
+    while (middle < end - 1 && (half + units[middle].weight) * 2 <= total) {
+        half += units[middle].weight;
+        ++middle;
+    }
+    bisect(units, begin, middle, !alongX, size, groups);
+    bisect(units, middle, end, !alongX, size, groups);
+}
+
+// Travel distance of the subproblem's tours plus, for PCVRP, the prizes of its customers they leave out
+double subproblemObjective(const Instance& instance, const Subproblem& sub, const std::vector<std::vector<int>>& tours,
+                           std::vector<char>& served) {
+    double objective = travelDistance(instance, tours);
+    if (instance.type == ProblemType::PCVRP) {
+        for (const std::vector<int>& tour : tours) {
+            for (int c : tour) {
+                served[c] = 1;
+            }
+        }
+        for (int c : sub.customers) {
+            if (!served[c]) {
+                objective += instance.prizes[c];
+            }
+            served[c] = 0;
+        }
+    }
+    return objective;
+}
+
+void solveSubproblem(const Instance& instance, const DecompositionConfig& config, Subproblem& sub, bool warm,
+                     uint32_t seed, double budgetMs) {
+    Instance local;
+    local.type = instance.type;
+    local.vehicleCapacity = instance.vehicleCapacity;
+    std::vector<int> nodes(1, 0);
+    nodes.insert(nodes.end(), sub.customers.begin(), sub.customers.end());
+    for (int node : nodes) {
+        local.nodePositions.push_back(instance.nodePositions[node]);
+        local.demand.push_back(instance.demand[node]);
+        if (instance.type == ProblemType::VRPTW) {
+            local.startTW.push_back(instance.startTW[node]);
+            local.endTW.push_back(instance.endTW[node]);
+            local.serviceTime.push_back(instance.serviceTime[node]);
+        }
+        if (instance.type == ProblemType::PCVRP) {
+            local.prizes.push_back(instance.prizes[node]);
+        }
+    }
+    local.finalize();
+
+    thread_local std::vector<int> localId;
+    thread_local std::vector<char> served;
+    localId.resize(static_cast<size_t>(instance.numNodes));
+    served.resize(static_cast<size_t>(instance.numNodes), 0);
+    for (size_t i = 0; i < sub.customers.size(); ++i) {
+        localId[sub.customers[i]] = static_cast<int>(i + 1);
+    }
+
+    LNSConfig lns;
+    lns.timeBudgetMs = budgetMs;
+    lns.maxIterations = config.subproblemIterations;
+    lns.seed = seed;
+    lns.cancelled = config.lns.cancelled;
+    lns.operators = config.lns.operators;
+    lns.localSearch = config.lns.localSearch;
+    lns.acceptance = config.lns.acceptance;
+    for (const std::vector<int>& tour : sub.tours) {
+        lns.initialTours.emplace_back();
+        for (int c : tour) {
+            lns.initialTours.back().push_back(localId[c]);
+        }
+    }
+    LNSResult result = runLNS(local, lns);
+    sub.iterations = result.iterations;
+
+    std::vector<std::vector<int>> tours;
+    for (const Tour& tour : result.best.tours) {
+        if (tour.customers.empty()) {
+            continue;
+        }
+        tours.emplace_back();
+        for (int c : tour.customers) {
+            tours.back().push_back(nodes[c]);
+        }
+    }
+    // The float objective of the subproblem may round a tie either way; compare in double
+    sub.improved = !warm || subproblemObjective(instance, sub, tours, served) <
+                                subproblemObjective(instance, sub, sub.tours, served);
+    if (sub.improved) {
+        sub.tours = std::move(tours);
+    }
+}
+
+}
+
+DecompositionResult runDecomposedLNS(const Instance& instance, const DecompositionConfig& config) {
+    Clock::time_point start = Clock::now();
+    auto elapsedMs = [start] { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); };
+    DecompositionResult result;
+    if (instance.numCustomers == 0) {
+        return result;
+    }
+
+    int numThreads = config.numThreads > 0 ? config.numThreads
+                                           : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    TaskScheduler scheduler(numThreads);
+    int size = std::max(2, config.subproblemSize);
+    std::vector<Unit> units;
+    std::vector<std::vector<int>> groups;
+    std::vector<Subproblem> subproblems;
+
+    for (int round = 0;; ++round) {
+        if (round > 0) {
+            if (config.lns.cancelled && config.lns.cancelled->load(std::memory_order_relaxed)) {
+                result.cancelled = true;
+                break;
+            }
+            if (config.rounds > 0 ? round >= config.rounds : elapsedMs() >= config.lns.timeBudgetMs) {
+                break;
+            }
+        }
+
+        collectUnits(instance, result.tours, round, units);
+        groups.clear();
+        if (config.method == PartitionMethod::Sector) {
+            partitionSectors(units, size, groups);
+        } else {
+            bisect(units, 0, static_cast<int>(units.size()), round % 2 == 0, size, groups);
+        }
+        subproblems.assign(groups.size(), {});
+        for (size_t g = 0; g < groups.size(); ++g) {
+            Subproblem& sub = subproblems[g];
+            for (int u : groups[g]) {
+                const Unit& unit = units[u];
+                if (unit.tour < 0) {
+                    sub.customers.push_back(unit.customer);
+                    continue;
+                }
+                sub.customers.insert(sub.customers.end(), result.tours[unit.tour].begin(), result.tours[unit.tour].end());
+                sub.tours.push_back(std::move(result.tours[unit.tour]));
+            }
+        }
+
+        // Every subproblem of the round gets the same budget, as long as the waves of them fit what is left
+        double waves = std::ceil(static_cast<double>(subproblems.size()) / numThreads);
+        double remainingMs = std::max(0.0, config.lns.timeBudgetMs - elapsedMs());
+        double budgetMs = std::min(config.subproblemBudgetMs, remainingMs / waves);
+        bool warm = round > 0;
+        scheduler.parallelFor(subproblems.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t g = begin; g < end; ++g) {
+                uint32_t seed = config.lns.seed + static_cast<uint32_t>(round) * 65536u + static_cast<uint32_t>(g);
+                solveSubproblem(instance, config, subproblems[g], warm, seed, budgetMs);
+            }
+        });
+
+        DecompositionRound stats;
+        stats.subproblems = static_cast<int>(subproblems.size());
+        result.tours.clear();
+        for (Subproblem& sub : subproblems) {
+            stats.improved += sub.improved ? 1 : 0;
+            stats.iterations += sub.iterations;
+            for (std::vector<int>& tour : sub.tours) {
+                result.tours.push_back(std::move(tour));
+            }
+        }
+        stats.objective = toursObjective(instance, result.tours);
+        stats.elapsedMs = elapsedMs();
+        result.iterations += stats.iterations;
+        result.rounds.push_back(stats);
+    }
+
+    result.objective = result.rounds.back().objective;
+    result.elapsedMs = elapsedMs();
+    return result;
+}
+
+double toursObjective(const Instance& instance, const std::vector<std::vector<int>>& tours) {
+    double objective = travelDistance(instance, tours);
+    if (instance.type == ProblemType::PCVRP) {
+        double uncollected = 0;
+        for (int c = 1; c <= instance.numCustomers; ++c) {
+            uncollected += instance.prizes[c];
+        }
+        for (const std::vector<int>& tour : tours) {
+            for (int c : tour) {
+                uncollected -= instance.prizes[c];
+            }
+        }
+        objective += uncollected;
+    }
+    return objective;
+}
+
+bool toursFeasible(const Instance& instance, const std::vector<std::vector<int>>& tours) {
+    std::vector<char> served(static_cast<size_t>(instance.numNodes), 0);
+    for (const std::vector<int>& tour : tours) {
+        int load = 0;
+        float time = instance.type == ProblemType::VRPTW ? instance.startTW[0] : 0.0f;
+        int prev = 0;
+        for (int c : tour) {
+            if (c < 1 || c > instance.numCustomers || served[c]) {
+                return false;
+            }
+            served[c] = 1;
+            load += instance.demand[c];
+            if (instance.type == ProblemType::VRPTW) {
+                time = std::max(time + nodeDistance(instance, prev, c), instance.startTW[c]);
+                if (time > instance.endTW[c]) {
+                    return false;
+                }
+                time += instance.serviceTime[c];
+            }
+            prev = c;
+        }
+        if (load > instance.vehicleCapacity) {
+            return false;
+        }
+        if (instance.type == ProblemType::VRPTW && time + nodeDistance(instance, prev, 0) > instance.endTW[0]) {
+            return false;
+        }
+    }
+    if (instance.type != ProblemType::PCVRP) {
+        for (int c = 1; c <= instance.numCustomers; ++c) {
+            if (!served[c]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "LNS.h"
+
+// Decomposition for instances of 10k-100k customers. A dense distance matrix of that size does not fit in
+// memory, and an LNS iteration that removes 8-30 customers barely touches such a solution. Every round
+// partitions the solution into subproblems of about subproblemSize customers. Each is solved as an
+// independent finalized Instance/Solution pair by runLNS with the configured operators, several at once on
+// a TaskScheduler, and the tours are put back together.
+//
+// The partition works on units with a position: single customers in the first round, which has no tours
+// yet, and whole routes at their barycenter afterwards, plus the customers a PCVRP solution leaves unserved.
+// Sector cuts the polar angle around the depot into consecutive slices; Barycenter splits the units at the
+// median of alternating axes until a part is small enough. Every round rotates the partition by the golden
+// angle, so that routes next to a boundary share a subproblem the next time.
+//
+// Subproblems are warm-started from their routes and only replaced when they improved. Subproblem i of
+// round r always runs with the same seed, so runs with rounds and subproblemIterations set are
+// reproducible whatever the thread count.
+
+enum class PartitionMethod {
+    Barycenter, // Recursive median splits of the unit positions
+    Sector // Polar sectors around the depot
+};
+
+struct DecompositionConfig {
+    int subproblemSize = 1000; // Customers per subproblem, at most; Barycenter parts have at least half as many
+    PartitionMethod method = PartitionMethod::Barycenter;
+    int rounds = 0; // 0 = until lns.timeBudgetMs is spent
+    int numThreads = 0; // Subproblems solved at once; 0 = one per hardware thread
+    double subproblemBudgetMs = 1000; // Per subproblem and round; shortened so a round fits the remaining budget
+    uint64_t subproblemIterations = UINT64_MAX;
+    // Operators, local search, overall budget, seed and cancellation. Warm starts, onImprovement and
+    // repairThreads are not used.
+    LNSConfig lns;
+};
+
+struct DecompositionRound {
+    int subproblems = 0;
+    int improved = 0; // Subproblems whose tours were replaced
+    uint64_t iterations = 0;
+    double elapsedMs = 0; // Since the start of the run, at the end of the round
+    double objective = 0;
+};
+
+struct DecompositionResult {
+    std::vector<std::vector<int>> tours; // Customer ids of the instance
+    double objective = 0;
+    uint64_t iterations = 0; // LNS iterations over all subproblems
+    double elapsedMs = 0;
+    bool cancelled = false;
+    std::vector<DecompositionRound> rounds;
+};
+
+// instance may come without distanceMatrix (Instance::finalizeNodeData); only its node data is used.
+DecompositionResult runDecomposedLNS(const Instance& instance, const DecompositionConfig& config);
+
+// Objective of tours from the node data alone, summed in double: travel distance, plus the prizes left
+// uncollected for PCVRP.
+double toursObjective(const Instance& instance, const std::vector<std::vector<int>>& tours);
+
+// Whether tours serve every customer at most once (CVRP and VRPTW: exactly once) within the capacity and,
+// for VRPTW, the time windows. Checked from the node data alone.
+bool toursFeasible(const Instance& instance, const std::vector<std::vector<int>>& tours);
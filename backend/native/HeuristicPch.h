@@ -0,0 +1,18 @@
+// Precompiled header of every generated heuristic (solver/compiler.js): the framework API and the standard
+// headers the operators commonly include. It is force-included (-include) ahead of the heuristic's own
+// includes, which then cost nothing. No include guard: GCC warns about #pragma once in the main file of a
+// precompiled header, and the header is only ever included once per translation unit.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "AgentDesigned.h"
+#include "Utils.h"
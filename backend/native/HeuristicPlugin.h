@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include "AgentDesigned.h"
+
+// A heuristic built as a shared object (solver/compiler.js 'plugin') against a prebuilt host executable.
+// The host links the whole framework once and exports it (-rdynamic); the plugin contains only the
+// heuristic and PluginExports.cpp, and resolves the framework symbols from the host when it is loaded.
+// Re-deploying a changed heuristic therefore recompiles one translation unit and relinks one .so.
+
+struct HeuristicPlugin {
+    decltype(&select_by_llm_1) select;
+    decltype(&sort_by_llm_1) sort;
+};
+
+// Environment variable naming the plugin a host loads
+constexpr const char* kHeuristicPluginEnv = "VRP_HEURISTIC_PLUGIN";
+
+// Entry point of every plugin, looked up with dlsym
+extern "C" HeuristicPlugin vrpHeuristicPlugin();
+
+// Loads a plugin (RTLD_LOCAL, so several can be loaded side by side) and returns its operators.
+// Throws std::runtime_error. Defined in PluginHost.cpp, so only plugin hosts can call it.
+HeuristicPlugin loadHeuristicPlugin(const std::string& path);
@@ -0,0 +1,62 @@
+#include "Instance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+void Instance::finalize(int maxNeighbors) {
+    finalizeNodeData();
+
+    distanceMatrix.assign(static_cast<size_t>(numNodes), std::vector<float>(static_cast<size_t>(numNodes), 0.0f));
+    for (int i = 0; i < numNodes; ++i) {
+        for (int j = i + 1; j < numNodes; ++j) {
+            float dx = nodePositions[i][0] - nodePositions[j][0];
+            float dy = nodePositions[i][1] - nodePositions[j][1];
+            float d = std::sqrt(dx * dx + dy * dy);
+            distanceMatrix[i][j] = d;
+            distanceMatrix[j][i] = d;
+        }
+    }
+
+    int k = std::min(maxNeighbors, std::max(0, numCustomers - 1));
+    adj.assign(static_cast<size_t>(numNodes), {});
+    std::vector<int> order(static_cast<size_t>(numCustomers));
+    for (int i = 0; i < numNodes; ++i) {
+        std::iota(order.begin(), order.end(), 1);
+        const std::vector<float>& row = distanceMatrix[i];
+        auto byDistance = [&row](int a, int b) { return row[a] < row[b]; };
+        if (i == 0) {
+            int depotK = std::min(maxNeighbors, numCustomers);
+            std::partial_sort(order.begin(), order.begin() + depotK, order.end(), byDistance);
+            adj[0].assign(order.begin(), order.begin() + depotK);
+            continue;
+        }
+        // A customer never lists itself: park it behind the sorted range
+        std::swap(order[static_cast<size_t>(i - 1)], order.back());
+        std::partial_sort(order.begin(), order.begin() + k, order.end() - 1, byDistance);
+        adj[i].assign(order.begin(), order.begin() + k);
+    }
+}
+
+void Instance::finalizeNodeData() {
+    numNodes = static_cast<int>(nodePositions.size());
+    numCustomers = std::max(0, numNodes - 1);
+    demand.resize(static_cast<size_t>(numNodes), 0);
+    demand[0] = 0;
+
+    if (type == ProblemType::VRPTW) {
+        startTW.resize(static_cast<size_t>(numNodes), 0.0f);
+        endTW.resize(static_cast<size_t>(numNodes), 0.0f);
+        serviceTime.resize(static_cast<size_t>(numNodes), 0.0f);
+        TW_Width.resize(static_cast<size_t>(numNodes));
+        for (int i = 0; i < numNodes; ++i) {
+            TW_Width[i] = endTW[i] - startTW[i];
+        }
+    }
+
+    if (type == ProblemType::PCVRP) {
+        prizes.resize(static_cast<size_t>(numNodes), 0.0f);
+        prizes[0] = 0.0f;
+        total_prizes = std::accumulate(prizes.begin(), prizes.end(), 0.0f);
+    }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+enum class ProblemType : int {
+    CVRP = 0,
+    PCVRP = 1,
+    VRPTW = 2
+};
+
+// Problem data shared by all VRP variants. Node 0 is the depot, customers are 1..numCustomers.
+// Fields that only exist for one variant (prizes for PCVRP, time windows for VRPTW) stay empty otherwise.
+// Some operators redeclare this struct, so keep the existing field order and append new fields at the end.
+struct Instance {
+    int numNodes = 0; // Total number of nodes including depot
+    int numCustomers = 0; // Total number of customers (excluding depot)
+    int vehicleCapacity = 0; // Capacity of the vehicle (identical for all vehicles)
+    std::vector<int> demand; // Demand of each node (with the depot at index 0 having a demand of 0)
+    std::vector<float> startTW; // Start of the time window of each node
+    std::vector<float> endTW; // End of the time window of each node
+    std::vector<float> TW_Width; // endTW - startTW of each node
+    std::vector<float> serviceTime; // Service time of each node
+    std::vector<std::vector<float>> distanceMatrix; // Distance matrix between nodes
+    std::vector<std::vector<float>> nodePositions; // Node positions in 2D space
+    std::vector<std::vector<int>> adj; // Adjacency list for each node, sorted by distance
+    std::vector<float> prizes; // The prize of each node
+    float total_prizes = 0; // Sum of all prizes
+    ProblemType type = ProblemType::CVRP;
+
+    // Derives distanceMatrix, adj, TW_Width and total_prizes from the raw node data.
+    // adj only keeps the maxNeighbors closest customers of every node.
+    void finalize(int maxNeighbors = 100);
+    // finalize without distanceMatrix and adj, for instances too large for a dense matrix. Those are only
+    // solved through decomposition into finalized subproblems (Decomposition.h).
+    void finalizeNodeData();
+};
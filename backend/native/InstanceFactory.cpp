@@ -0,0 +1,207 @@
+#include "InstanceFactory.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr float kWidth = 1000.0f;
+constexpr float kHeight = 600.0f;
+constexpr float kHorizon = 2500.0f;
+constexpr float kServiceTime = 10.0f;
+constexpr int kCapacity = 100;
+
+// Prizes and time windows on top of positions and demands, mirroring backend/solver/instance.js
+void deriveVariantData(Instance& instance, std::mt19937& rng) {
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    size_t n = instance.nodePositions.size();
+    const std::vector<float>& depot = instance.nodePositions[0];
+
+    if (instance.type == ProblemType::PCVRP) {
+        instance.prizes.assign(n, 0.0f);
+        for (size_t i = 1; i < n; ++i) {
+            instance.prizes[i] = static_cast<float>(instance.demand[i]) * (6.0f + unit(rng) * 8.0f);
+        }
+    }
+
+    if (instance.type == ProblemType::VRPTW) {
+        instance.startTW.assign(n, 0.0f);
+        instance.endTW.assign(n, 0.0f);
+        instance.serviceTime.assign(n, 0.0f);
+        instance.endTW[0] = kHorizon;
+        for (size_t i = 1; i < n; ++i) {
+            const std::vector<float>& p = instance.nodePositions[i];
+            float depotDistance = std::hypot(p[0] - depot[0], p[1] - depot[1]);
+            float width = 100.0f + unit(rng) * 300.0f;
+            float latestStart = std::max(depotDistance, kHorizon - depotDistance - kServiceTime - width);
+            float start = depotDistance + unit(rng) * (latestStart - depotDistance);
+            instance.startTW[i] = start;
+            instance.endTW[i] = std::min(start + width, kHorizon - depotDistance - kServiceTime);
+            instance.serviceTime[i] = kServiceTime;
+        }
+    }
+}
+
+}
+
+Instance generateInstance(ProblemType type, InstanceFamily family, int numCustomers, uint32_t seed, bool distances) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int> demand(5, 19);
+
+    Instance instance;
+    instance.type = type;
+    instance.vehicleCapacity = kCapacity;
+    instance.nodePositions.push_back({kWidth / 2, kHeight / 2});
+    instance.demand.push_back(0);
+
+    std::vector<std::vector<float>> centres;
+    if (family == InstanceFamily::Clustered) {
+        int numClusters = numCustomers / 10 + 1;
+        for (int c = 0; c < numClusters; ++c) {
+            centres.push_back({150.0f + unit(rng) * 700.0f, 100.0f + unit(rng) * 400.0f});
+        }
+    }
+    for (int i = 0; i < numCustomers; ++i) {
+        float x;
+        float y;
+        if (family == InstanceFamily::Clustered) {
+            const std::vector<float>& centre = centres[static_cast<size_t>(i) % centres.size()];
+            float angle = unit(rng) * 6.2831853f;
+            float radius = 20.0f + unit(rng) * 80.0f;
+            x = centre[0] + std::cos(angle) * radius;
+            y = centre[1] + std::sin(angle) * radius;
+        } else {
+            x = unit(rng) * kWidth;
+            y = unit(rng) * kHeight;
+        }
+        instance.nodePositions.push_back({x, y});
+        instance.demand.push_back(demand(rng));
+    }
+
+    deriveVariantData(instance, rng);
+    if (distances) {
+        instance.finalize();
+    } else {
+        instance.finalizeNodeData();
+    }
+    return instance;
+}
+
+Instance loadInstanceFile(const std::string& path, ProblemType type, uint32_t seed, bool distances) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open " + path);
+    }
+
+    int dimension = 0;
+    int capacity = 0;
+    int depot = 1;
+    std::vector<std::vector<float>> positions;
+    std::vector<int> demands;
+    std::string line;
+    std::string section;
+    while (std::getline(file, line)) {
+        std::replace(line.begin(), line.end(), ':', ' ');
+        std::istringstream tokens(line);
+        std::string keyword;
+        if (!(tokens >> keyword)) {
+            continue;
+        }
+        if (keyword == "DIMENSION") {
+            tokens >> dimension;
+            positions.assign(static_cast<size_t>(dimension), {0.0f, 0.0f});
+            demands.assign(static_cast<size_t>(dimension), 0);
+        } else if (keyword == "CAPACITY") {
+            tokens >> capacity;
+        } else if (keyword == "EDGE_WEIGHT_TYPE") {
+            std::string weightType;
+            tokens >> weightType;
+            if (weightType != "EUC_2D") {
+                throw std::runtime_error(path + ": unsupported EDGE_WEIGHT_TYPE " + weightType);
+            }
+        } else if (keyword == "NODE_COORD_SECTION" || keyword == "DEMAND_SECTION" || keyword == "DEPOT_SECTION") {
+            section = keyword;
+        } else if (keyword == "EOF") {
+            break;
+        } else if (!section.empty() && std::isdigit(static_cast<unsigned char>(keyword[0]))) {
+            int id = std::stoi(keyword);
+            if (section == "DEPOT_SECTION") {
+                if (id > 0) {
+                    depot = id;
+                }
+                continue;
+            }
+            if (id < 1 || id > dimension) {
+                throw std::runtime_error(path + ": node id out of range");
+            }
+            if (section == "NODE_COORD_SECTION") {
+                tokens >> positions[static_cast<size_t>(id - 1)][0] >> positions[static_cast<size_t>(id - 1)][1];
+            } else {
+                tokens >> demands[static_cast<size_t>(id - 1)];
+            }
+        }
+    }
+    if (dimension < 1 || capacity <= 0 || depot > dimension) {
+        throw std::runtime_error(path + ": missing DIMENSION, CAPACITY or depot");
+    }
+
+    // The depot becomes node 0; everything is scaled to fit the synthetic plane
+    std::swap(positions[0], positions[static_cast<size_t>(depot - 1)]);
+    std::swap(demands[0], demands[static_cast<size_t>(depot - 1)]);
+    float minX = positions[0][0], maxX = minX, minY = positions[0][1], maxY = minY;
+    for (const std::vector<float>& p : positions) {
+        minX = std::min(minX, p[0]);
+        maxX = std::max(maxX, p[0]);
+        minY = std::min(minY, p[1]);
+        maxY = std::max(maxY, p[1]);
+    }
+    float scale = std::min(kWidth / std::max(maxX - minX, 1.0f), kHeight / std::max(maxY - minY, 1.0f));
+
+    Instance instance;
+    instance.type = type;
+    instance.vehicleCapacity = capacity;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        instance.nodePositions.push_back({(positions[i][0] - minX) * scale, (positions[i][1] - minY) * scale});
+        instance.demand.push_back(std::min(demands[i], capacity));
+    }
+
+    std::mt19937 rng(seed);
+    deriveVariantData(instance, rng);
+    if (distances) {
+        instance.finalize();
+    } else {
+        instance.finalizeNodeData();
+    }
+    return instance;
+}
+
+ProblemType parseProblemType(const std::string& name) {
+    if (name == "cvrp") {
+        return ProblemType::CVRP;
+    }
+    if (name == "pcvrp") {
+        return ProblemType::PCVRP;
+    }
+    if (name == "vrptw") {
+        return ProblemType::VRPTW;
+    }
+    throw std::runtime_error("unknown problem type " + name);
+}
+
+const char* problemTypeName(ProblemType type) {
+    switch (type) {
+    case ProblemType::PCVRP:
+        return "pcvrp";
+    case ProblemType::VRPTW:
+        return "vrptw";
+    default:
+        return "cvrp";
+    }
+}
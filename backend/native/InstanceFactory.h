@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Instance.h"
+
+// Instances for the offline tools (benchmarks, profiling). The API builds its instances in backend/solver/instance.js;
+// the synthetic ones here follow the same conventions: a 1000x600 plane with the depot at (500, 300), demands 5..19,
+// capacity 100, PCVRP prizes of 6..14x the demand and VRPTW windows reachable within a horizon of 2500.
+
+enum class InstanceFamily {
+    Uniform, // Customers uniformly spread over the plane
+    Clustered // Customers around numCustomers / 10 + 1 centres, like the API's generator
+};
+
+// Deterministic for a given (type, family, numCustomers, seed). Returns a finalized instance, or with
+// distances = false one without distanceMatrix and adj (Instance::finalizeNodeData).
+Instance generateInstance(ProblemType type, InstanceFamily family, int numCustomers, uint32_t seed,
+                          bool distances = true);
+
+// Reads a CVRPLIB / TSPLIB file (NODE_COORD_SECTION, DEMAND_SECTION, CAPACITY, EUC_2D).
+// Coordinates are rescaled onto the synthetic plane so the PCVRP prizes and VRPTW windows derived
+// from seed are comparable. Throws std::runtime_error on unreadable or unsupported files.
+Instance loadInstanceFile(const std::string& path, ProblemType type, uint32_t seed, bool distances = true);
+
+ProblemType parseProblemType(const std::string& name); // "cvrp", "pcvrp" or "vrptw"; throws otherwise
+const char* problemTypeName(ProblemType type);
@@ -0,0 +1,267 @@
+#include "Islands.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "LocalSearch.h"
+#include "SpscRing.h"
+#include "Trace.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// A solution without its instance reference, so that mailbox slots can be default-constructed and keep the
+// capacity of their vectors between migrations
+struct Migrant {
+    float objective = 0;
+    float totalCosts = 0;
+    double travelCosts = 0;
+    double uncollectedPrizes = 0;
+    std::vector<Tour> tours;
+    std::vector<int> customerToTourMap;
+};
+
+using Mailbox = SpscRing<Migrant, 4>;
+
+struct Island {
+    int operatorSet = 0;
+    std::vector<Mailbox*> inbox; // Written by one neighbour each, read only by this island
+    std::vector<Mailbox*> outbox; // Written only by this island
+    IslandStats stats;
+    bool cancelled = false;
+};
+
+// Best objective over all islands; the lock only serializes onImprovement
+struct SharedBest {
+    std::atomic<float> objective{std::numeric_limits<float>::max()};
+    std::mutex mutex;
+};
+
+class IslandRun {
+public:
+    IslandRun(const Instance& instance, const IslandConfig& config, int index, Island& island, SharedBest& shared,
+              Clock::time_point start)
+        : instance_(instance), config_(config), index_(index), island_(island), shared_(shared), start_(start),
+          best_(instance), operators_(config.operatorSets.empty() ? LnsOperators() : config.operatorSets[island.operatorSet]),
+          rng_(config.lns.seed * 2654435761u + static_cast<uint32_t>(index)) {}
+
+    Solution run() {
+        seedRandomGenerators(config_.lns.seed + static_cast<uint32_t>(index_));
+        setTraceThreadName("island " + std::to_string(index_));
+        std::unique_ptr<LocalSearch> localSearch;
+        if (config_.lns.localSearch) {
+            localSearch = std::make_unique<LocalSearch>(instance_);
+        }
+        for (int k = 0; k < std::max(1, config_.populationSize); ++k) {
+            bool warm = index_ == 0 && k == 0 && !config_.lns.initialTours.empty();
+            population_.push_back(warm ? solutionFromTours(instance_, config_.lns.initialTours)
+                                       : constructInitialSolution(instance_));
+            if (localSearch) {
+                localSearch->improve(population_.back());
+            }
+        }
+        best_ = *std::min_element(population_.begin(), population_.end(), byObjective);
+        report(0);
+        if (instance_.numCustomers == 0) {
+            return best_;
+        }
+
+        // One criterion for the whole population: its record is the island's best
+        Acceptance acceptance(config_.lns.acceptance, acceptanceSeed(config_.lns.seed, static_cast<uint32_t>(index_)));
+        acceptance.start(best_.objective(), instance_.numCustomers);
+        LnsWorkspace workspace(instance_);
+        workspace.localSearch = localSearch.get();
+        workspace.acceptance = &acceptance;
+        IslandStats& stats = island_.stats;
+        size_t member = 0;
+        uint64_t interval = std::max<uint64_t>(1, config_.migrationInterval);
+        while (stats.iterations < config_.lns.maxIterations) {
+            double elapsed = elapsedMs();
+            if (elapsed >= config_.lns.timeBudgetMs) {
+                break;
+            }
+            acceptance.setProgress(runProgress(config_.lns, elapsed, stats.iterations));
+            if (config_.lns.cancelled && config_.lns.cancelled->load(std::memory_order_relaxed)) {
+                island_.cancelled = true;
+                break;
+            }
+            ++stats.iterations;
+            if (workspace.trace) {
+                workspace.trace->beginIteration(stats.iterations, workspace.clock.last());
+            }
+            Solution& current = population_[member];
+            member = (member + 1) % population_.size();
+            if (lnsIteration(current, operators_, workspace) && current.objective() < best_.objective()) {
+                best_ = current;
+                bumpCounter(workspace.metrics.improved);
+                report(stats.iterations);
+            }
+            if (stats.iterations % interval == 0) {
+                migrate();
+            }
+            workspace.clock.lap(LnsPhase::Bookkeeping);
+            if (workspace.trace) {
+                workspace.trace->endIteration(workspace.clock.last());
+            }
+        }
+        best_.recomputeCosts();
+        return best_;
+    }
+
+private:
+    static bool byObjective(const Solution& a, const Solution& b) { return a.objective() < b.objective(); }
+
+    double elapsedMs() const { return std::chrono::duration<double, std::milli>(Clock::now() - start_).count(); }
+
+    void report(uint64_t iteration) {
+        float objective = best_.objective();
+        if (objective >= shared_.objective.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(shared_.mutex);
+        if (objective < shared_.objective.load(std::memory_order_relaxed)) {
+            shared_.objective.store(objective, std::memory_order_relaxed);
+            if (config_.lns.onImprovement) {
+                TraceSpan span("improve", iteration);
+                config_.lns.onImprovement(best_, iteration, elapsedMs());
+            }
+        }
+    }
+
+    bool inPopulation(float objective) const {
+        return std::any_of(population_.begin(), population_.end(),
+                           [objective](const Solution& member) { return member.objective() == objective; });
+    }
+
+    void migrate() {
+        TraceSpan span("migrate", island_.stats.iterations);
+        // Immigrants replace the worst member if they beat it and are not already there
+        for (Mailbox* mailbox : island_.inbox) {
+            while (Migrant* migrant = mailbox->front()) {
+                auto worst = std::max_element(population_.begin(), population_.end(), byObjective);
+                if (migrant->objective < worst->objective() && !inPopulation(migrant->objective)) {
+                    worst->totalCosts = migrant->totalCosts;
+                    worst->travelCosts = migrant->travelCosts;
+                    worst->uncollectedPrizes = migrant->uncollectedPrizes;
+                    worst->tours = migrant->tours;
+                    worst->customerToTourMap = migrant->customerToTourMap;
+                    ++island_.stats.immigrants;
+                    if (worst->objective() < best_.objective()) {
+                        best_ = *worst; // Already reported by the island it came from
+                    }
+                }
+                mailbox->pop();
+            }
+        }
+
+        // The island's best emigrates when it improved since it last did
+        if (island_.outbox.empty() || best_.objective() >= lastEmigrated_) {
+            return;
+        }
+        Mailbox* mailbox = island_.outbox[island_.outbox.size() == 1 ? 0 : rng_() % island_.outbox.size()];
+        Migrant* slot = mailbox->beginPush();
+        if (!slot) {
+            ++island_.stats.dropped;
+            return;
+        }
+        slot->objective = best_.objective();
+        slot->totalCosts = best_.totalCosts;
+        slot->travelCosts = best_.travelCosts;
+        slot->uncollectedPrizes = best_.uncollectedPrizes;
+        slot->tours = best_.tours;
+        slot->customerToTourMap = best_.customerToTourMap;
+        mailbox->commitPush();
+        ++island_.stats.emigrants;
+        lastEmigrated_ = best_.objective();
+    }
+
+    const Instance& instance_;
+    const IslandConfig& config_;
+    int index_;
+    Island& island_;
+    SharedBest& shared_;
+    Clock::time_point start_;
+    std::vector<Solution> population_;
+    Solution best_;
+    LnsOperators operators_;
+    std::mt19937 rng_;
+    float lastEmigrated_ = std::numeric_limits<float>::max();
+};
+
+}
+
+IslandResult runIslandLNS(const Instance& instance, const IslandConfig& config) {
+    Clock::time_point start = Clock::now();
+    int numIslands = config.numIslands > 0 ? config.numIslands
+                                           : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<Island> islands(static_cast<size_t>(numIslands));
+    int numSets = static_cast<int>(config.operatorSets.size());
+    for (int i = 0; i < numIslands; ++i) {
+        islands[i].operatorSet = numSets ? i % numSets : 0;
+        islands[i].stats.operatorSet = islands[i].operatorSet;
+    }
+
+    // One mailbox per directed edge keeps every mailbox single-producer, single-consumer
+    std::vector<std::unique_ptr<Mailbox>> mailboxes;
+    auto connect = [&](int from, int to) {
+        mailboxes.push_back(std::make_unique<Mailbox>());
+        islands[from].outbox.push_back(mailboxes.back().get());
+        islands[to].inbox.push_back(mailboxes.back().get());
+    };
+    if (numIslands > 1 && config.topology == MigrationTopology::Ring) {
+        for (int i = 0; i < numIslands; ++i) {
+            connect(i, (i + 1) % numIslands);
+        }
+    } else if (numIslands > 1) {
+        std::mt19937 rng(config.lns.seed);
+        std::vector<int> others(static_cast<size_t>(numIslands - 1));
+        int fanout = std::min(std::max(1, config.fanout), numIslands - 1);
+        for (int i = 0; i < numIslands; ++i) {
+            std::iota(others.begin(), others.end(), 0);
+            for (int& other : others) {
+                other += other >= i; // Skip i itself
+            }
+            std::shuffle(others.begin(), others.end(), rng);
+            for (int k = 0; k < fanout; ++k) {
+                connect(i, others[k]);
+            }
+        }
+    }
+
+    SharedBest shared;
+    std::vector<Solution> bests(static_cast<size_t>(numIslands), Solution(instance));
+    auto runIsland = [&](int i) {
+        IslandRun island(instance, config, i, islands[i], shared, start);
+        bests[i] = island.run();
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numIslands; ++i) {
+        threads.emplace_back(runIsland, i);
+    }
+    runIsland(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const Solution& best = *std::min_element(bests.begin(), bests.end(), [](const Solution& a, const Solution& b) {
+        return a.objective() < b.objective();
+    });
+    IslandResult result{best, 0, 0, false, {}};
+    for (int i = 0; i < numIslands; ++i) {
+        islands[i].stats.bestObjective = bests[i].objective();
+        result.iterations += islands[i].stats.iterations;
+        result.cancelled = result.cancelled || islands[i].cancelled;
+        result.islands.push_back(islands[i].stats);
+    }
+    result.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
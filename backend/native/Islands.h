@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "LNS.h"
+
+// Island model: every island is a thread with its own small population of solutions and its own operator
+// set, running lnsIteration on its members in turn. Islands exchange elite solutions asynchronously: each
+// directed edge of the migration topology is a lock-free single-producer/single-consumer mailbox
+// (SpscRing.h), so an island only ever touches its own population, its inbound and its outbound
+// mailboxes. Nothing waits: a full mailbox drops the emigrant, an empty one is skipped. The only shared
+// write is a lock taken when an island improves on the best objective of all islands, to report it.
+//
+// Migration timing depends on thread scheduling, so a run with more than one island is not reproducible.
+
+enum class MigrationTopology {
+    Ring, // Island i sends to island i + 1
+    Random // Island i sends to one of `fanout` islands drawn at the start, a random one per migration
+};
+
+struct IslandConfig {
+    int numIslands = 0; // 0 = one per hardware thread
+    MigrationTopology topology = MigrationTopology::Ring;
+    int fanout = 2; // Out-edges per island of the random topology
+    uint64_t migrationInterval = 100; // Iterations between two looks at the mailboxes
+    int populationSize = 4;
+    // Island i runs operatorSets[i % size]; empty = the linked operators on every island
+    std::vector<LnsOperators> operatorSets;
+    // Budget, iteration limit per island, seed (island i seeds its operators with seed + i and its
+    // acceptance with acceptanceSeed(seed, i)), onImprovement (called on the improving island's thread,
+    // serialized), cancellation, warm start (given to island 0), local search and acceptance (one criterion
+    // per island, shared by its population)
+    LNSConfig lns;
+};
+
+struct IslandStats {
+    int operatorSet = 0;
+    uint64_t iterations = 0;
+    uint64_t emigrants = 0; // Elites sent
+    uint64_t dropped = 0; // Elites not sent because the mailbox was full
+    uint64_t immigrants = 0; // Received elites that replaced a population member
+    float bestObjective = 0;
+};
+
+struct IslandResult {
+    Solution best;
+    uint64_t iterations = 0; // Over all islands
+    double elapsedMs = 0;
+    bool cancelled = false;
+    std::vector<IslandStats> islands;
+};
+
+IslandResult runIslandLNS(const Instance& instance, const IslandConfig& config);
@@ -0,0 +1,363 @@
+#include "LNS.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <numeric>
+
+#include "LocalSearch.h"
+#include "TaskScheduler.h"
+#include "Utils.h"
+
+namespace {
+
+struct Insertion {
+    int tourIdx = -1;
+    int pos = 0;
+    float delta = std::numeric_limits<float>::max();
+};
+
+// Earliest departure from every stop and latest feasible service start at every stop of a VRPTW tour.
+// Index 0 is the depot at the start, index customers.size() + 1 the depot at the end.
+void computeSchedule(const Instance& instance, const std::vector<int>& customers,
+                     std::vector<float>& departure, std::vector<float>& latest) {
+    const auto& dist = instance.distanceMatrix;
+    size_t n = customers.size();
+    departure.resize(n + 2);
+    latest.resize(n + 2);
+
+    departure[0] = instance.startTW[0];
+    int prev = 0;
+    for (size_t i = 0; i < n; ++i) {
+        int c = customers[i];
+        float start = std::max(departure[i] + dist[prev][c], instance.startTW[c]);
+        departure[i + 1] = start + instance.serviceTime[c];
+        prev = c;
+    }
+
+    latest[n + 1] = instance.endTW[0];
+    int next = 0;
+    for (size_t i = n; i > 0; --i) {
+        int c = customers[i - 1];
+        latest[i] = std::min(instance.endTW[c], latest[i + 1] - dist[c][next] - instance.serviceTime[c]);
+        next = c;
+    }
+}
+
+// Below this many tours the insertion scan stays on the calling thread; above it the tours are scanned in
+// chunks of kRepairGrain, which keeps one task well above the cost of a steal
+constexpr size_t kParallelRepairTours = 64;
+constexpr size_t kRepairGrain = 16;
+
+// Cheapest feasible position in tours [firstTour, lastTour); ties keep the earliest tour and position
+Insertion bestInTours(const Solution& sol, int customer, size_t firstTour, size_t lastTour,
+                      std::vector<float>& departure, std::vector<float>& latest) {
+    const Instance& instance = sol.instance;
+    const auto& dist = instance.distanceMatrix;
+    bool timeWindows = instance.type == ProblemType::VRPTW;
+    Insertion best;
+
+    for (size_t t = firstTour; t < lastTour; ++t) {
+        const Tour& tour = sol.tours[t];
+        if (tour.demand + instance.demand[customer] > instance.vehicleCapacity) {
+            continue;
+        }
+        if (timeWindows) {
+            computeSchedule(instance, tour.customers, departure, latest);
+        }
+        int prev = 0;
+        for (size_t pos = 0; pos <= tour.customers.size(); ++pos) {
+            int next = pos < tour.customers.size() ? tour.customers[pos] : 0;
+            float delta = dist[prev][customer] + dist[customer][next] - dist[prev][next];
+            if (delta < best.delta) {
+                bool feasible = true;
+                if (timeWindows) {
+                    float start = std::max(departure[pos] + dist[prev][customer], instance.startTW[customer]);
+                    float arrivalNext = start + instance.serviceTime[customer] + dist[customer][next];
+                    feasible = start <= instance.endTW[customer] && arrivalNext <= latest[pos + 1];
+                }
+                if (feasible) {
+                    best.tourIdx = static_cast<int>(t);
+                    best.pos = static_cast<int>(pos);
+                    best.delta = delta;
+                }
+            }
+            prev = next;
+        }
+    }
+    return best;
+}
+
+// Scratch state of the insertion scan, reused across the customers of one repair
+struct RepairScratch {
+    TaskScheduler* scheduler = nullptr;
+    std::vector<float> departure;
+    std::vector<float> latest;
+    std::vector<Insertion> chunks;
+};
+
+Insertion findBestInsertion(const Solution& sol, int customer, RepairScratch& scratch) {
+    const auto& dist = sol.instance.distanceMatrix;
+    size_t numTours = sol.tours.size();
+    Insertion best;
+    if (!scratch.scheduler || scratch.scheduler->numThreads() == 1 || numTours < kParallelRepairTours) {
+        best = bestInTours(sol, customer, 0, numTours, scratch.departure, scratch.latest);
+    } else {
+        size_t numChunks = (numTours + kRepairGrain - 1) / kRepairGrain;
+        scratch.chunks.assign(numChunks, Insertion());
+        Insertion* chunks = scratch.chunks.data();
+        scratch.scheduler->parallelFor(numChunks, 1, [&sol, customer, numTours, chunks](size_t begin, size_t end) {
+            // VRPTW schedules of the thread that happens to run the chunk
+            thread_local std::vector<float> departure;
+            thread_local std::vector<float> latest;
+            for (size_t chunk = begin; chunk < end; ++chunk) {
+                size_t firstTour = chunk * kRepairGrain;
+                chunks[chunk] = bestInTours(sol, customer, firstTour, std::min(numTours, firstTour + kRepairGrain),
+                                            departure, latest);
+            }
+        });
+        // Chunks in tour order with a strict comparison pick the same position as the sequential scan,
+        // whichever thread ran which chunk
+        for (size_t chunk = 0; chunk < numChunks; ++chunk) {
+            if (chunks[chunk].delta < best.delta) {
+                best = chunks[chunk];
+            }
+        }
+    }
+
+    float newTourDelta = dist[0][customer] + dist[customer][0];
+    if (newTourDelta < best.delta) {
+        best.tourIdx = static_cast<int>(sol.tours.size());
+        best.pos = 0;
+        best.delta = newTourDelta;
+    }
+    return best;
+}
+
+// Operators are generated code: drop out-of-range and duplicate ids before touching the solution.
+// Returns the number of ids dropped.
+size_t sanitizeSelection(std::vector<int>& customers, const Instance& instance, std::vector<char>& seen) {
+    seen.assign(static_cast<size_t>(instance.numNodes), 0);
+    size_t kept = 0;
+    for (int c : customers) {
+        if (c >= 1 && c <= instance.numCustomers && !seen[c]) {
+            seen[c] = 1;
+            customers[kept++] = c;
+        }
+    }
+    size_t dropped = customers.size() - kept;
+    customers.resize(kept);
+    return dropped;
+}
+
+void insertCustomers(Solution& sol, const std::vector<int>& customers, bool onlyProfitable, TaskScheduler* scheduler) {
+    const Instance& instance = sol.instance;
+    RepairScratch scratch;
+    scratch.scheduler = scheduler;
+    for (int c : customers) {
+        if (sol.customerToTourMap[c] != -1) {
+            continue;
+        }
+        Insertion insertion = findBestInsertion(sol, c, scratch);
+        if (onlyProfitable && instance.type == ProblemType::PCVRP && insertion.delta >= instance.prizes[c]) {
+            continue;
+        }
+        sol.insertCustomer(c, insertion.tourIdx, insertion.pos);
+    }
+}
+
+// Removes the operators' selection from sol and reinserts it in the operators' order
+void destroyAndRepair(Solution& sol, const LnsOperators& operators, LnsWorkspace& workspace) {
+    const Instance& instance = sol.instance;
+    PhaseClock& clock = workspace.clock;
+    // What the operators hand back, counted around their calls so the generated code stays as evolved
+    static const OperatorCounter selectedCustomers("select.customers");
+    static const OperatorCounter emptySelections("select.empty");
+    static const OperatorCounter selectDropped("select.dropped_ids");
+    static const OperatorCounter sortDropped("sort.dropped_customers");
+    std::vector<int> removed = operators.select(sol);
+    clock.lap(LnsPhase::Select);
+    selectDropped.add(sanitizeSelection(removed, instance, workspace.seen));
+    selectedCustomers.add(removed.size());
+    if (removed.empty()) {
+        emptySelections.add();
+    }
+    clock.lap(LnsPhase::Bookkeeping);
+    for (int c : removed) {
+        sol.removeCustomer(c);
+    }
+    clock.lap(LnsPhase::Reinsert);
+
+    std::vector<int> order = removed;
+    operators.sort(order, instance);
+    clock.lap(LnsPhase::Sort);
+    sanitizeSelection(order, instance, workspace.seen);
+    // seen now marks the sorted ids; customers the sort lost are still reinserted below, in selection order
+    sortDropped.add(static_cast<uint64_t>(
+        std::count_if(removed.begin(), removed.end(), [&](int c) { return !workspace.seen[c]; })));
+    clock.lap(LnsPhase::Bookkeeping);
+    reinsertCustomers(sol, order, workspace.scheduler);
+    // The sort may drop customers; CVRP and VRPTW must still serve everyone
+    reinsertCustomers(sol, removed, workspace.scheduler);
+    sol.removeEmptyTours();
+    clock.lap(LnsPhase::Reinsert);
+    if (workspace.localSearch) {
+        workspace.localSearch->improve(sol, removed);
+        clock.lap(LnsPhase::LocalSearch);
+    }
+}
+
+}
+
+void reinsertCustomers(Solution& sol, const std::vector<int>& customers, TaskScheduler* scheduler) {
+    insertCustomers(sol, customers, true, scheduler);
+}
+
+Solution constructInitialSolution(const Instance& instance, TaskScheduler* scheduler) {
+    Solution sol(instance);
+    std::vector<int> customers(static_cast<size_t>(instance.numCustomers));
+    std::iota(customers.begin(), customers.end(), 1);
+    for (size_t i = customers.size(); i > 1; --i) {
+        std::swap(customers[i - 1], customers[static_cast<size_t>(getRandomNumber(0, static_cast<int>(i) - 1))]);
+    }
+    // PCVRP starts from serving everyone; the search drops customers that do not pay off
+    insertCustomers(sol, customers, false, scheduler);
+    return sol;
+}
+
+Solution solutionFromTours(const Instance& instance, const std::vector<std::vector<int>>& tours) {
+    Solution sol(instance);
+    for (const std::vector<int>& tour : tours) {
+        int tourIdx = static_cast<int>(sol.tours.size());
+        for (int c : tour) {
+            if (c < 1 || c > instance.numCustomers || sol.customerToTourMap[c] != -1) {
+                continue;
+            }
+            int pos = tourIdx < static_cast<int>(sol.tours.size()) ? static_cast<int>(sol.tours[tourIdx].customers.size()) : 0;
+            sol.insertCustomer(c, tourIdx, pos);
+        }
+    }
+    std::vector<int> customers(static_cast<size_t>(instance.numCustomers));
+    std::iota(customers.begin(), customers.end(), 1);
+    reinsertCustomers(sol, customers);
+    return sol;
+}
+
+LnsWorkspace::LnsWorkspace(const Instance& instance)
+    : candidate(instance),
+      metrics(threadMetrics()),
+      trace(tracingEnabled() ? &threadTrace() : nullptr),
+      clock(metrics, trace) {
+    candidate.changes = &changes;
+}
+
+void ruinAndRecreate(const Solution& current, const LnsOperators& operators, LnsWorkspace& workspace) {
+    bumpCounter(workspace.metrics.iterations);
+    if (workspace.mirrored != &current) {
+        workspace.candidate = current;
+        workspace.mirrored = &current;
+    }
+    workspace.changes.clear();
+    workspace.clock.lap(LnsPhase::Bookkeeping);
+    destroyAndRepair(workspace.candidate, operators, workspace);
+}
+
+bool lnsIteration(Solution& current, const LnsOperators& operators, LnsWorkspace& workspace) {
+    // In place: a rejected iteration is undone from the journal instead of working on a copy
+    bumpCounter(workspace.metrics.iterations);
+    float objective = current.objective();
+    workspace.journal.clear();
+    current.journal = &workspace.journal;
+    workspace.clock.lap(LnsPhase::Bookkeeping);
+    destroyAndRepair(current, operators, workspace);
+    current.journal = nullptr;
+
+    // The primitives kept the objective's running sums up to date, so the delta costs nothing to read
+    float delta = current.objective() - objective;
+    bool accepted = workspace.acceptance ? workspace.acceptance->accept(objective, delta) : delta <= 0;
+    if (accepted) {
+        bumpCounter(workspace.metrics.accepted);
+    } else {
+        undoJournal(current, workspace.journal);
+    }
+    workspace.clock.lap(LnsPhase::Accept);
+    return accepted;
+}
+
+double runProgress(const LNSConfig& config, double elapsedMs, uint64_t iterations) {
+    double progress = config.timeBudgetMs > 0 ? elapsedMs / config.timeBudgetMs : 1;
+    if (config.maxIterations != UINT64_MAX) {
+        progress = std::max(progress, static_cast<double>(iterations) / static_cast<double>(config.maxIterations));
+    }
+    return progress;
+}
+
+LNSResult runLNS(const Instance& instance, const LNSConfig& config) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto elapsedMs = [&start]() {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    };
+
+    seedRandomGenerators(config.seed);
+    std::unique_ptr<TaskScheduler> scheduler;
+    if (config.repairThreads > 1) {
+        scheduler = std::make_unique<TaskScheduler>(config.repairThreads);
+    }
+    Solution current = config.initialTours.empty() ? constructInitialSolution(instance, scheduler.get())
+                                                   : solutionFromTours(instance, config.initialTours);
+    std::unique_ptr<LocalSearch> localSearch;
+    if (config.localSearch) {
+        localSearch = std::make_unique<LocalSearch>(instance);
+        localSearch->improve(current);
+    }
+    LNSResult result{current};
+    if (instance.numCustomers == 0) {
+        result.elapsedMs = elapsedMs();
+        return result;
+    }
+
+    if (config.onImprovement) {
+        config.onImprovement(result.best, 0, elapsedMs());
+    }
+
+    Acceptance acceptance(config.acceptance, acceptanceSeed(config.seed));
+    acceptance.start(current.objective(), instance.numCustomers);
+    LnsWorkspace workspace(instance);
+    workspace.scheduler = scheduler.get();
+    workspace.localSearch = localSearch.get();
+    workspace.acceptance = &acceptance;
+    while (result.iterations < config.maxIterations) {
+        double elapsed = elapsedMs();
+        if (elapsed >= config.timeBudgetMs) {
+            break;
+        }
+        acceptance.setProgress(runProgress(config, elapsed, result.iterations));
+        if (config.cancelled && config.cancelled->load(std::memory_order_relaxed)) {
+            result.cancelled = true;
+            break;
+        }
+        ++result.iterations;
+        if (workspace.trace) {
+            workspace.trace->beginIteration(result.iterations, workspace.clock.last());
+        }
+        bool accepted = lnsIteration(current, config.operators, workspace);
+        if (accepted && current.objective() < result.best.objective()) {
+            result.best = current;
+            bumpCounter(workspace.metrics.improved);
+            if (config.onImprovement) {
+                TraceSpan span("improve", result.iterations);
+                config.onImprovement(result.best, result.iterations, elapsedMs());
+            }
+        }
+        workspace.clock.lap(LnsPhase::Bookkeeping);
+        if (workspace.trace) {
+            workspace.trace->endIteration(workspace.clock.last());
+        }
+    }
+    // Incremental cost updates accumulate float rounding; report exact costs so reruns and warm starts compare equal
+    result.best.recomputeCosts();
+    result.elapsedMs = elapsedMs();
+    return result;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Acceptance.h"
+#include "AgentDesigned.h"
+#include "Instance.h"
+#include "Metrics.h"
+#include "Solution.h"
+
+class LocalSearch;
+class TaskScheduler;
+
+// Destroy and order operators of the ruin-and-recreate loop; the linked select_by_llm_1/sort_by_llm_1 by default.
+// Plugins (HeuristicPlugin.h) provide further sets, e.g. one per island of the island model (Islands.h).
+struct LnsOperators {
+    decltype(&select_by_llm_1) select = select_by_llm_1;
+    decltype(&sort_by_llm_1) sort = sort_by_llm_1;
+};
+
+struct LNSConfig {
+    double timeBudgetMs = 1000; // Wall-clock budget of the whole run
+    uint64_t maxIterations = UINT64_MAX;
+    uint32_t seed = 0;
+    // Called on the solver thread whenever the best solution improves
+    std::function<void(const Solution& best, uint64_t iteration, double elapsedMs)> onImprovement;
+    // Checked every iteration; once set the run stops and returns the best solution found so far
+    const std::atomic<bool>* cancelled = nullptr;
+    // Warm start: customer sequences of an earlier best solution, used instead of constructInitialSolution
+    std::vector<std::vector<int>> initialTours;
+    LnsOperators operators;
+    // Threads of the cheapest insertion scan (TaskScheduler.h), the calling thread included. Customers are
+    // still inserted one after another; only the scan over the tours is split, so results do not depend on it.
+    int repairThreads = 1;
+    // Polishes the initial solution and every repaired candidate, before the acceptance, with the granular
+    // local search of LocalSearch.h
+    bool localSearch = false;
+    // Decides on each candidate from its objective delta (Acceptance.h); its random stream is seeded with
+    // acceptanceSeed(seed), apart from the operators' stream
+    AcceptanceConfig acceptance;
+};
+
+struct LNSResult {
+    Solution best;
+    uint64_t iterations = 0;
+    double elapsedMs = 0;
+    bool cancelled = false;
+};
+
+// Greedy cheapest insertion of all customers, in random order. PCVRP customers are all served initially.
+// The scan for each customer's position runs on scheduler if given.
+Solution constructInitialSolution(const Instance& instance, TaskScheduler* scheduler = nullptr);
+
+// Rebuilds a solution from customer sequences. Invalid or repeated ids are skipped and customers missing
+// from the tours are reinserted, so any input yields a complete solution.
+Solution solutionFromTours(const Instance& instance, const std::vector<std::vector<int>>& tours);
+
+// Inserts every customer of the list that is not served yet at its cheapest feasible position,
+// opening a new tour when no existing tour fits. PCVRP customers that do not pay for their detour stay unserved.
+void reinsertCustomers(Solution& sol, const std::vector<int>& customers, TaskScheduler* scheduler = nullptr);
+
+// Per-thread scratch state of lnsIteration and ruinAndRecreate: the undo journal, the candidate buffer,
+// the calling thread's metrics block and phase clock, and an optional scheduler for the repair, local
+// search for the repaired solution and acceptance criterion (greedy if unset).
+//
+// Between calls of ruinAndRecreate the candidate mirrors the solution `mirrored` points at, so a call only
+// changes and later commits or rolls back the tours it touched instead of copying all of them. Code that
+// changes the mirrored solution other than through syncChanges resets `mirrored`, which makes the next
+// call copy it in full.
+struct LnsWorkspace {
+    explicit LnsWorkspace(const Instance& instance);
+
+    SolutionJournal journal; // lnsIteration's changes to current
+    Solution candidate;
+    SolutionChanges changes; // What the last ruinAndRecreate changed in candidate
+    const Solution* mirrored = nullptr;
+    std::vector<char> seen;
+    ThreadMetrics& metrics;
+    ThreadTrace* trace;
+    PhaseClock clock;
+    TaskScheduler* scheduler = nullptr;
+    LocalSearch* localSearch = nullptr;
+    Acceptance* acceptance = nullptr;
+};
+
+// Ruin and recreate without the acceptance: leaves the repaired copy of current in workspace.candidate and
+// the tours it changed in workspace.changes. The caller syncs candidate and current again (syncChanges)
+// or resets workspace.mirrored.
+void ruinAndRecreate(const Solution& current, const LnsOperators& operators, LnsWorkspace& workspace);
+
+// One ruin-and-recreate iteration on current, in place: the operators remove and order customers,
+// reinsertCustomers repairs the solution, and the journal undoes it all if workspace.acceptance rejects
+// the result (without one: if it is worse). Returns whether the result was kept.
+bool lnsIteration(Solution& current, const LnsOperators& operators, LnsWorkspace& workspace);
+
+// Fraction of a run that is spent, for Acceptance::setProgress: of the time budget or of the iteration
+// limit, whichever is further along.
+double runProgress(const LNSConfig& config, double elapsedMs, uint64_t iterations);
+
+// Ruin-and-recreate loop of lnsIteration on a single solution.
+LNSResult runLNS(const Instance& instance, const LNSConfig& config);
@@ -0,0 +1,380 @@
+#include "LocalSearch.h"
+
+#include <algorithm>
+
+namespace {
+
+// Distances are floats; smaller gains are rounding noise, and applying them could cycle
+constexpr float kMinGain = 1e-3f;
+
+}
+
+LocalSearch::LocalSearch(const Instance& instance, int granularity)
+    : instance_(instance),
+      granularity_(std::max(1, granularity)),
+      pos_(static_cast<size_t>(instance.numNodes), 0),
+      load_(static_cast<size_t>(instance.numNodes), 0),
+      departure_(static_cast<size_t>(instance.numNodes), 0.0f),
+      latest_(static_cast<size_t>(instance.numNodes), 0.0f),
+      active_(static_cast<size_t>(instance.numNodes), 0) {}
+
+int LocalSearch::improve(Solution& sol) {
+    std::vector<int> customers(static_cast<size_t>(instance_.numCustomers));
+    for (int c = 1; c <= instance_.numCustomers; ++c) {
+        customers[static_cast<size_t>(c - 1)] = c;
+    }
+    return improve(sol, customers);
+}
+
+int LocalSearch::improve(Solution& sol, const std::vector<int>& customers) {
+    sol_ = &sol;
+    if (++stamp_ == 0) {
+        std::fill(tourStamp_.begin(), tourStamp_.end(), 0);
+        stamp_ = 1;
+    }
+    tourStamp_.resize(std::max(tourStamp_.size(), sol.tours.size()), 0);
+    for (int c : customers) {
+        if (c >= 1 && c <= instance_.numCustomers && tourOf(c) >= 0) {
+            ensure(tourOf(c));
+            activate(c);
+            activate(prev(c));
+            activate(next(c));
+        }
+    }
+
+    int moves = 0;
+    for (size_t head = 0; head < queue_.size(); ++head) {
+        int u = queue_[head];
+        active_[u] = 0;
+        if (tourOf(u) >= 0 && improveCustomer(u)) {
+            ++moves;
+        }
+    }
+    queue_.clear();
+    if (moves) {
+        sol.removeEmptyTours();
+    }
+    sol_ = nullptr;
+    return moves;
+}
+
+int LocalSearch::prev(int c) const {
+    int p = pos_[c];
+    return p > 0 ? customersOf(tourOf(c))[static_cast<size_t>(p - 1)] : 0;
+}
+
+int LocalSearch::next(int c) const {
+    const std::vector<int>& customers = customersOf(tourOf(c));
+    size_t p = static_cast<size_t>(pos_[c]) + 1;
+    return p < customers.size() ? customers[p] : 0;
+}
+
+void LocalSearch::ensure(int tourIdx) {
+    if (tourStamp_[tourIdx] != stamp_) {
+        refresh(tourIdx);
+    }
+}
+
+void LocalSearch::refresh(int tourIdx) {
+    const std::vector<int>& customers = customersOf(tourIdx);
+    bool timeWindows = instance_.type == ProblemType::VRPTW;
+    int load = 0;
+    int prevNode = 0;
+    float time = timeWindows ? instance_.startTW[0] : 0.0f;
+    for (size_t i = 0; i < customers.size(); ++i) {
+        int c = customers[i];
+        pos_[c] = static_cast<int>(i);
+        load += instance_.demand[c];
+        load_[c] = load;
+        if (timeWindows) {
+            time = std::max(time + dist(prevNode, c), instance_.startTW[c]) + instance_.serviceTime[c];
+            departure_[c] = time;
+            prevNode = c;
+        }
+    }
+    if (timeWindows) {
+        float late = instance_.endTW[0];
+        int nextNode = 0;
+        for (size_t i = customers.size(); i > 0; --i) {
+            int c = customers[i - 1];
+            late = std::min(instance_.endTW[c], late - dist(c, nextNode) - instance_.serviceTime[c]);
+            latest_[c] = late;
+            nextNode = c;
+        }
+    }
+    tourStamp_[tourIdx] = stamp_;
+}
+
+void LocalSearch::activate(int node) {
+    if (node && !active_[node]) {
+        active_[node] = 1;
+        queue_.push_back(node);
+    }
+}
+
+bool LocalSearch::improveCustomer(int u) {
+    int ru = tourOf(u);
+    ensure(ru);
+    const std::vector<int>& neighbors = instance_.adj[u];
+    size_t count = std::min(neighbors.size(), static_cast<size_t>(granularity_));
+    for (size_t i = 0; i < count; ++i) {
+        int v = neighbors[i];
+        int rv = tourOf(v);
+        if (rv < 0) {
+            continue;
+        }
+        ensure(rv);
+        if (moveSegment(u, 1, rv, v) || moveSegment(u, 1, rv, prev(v)) || swap(u, v)) {
+            return true;
+        }
+        if (ru == rv ? twoOpt(u, v) : (twoOptStar(u, v) || twoOptStar(v, u))) {
+            return true;
+        }
+        if (moveSegment(u, 2, rv, v) || moveSegment(u, 3, rv, v)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Moves u and the length - 1 customers behind it between `after` (0: the start depot) and its successor in
+// tour tourIdx
+bool LocalSearch::moveSegment(int u, int length, int tourIdx, int after) {
+    int ru = tourOf(u);
+    const std::vector<int>& from = customersOf(ru);
+    int first = pos_[u];
+    if (first + length > static_cast<int>(from.size())) {
+        return false;
+    }
+    int last = from[static_cast<size_t>(first + length - 1)];
+    const std::vector<int>& to = customersOf(tourIdx);
+    int before = after ? next(after) : to.front();
+    if (ru == tourIdx && (before == u || (after && pos_[after] >= first && pos_[after] < first + length))) {
+        return false;
+    }
+    int pu = prev(u);
+    int nl = next(last);
+    float delta = dist(pu, nl) - dist(pu, u) - dist(last, nl) + dist(after, u) + dist(last, before) - dist(after, before);
+    if (delta > -kMinGain) {
+        return false;
+    }
+
+    bool timeWindows = instance_.type == ProblemType::VRPTW;
+    if (ru != tourIdx) {
+        int load = loadTo(last) - loadTo(pu);
+        if (sol_->tours[tourIdx].demand + load > instance_.vehicleCapacity ||
+            (timeWindows && !segmentFits(after, u, length, before))) {
+            return false;
+        }
+    } else if (timeWindows) {
+        sequence_.clear();
+        auto pushSegment = [&] {
+            sequence_.insert(sequence_.end(), from.begin() + first, from.begin() + first + length);
+        };
+        if (!after) {
+            pushSegment();
+        }
+        for (int i = 0; i < static_cast<int>(from.size()); ++i) {
+            if (i >= first && i < first + length) {
+                continue;
+            }
+            sequence_.push_back(from[static_cast<size_t>(i)]);
+            if (from[static_cast<size_t>(i)] == after) {
+                pushSegment();
+            }
+        }
+        if (!scheduleFeasible(sequence_)) {
+            return false;
+        }
+    }
+
+    moved_.assign(from.begin() + first, from.begin() + first + length);
+    for (int c : moved_) {
+        sol_->removeCustomer(c);
+    }
+    int p = after ? sol_->positionInTour(after) + 1 : 0;
+    for (int c : moved_) {
+        sol_->insertCustomer(c, tourIdx, p++);
+    }
+    applied(delta, {pu, nl, after, before, u, last}, ru, tourIdx);
+    return true;
+}
+
+bool LocalSearch::swap(int u, int v) {
+    int ru = tourOf(u);
+    int rv = tourOf(v);
+    int pu = prev(u);
+    int nu = next(u);
+    int pv = prev(v);
+    int nv = next(v);
+    if (ru == rv && (nu == v || nv == u)) {
+        return false; // Adjacent customers: a relocate
+    }
+    float delta = dist(pu, v) + dist(v, nu) - dist(pu, u) - dist(u, nu) + dist(pv, u) + dist(u, nv) - dist(pv, v) -
+                  dist(v, nv);
+    if (delta > -kMinGain) {
+        return false;
+    }
+
+    bool timeWindows = instance_.type == ProblemType::VRPTW;
+    if (ru != rv) {
+        int difference = instance_.demand[v] - instance_.demand[u];
+        if (sol_->tours[ru].demand + difference > instance_.vehicleCapacity ||
+            sol_->tours[rv].demand - difference > instance_.vehicleCapacity ||
+            (timeWindows && (!segmentFits(pu, v, 1, nu) || !segmentFits(pv, u, 1, nv)))) {
+            return false;
+        }
+    } else if (timeWindows) {
+        sequence_ = customersOf(ru);
+        std::swap(sequence_[static_cast<size_t>(pos_[u])], sequence_[static_cast<size_t>(pos_[v])]);
+        if (!scheduleFeasible(sequence_)) {
+            return false;
+        }
+    }
+
+    int a = pos_[u];
+    int b = pos_[v];
+    sol_->removeCustomer(u);
+    sol_->removeCustomer(v);
+    // Within one tour the lower position has to be filled first
+    if (ru == rv && b < a) {
+        sol_->insertCustomer(u, rv, b);
+        sol_->insertCustomer(v, ru, a);
+    } else {
+        sol_->insertCustomer(v, ru, a);
+        sol_->insertCustomer(u, rv, b);
+    }
+    applied(delta, {pu, nu, pv, nv, u, v}, ru, rv);
+    return true;
+}
+
+// Reverses the stretch behind the earlier of u and v up to the later one, which makes them adjacent
+bool LocalSearch::twoOpt(int u, int v) {
+    int a = pos_[u] < pos_[v] ? u : v;
+    int b = a == u ? v : u;
+    int na = next(a);
+    if (na == b) {
+        return false;
+    }
+    int nb = next(b);
+    float delta = dist(a, b) + dist(na, nb) - dist(a, na) - dist(b, nb);
+    if (delta > -kMinGain) {
+        return false;
+    }
+
+    int tourIdx = tourOf(a);
+    const std::vector<int>& customers = customersOf(tourIdx);
+    int begin = pos_[na];
+    int end = pos_[b] + 1;
+    if (instance_.type == ProblemType::VRPTW) {
+        sequence_ = customers;
+        std::reverse(sequence_.begin() + begin, sequence_.begin() + end);
+        if (!scheduleFeasible(sequence_)) {
+            return false;
+        }
+    }
+
+    moved_.assign(customers.begin() + begin, customers.begin() + end);
+    for (int c : moved_) {
+        sol_->removeCustomer(c);
+    }
+    for (auto it = moved_.rbegin(); it != moved_.rend(); ++it) {
+        sol_->insertCustomer(*it, tourIdx, begin++);
+    }
+    applied(delta, {a, na, b, nb}, tourIdx, tourIdx);
+    return true;
+}
+
+// Tour of a continues behind a with b and the rest of b's tour; b's tour continues in front of b with
+// what followed a
+bool LocalSearch::twoOptStar(int a, int b) {
+    int ra = tourOf(a);
+    int rb = tourOf(b);
+    int na = next(a);
+    int pb = prev(b);
+    float delta = dist(a, b) + dist(pb, na) - dist(a, na) - dist(pb, b);
+    if (delta > -kMinGain) {
+        return false;
+    }
+    int capacity = instance_.vehicleCapacity;
+    if (loadTo(a) + sol_->tours[rb].demand - loadTo(pb) > capacity ||
+        loadTo(pb) + sol_->tours[ra].demand - loadTo(a) > capacity) {
+        return false;
+    }
+    if (instance_.type == ProblemType::VRPTW &&
+        (departure(a) + dist(a, b) > latest(b) || departure(pb) + dist(pb, na) > latest(na))) {
+        return false;
+    }
+
+    const std::vector<int>& tourA = customersOf(ra);
+    const std::vector<int>& tourB = customersOf(rb);
+    moved_.assign(tourA.begin() + pos_[a] + 1, tourA.end());
+    sequence_.assign(tourB.begin() + pos_[b], tourB.end());
+    for (int c : moved_) {
+        sol_->removeCustomer(c);
+    }
+    for (int c : sequence_) {
+        sol_->removeCustomer(c);
+    }
+    for (int c : sequence_) {
+        sol_->insertCustomer(c, ra, static_cast<int>(sol_->tours[ra].customers.size()));
+    }
+    for (int c : moved_) {
+        sol_->insertCustomer(c, rb, static_cast<int>(sol_->tours[rb].customers.size()));
+    }
+    applied(delta, {a, na, pb, b}, ra, rb);
+    return true;
+}
+
+// Whether the length customers from first on can be served between `after` and `before` of another tour
+bool LocalSearch::segmentFits(int after, int first, int length, int before) const {
+    const std::vector<int>& customers = customersOf(tourOf(first));
+    float time = departure(after);
+    int prevNode = after;
+    for (int i = 0; i < length; ++i) {
+        int c = customers[static_cast<size_t>(pos_[first] + i)];
+        time = std::max(time + dist(prevNode, c), instance_.startTW[c]);
+        if (time > instance_.endTW[c]) {
+            return false;
+        }
+        time += instance_.serviceTime[c];
+        prevNode = c;
+    }
+    return time + dist(prevNode, before) <= latest(before);
+}
+
+bool LocalSearch::scheduleFeasible(const std::vector<int>& customers) const {
+    float time = instance_.startTW[0];
+    int prevNode = 0;
+    for (int c : customers) {
+        time = std::max(time + dist(prevNode, c), instance_.startTW[c]);
+        if (time > instance_.endTW[c]) {
+            return false;
+        }
+        time += instance_.serviceTime[c];
+        prevNode = c;
+    }
+    return time + dist(prevNode, 0) <= instance_.endTW[0];
+}
+
+// Rebuilds the data of the changed tours and puts the customers around the changed edges back on the work list
+void LocalSearch::applied(float delta, std::initializer_list<int> nodes, int tourA, int tourB) {
+    ++movesApplied_;
+    refresh(tourA);
+    if (tourB != tourA) {
+        refresh(tourB);
+    }
+    for (int node : nodes) {
+        activate(node);
+    }
+    // Loads and schedules changed along both tours, so moves of their other customers may fit now
+    for (int c : customersOf(tourA)) {
+        activate(c);
+    }
+    for (int c : customersOf(tourB)) {
+        activate(c);
+    }
+    if (onMove) {
+        onMove(*sol_, delta);
+    }
+}
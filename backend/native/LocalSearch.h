@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+#include "Instance.h"
+#include "Solution.h"
+
+// Granular local search that polishes repaired LNS candidates (LNSConfig::localSearch). For a customer u
+// it only looks at moves that make u adjacent to one of its first `granularity` neighbours v in
+// Instance::adj:
+//   relocate   u after v, or before v
+//   swap       u and v
+//   2-opt      reverse the stretch between u and v within one tour
+//   2-opt*     exchange the tails of the tours of u and v behind u and in front of v (and the reverse)
+//   Or-opt     move u and the one or two customers following it behind v
+//
+// Every move is priced in O(1) from distanceMatrix. Between tours, capacity and time windows are checked
+// in O(1) as well, from the load prefix of every customer and the earliest departure and latest start of
+// its tour's schedule (computed like the repair's computeSchedule). Only improving VRPTW moves within one
+// tour replay that tour's schedule. The first improving move is applied, through Solution's mutation
+// primitives, so the journal and SolutionChanges see it like any repair. Per-tour data is rebuilt lazily
+// on the first look at a tour in each call, so the solution may change freely between calls.
+//
+// Don't-look bits: a call starts from the given customers and their tour neighbours. A customer without
+// an improving move drops out of the work list; an applied move puts the customers around the changed
+// edges and those of the changed tours back on it. The served set stays the same, so PCVRP prizes are unaffected.
+
+class LocalSearch {
+public:
+    explicit LocalSearch(const Instance& instance, int granularity = 20);
+
+    // Improves sol until no customer on the work list has an improving move, then drops tours that ran
+    // empty. Returns the number of moves applied.
+    int improve(Solution& sol, const std::vector<int>& customers);
+    int improve(Solution& sol); // Starting from every customer
+
+    uint64_t movesApplied() const { return movesApplied_; } // Over all calls
+
+    // Called after every applied move with the solution and the move's predicted change of travel distance
+    // (the native tests check it against recomputeCosts). Tours emptied by the move are still in place.
+    std::function<void(const Solution& sol, float delta)> onMove;
+
+private:
+    float dist(int a, int b) const { return instance_.distanceMatrix[a][b]; }
+    int tourOf(int c) const { return sol_->customerToTourMap[c]; }
+    const std::vector<int>& customersOf(int tourIdx) const { return sol_->tours[tourIdx].customers; }
+    int prev(int c) const;
+    int next(int c) const; // 0 for the depot at either end
+    int loadTo(int node) const { return node ? load_[node] : 0; } // Demand of the tour up to node
+    float departure(int node) const { return node ? departure_[node] : instance_.startTW[0]; }
+    float latest(int node) const { return node ? latest_[node] : instance_.endTW[0]; }
+
+    void ensure(int tourIdx);
+    void refresh(int tourIdx);
+    void activate(int node);
+    bool improveCustomer(int u);
+
+    bool moveSegment(int u, int length, int tourIdx, int after);
+    bool swap(int u, int v);
+    bool twoOpt(int u, int v);
+    bool twoOptStar(int a, int b);
+
+    bool segmentFits(int after, int first, int length, int before) const;
+    bool scheduleFeasible(const std::vector<int>& customers) const;
+    void applied(float delta, std::initializer_list<int> nodes, int tourA, int tourB);
+
+    const Instance& instance_;
+    int granularity_;
+    Solution* sol_ = nullptr;
+    uint64_t movesApplied_ = 0;
+
+    // Per customer, valid while the stamp of its tour is current
+    std::vector<int> pos_;
+    std::vector<int> load_; // Demand of the tour up to and including the customer
+    std::vector<float> departure_; // Earliest departure after service
+    std::vector<float> latest_; // Latest service start that keeps the rest of the tour feasible
+    std::vector<uint32_t> tourStamp_;
+    uint32_t stamp_ = 0;
+
+    std::vector<char> active_;
+    std::vector<int> queue_;
+    std::vector<int> sequence_; // Scratch: a tour after a move, for the VRPTW check
+    std::vector<int> moved_; // Scratch: customers taken out by a move
+};
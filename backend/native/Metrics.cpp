@@ -0,0 +1,147 @@
+#include "Metrics.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+std::mutex registryMutex;
+std::vector<ThreadMetrics*> threadBlocks; // Blocks of the running threads
+// Counts of the threads that exited, folded in when they did so that the registry only grows with the number
+// of threads alive at once, not with every short-lived worker thread of a long-lived process
+ThreadMetrics retiredMetrics;
+uint32_t retiredThreads = 0;
+std::vector<std::string> counterNames;
+
+// Adds the counts of from to into; callers hold registryMutex
+void addCounts(ThreadMetrics& into, const ThreadMetrics& from) {
+    auto add = [](std::atomic<uint64_t>& total, const std::atomic<uint64_t>& count) {
+        total.store(total.load(std::memory_order_relaxed) + count.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+    };
+    add(into.iterations, from.iterations);
+    add(into.accepted, from.accepted);
+    add(into.improved, from.improved);
+    for (int p = 0; p < kNumLnsPhases; ++p) {
+        add(into.phaseCalls[p], from.phaseCalls[p]);
+        add(into.phaseCycles[p], from.phaseCycles[p]);
+        for (int b = 0; b < kLatencyBuckets; ++b) {
+            add(into.phaseLatency[p][b], from.phaseLatency[p][b]);
+        }
+    }
+    for (int i = 0; i < kMaxOperatorCounters; ++i) {
+        add(into.operatorCounts[i], from.operatorCounts[i]);
+    }
+}
+
+// Owns the calling thread's block: registers it on construction and retires it at thread exit
+struct ThreadMetricsOwner {
+    ThreadMetrics* block = new ThreadMetrics();
+
+    ThreadMetricsOwner() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        threadBlocks.push_back(block);
+    }
+
+    ~ThreadMetricsOwner() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        addCounts(retiredMetrics, *block);
+        ++retiredThreads;
+        threadBlocks.erase(std::find(threadBlocks.begin(), threadBlocks.end(), block));
+        delete block;
+    }
+};
+
+// Midpoint of the bucket holding the given quantile, in cycles
+double latencyQuantile(const std::atomic<uint64_t> (&histogram)[kLatencyBuckets], double quantile) {
+    uint64_t total = 0;
+    for (const std::atomic<uint64_t>& count : histogram) {
+        total += count.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(total - 1));
+    uint64_t seen = 0;
+    for (int b = 0; b < kLatencyBuckets; ++b) {
+        seen += histogram[b].load(std::memory_order_relaxed);
+        if (seen > rank) {
+            return 1.5 * static_cast<double>(uint64_t(1) << b);
+        }
+    }
+    return 0;
+}
+
+}
+
+const char* lnsPhaseName(LnsPhase phase) {
+    switch (phase) {
+    case LnsPhase::Select:
+        return "select";
+    case LnsPhase::Sort:
+        return "sort";
+    case LnsPhase::Reinsert:
+        return "reinsert";
+    case LnsPhase::Accept:
+        return "accept";
+    case LnsPhase::LocalSearch:
+        return "localSearch";
+    default:
+        return "bookkeeping";
+    }
+}
+
+OperatorCounter::OperatorCounter(const char* name) : slot_(-1) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (size_t i = 0; i < counterNames.size(); ++i) {
+        if (counterNames[i] == name) {
+            slot_ = static_cast<int>(i);
+            return;
+        }
+    }
+    if (counterNames.size() < kMaxOperatorCounters) {
+        slot_ = static_cast<int>(counterNames.size());
+        counterNames.push_back(name);
+    }
+}
+
+void OperatorCounter::add(uint64_t count) const {
+    if (slot_ >= 0) {
+        bumpCounter(threadMetrics().operatorCounts[slot_], count);
+    }
+}
+
+ThreadMetrics& threadMetrics() {
+    thread_local ThreadMetricsOwner owner;
+    return *owner.block;
+}
+
+MetricsSnapshot snapshotMetrics() {
+    MetricsSnapshot snapshot;
+    snapshot.cyclesPerNs = cyclesPerNs();
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    snapshot.threads = retiredThreads + static_cast<uint32_t>(threadBlocks.size());
+    auto total = std::make_unique<ThreadMetrics>();
+    addCounts(*total, retiredMetrics);
+    for (const ThreadMetrics* block : threadBlocks) {
+        addCounts(*total, *block);
+    }
+    snapshot.iterations = total->iterations.load(std::memory_order_relaxed);
+    snapshot.accepted = total->accepted.load(std::memory_order_relaxed);
+    snapshot.improved = total->improved.load(std::memory_order_relaxed);
+    for (int p = 0; p < kNumLnsPhases; ++p) {
+        PhaseTotals& phase = snapshot.phases[p];
+        phase.calls = total->phaseCalls[p].load(std::memory_order_relaxed);
+        phase.cycles = total->phaseCycles[p].load(std::memory_order_relaxed);
+        phase.ms = static_cast<double>(phase.cycles) / snapshot.cyclesPerNs / 1e6;
+        phase.p50Ns = latencyQuantile(total->phaseLatency[p], 0.5) / snapshot.cyclesPerNs;
+        phase.p99Ns = latencyQuantile(total->phaseLatency[p], 0.99) / snapshot.cyclesPerNs;
+        phase.p999Ns = latencyQuantile(total->phaseLatency[p], 0.999) / snapshot.cyclesPerNs;
+    }
+    for (size_t i = 0; i < counterNames.size(); ++i) {
+        snapshot.operatorCounters.emplace_back(counterNames[i], total->operatorCounts[i].load(std::memory_order_relaxed));
+    }
+    return snapshot;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CycleClock.h"
+#include "Trace.h"
+
+// Hot-path counters of the LNS loop. Every thread that runs the LNS owns one cache-line aligned block
+// that only it writes, with relaxed stores and no read-modify-write, so counting costs a few cycles and
+// never contends. snapshotMetrics() may be called from any thread and sums the blocks of all threads.
+
+enum class LnsPhase : uint8_t {
+    Select, // select_by_llm_1
+    Sort, // sort_by_llm_1
+    Reinsert, // Removing the selection from the candidate and reinserting it
+    Accept, // Comparing candidate and current solution, adopting the candidate
+    Bookkeeping, // Candidate copy, sanitizing operator output, best-solution updates and progress callbacks
+    LocalSearch, // Polishing the repaired candidate (LNSConfig::localSearch)
+    Count
+};
+
+constexpr int kNumLnsPhases = static_cast<int>(LnsPhase::Count);
+constexpr int kMaxOperatorCounters = 32;
+constexpr int kLatencyBuckets = 48; // Bucket b counts timed sections of [2^b, 2^(b+1)) cycles
+
+const char* lnsPhaseName(LnsPhase phase);
+
+// Named event count of the operators. The LNS loop keeps them around its select_by_llm_1 and sort_by_llm_1
+// calls (customers selected, empty selections, ids dropped as invalid or repeated, customers the sort lost);
+// new operators may add their own:
+//   static const OperatorCounter rejected("select.random_retry_rejected");
+//   rejected.add();
+// Counters with the same name share one slot; past kMaxOperatorCounters names, add() is a no-op.
+class OperatorCounter {
+public:
+    explicit OperatorCounter(const char* name);
+    void add(uint64_t count = 1) const;
+
+private:
+    int slot_;
+};
+
+struct alignas(64) ThreadMetrics {
+    std::atomic<uint64_t> iterations{0};
+    std::atomic<uint64_t> accepted{0}; // Candidates that replaced the current solution
+    std::atomic<uint64_t> improved{0}; // Candidates that became the new best solution
+    std::atomic<uint64_t> phaseCalls[kNumLnsPhases] = {};
+    std::atomic<uint64_t> phaseCycles[kNumLnsPhases] = {};
+    std::atomic<uint64_t> phaseLatency[kNumLnsPhases][kLatencyBuckets] = {};
+    std::atomic<uint64_t> operatorCounts[kMaxOperatorCounters] = {};
+};
+
+// Block of the calling thread, registered on first use. When the thread exits its counts are folded into the
+// process totals and the block is freed.
+ThreadMetrics& threadMetrics();
+
+// Only the owning thread writes a counter, so a load and a store suffice
+inline void bumpCounter(std::atomic<uint64_t>& counter, uint64_t count = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+inline int latencyBucket(uint64_t cycles) {
+    int bucket = cycles ? 63 - __builtin_clzll(cycles) : 0;
+    return bucket < kLatencyBuckets ? bucket : kLatencyBuckets - 1;
+}
+
+// Attributes the cycles since the previous lap to a phase: one counter read per phase boundary.
+// With a trace (Trace.h) the lap also becomes a span of the current iteration.
+class PhaseClock {
+public:
+    explicit PhaseClock(ThreadMetrics& metrics, ThreadTrace* trace = nullptr)
+        : metrics_(metrics), trace_(trace), last_(readCycleCounter()) {}
+
+    void lap(LnsPhase phase) {
+        uint64_t now = readCycleCounter();
+        int p = static_cast<int>(phase);
+        bumpCounter(metrics_.phaseCalls[p]);
+        bumpCounter(metrics_.phaseCycles[p], now - last_);
+        bumpCounter(metrics_.phaseLatency[p][latencyBucket(now - last_)]);
+        if (trace_) {
+            trace_->span(lnsPhaseName(phase), last_, now);
+        }
+        last_ = now;
+    }
+
+    // Starts the next lap now and leaves the time since the previous one unattributed, e.g. time spent
+    // waiting for other threads.
+    void skip() { last_ = readCycleCounter(); }
+
+    uint64_t last() const { return last_; }
+
+private:
+    ThreadMetrics& metrics_;
+    ThreadTrace* trace_;
+    uint64_t last_;
+};
+
+struct PhaseTotals {
+    uint64_t calls = 0; // Timed sections; Reinsert and Bookkeeping are entered several times per iteration
+    uint64_t cycles = 0;
+    double ms = 0; // cycles converted with the measured cycle counter frequency
+    // Quantiles of a single timed section, from the log2 histogram (factor-2 resolution). For select and
+    // sort a section is exactly one operator call; a p999Ns far above p50Ns marks a heavy-tailed operator.
+    double p50Ns = 0;
+    double p99Ns = 0;
+    double p999Ns = 0;
+};
+
+struct MetricsSnapshot {
+    uint32_t threads = 0;
+    uint64_t iterations = 0;
+    uint64_t accepted = 0;
+    uint64_t improved = 0;
+    double cyclesPerNs = 1;
+    PhaseTotals phases[kNumLnsPhases];
+    std::vector<std::pair<std::string, uint64_t>> operatorCounters; // Named counters in registration order
+};
+
+// Totals since process start over all threads.
+MetricsSnapshot snapshotMetrics();
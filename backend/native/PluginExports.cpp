@@ -0,0 +1,7 @@
+// Linked into every heuristic plugin: exposes the heuristic's operators under an unmangled name.
+
+#include "HeuristicPlugin.h"
+
+extern "C" HeuristicPlugin vrpHeuristicPlugin() {
+    return {&select_by_llm_1, &sort_by_llm_1};
+}
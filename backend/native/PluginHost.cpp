@@ -0,0 +1,53 @@
+// Linked into plugin hosts in place of a heuristic: the operators forward to the plugin named by
+// VRP_HEURISTIC_PLUGIN, loaded on the first call. They are hidden so that the host, which exports every
+// other symbol for the plugin, does not interpose them on the plugin's own definitions.
+
+#include <dlfcn.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+
+#include "HeuristicPlugin.h"
+
+namespace {
+
+const HeuristicPlugin& plugin() {
+    static const HeuristicPlugin loaded = [] {
+        const char* path = std::getenv(kHeuristicPluginEnv);
+        if (!path || !*path) {
+            std::fprintf(stderr, "plugin host: %s is not set\n", kHeuristicPluginEnv);
+            std::exit(2);
+        }
+        try {
+            return loadHeuristicPlugin(path);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "plugin host: %s\n", e.what());
+            std::exit(2);
+        }
+    }();
+    return loaded;
+}
+
+}
+
+HeuristicPlugin loadHeuristicPlugin(const std::string& path) {
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        throw std::runtime_error(dlerror());
+    }
+    auto entry = reinterpret_cast<HeuristicPlugin (*)()>(dlsym(handle, "vrpHeuristicPlugin"));
+    if (!entry) {
+        throw std::runtime_error(path + " has no vrpHeuristicPlugin");
+    }
+    return entry();
+}
+
+__attribute__((visibility("hidden"))) std::vector<int> select_by_llm_1(const Solution& sol) {
+    return plugin().select(sol);
+}
+
+__attribute__((visibility("hidden"))) void sort_by_llm_1(std::vector<int>& customers, const Instance& instance) {
+    plugin().sort(customers, instance);
+}
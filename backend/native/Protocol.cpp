@@ -0,0 +1,170 @@
+#include "Protocol.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+void decodeSolveRequest(ByteReader& reader, SolveRequest& request) {
+    request.requestId = reader.read<uint32_t>();
+    uint8_t problemType = reader.read<uint8_t>();
+    if (problemType > static_cast<uint8_t>(ProblemType::VRPTW)) {
+        throw std::runtime_error("unknown problem type");
+    }
+    request.config.seed = reader.read<uint32_t>();
+    request.config.timeBudgetMs = reader.read<uint32_t>();
+    request.progressIntervalMs = reader.read<uint32_t>();
+
+    Instance& instance = request.instance;
+    instance.type = static_cast<ProblemType>(problemType);
+    instance.vehicleCapacity = reader.read<int32_t>();
+    uint32_t numNodes = reader.read<uint32_t>();
+    if (numNodes == 0) {
+        throw std::runtime_error("instance without depot");
+    }
+
+    std::vector<float> x;
+    std::vector<float> y;
+    reader.readArray(x, numNodes);
+    reader.readArray(y, numNodes);
+    instance.nodePositions.resize(numNodes);
+    for (uint32_t i = 0; i < numNodes; ++i) {
+        instance.nodePositions[i] = {x[i], y[i]};
+    }
+    reader.readArray(instance.demand, numNodes);
+
+    if (instance.type == ProblemType::PCVRP) {
+        reader.readArray(instance.prizes, numNodes);
+    }
+    if (instance.type == ProblemType::VRPTW) {
+        reader.readArray(instance.startTW, numNodes);
+        reader.readArray(instance.endTW, numNodes);
+        reader.readArray(instance.serviceTime, numNodes);
+    }
+    instance.finalize();
+
+    if (reader.remaining() > 0) {
+        uint32_t numTours = reader.read<uint32_t>();
+        std::vector<std::vector<int>>& tours = request.config.initialTours;
+        for (uint32_t t = 0; t < numTours; ++t) {
+            tours.emplace_back();
+            reader.readArray(tours.back(), reader.read<uint32_t>());
+        }
+    }
+}
+
+void encodeResult(ByteWriter& writer, uint32_t requestId, const LNSResult& result) {
+    const Solution& best = result.best;
+    writer.write<uint8_t>(MSG_RESULT);
+    writer.write<uint32_t>(requestId);
+    writer.write<float>(best.objective());
+    writer.write<float>(best.totalCosts);
+    writer.write<uint32_t>(static_cast<uint32_t>(result.iterations));
+    writer.write<float>(static_cast<float>(result.elapsedMs));
+    writer.write<uint8_t>(result.cancelled ? 1 : 0);
+    writer.write<uint32_t>(static_cast<uint32_t>(best.tours.size()));
+    for (const Tour& tour : best.tours) {
+        writer.write<uint32_t>(static_cast<uint32_t>(tour.customers.size()));
+        writer.write<int32_t>(tour.demand);
+        writer.write<float>(tour.costs);
+        writer.write<float>(tourDistance(best.instance, tour.customers));
+        writer.writeArray(tour.customers.data(), tour.customers.size());
+    }
+}
+
+void captureProgress(ProgressEvent& event, uint32_t requestId, const Solution& best, uint64_t iteration, double elapsedMs) {
+    event.requestId = requestId;
+    event.iteration = iteration;
+    event.objective = best.objective();
+    event.elapsedMs = static_cast<float>(elapsedMs);
+    event.tourLengths.clear();
+    event.customers.clear();
+    for (const Tour& tour : best.tours) {
+        event.tourLengths.push_back(static_cast<uint32_t>(tour.customers.size()));
+        event.customers.insert(event.customers.end(), tour.customers.begin(), tour.customers.end());
+    }
+}
+
+void encodeProgress(ByteWriter& writer, const ProgressEvent& event, RouteDeltaState& state) {
+    if (state.requestId != event.requestId) {
+        state.requestId = event.requestId;
+        state.tours.clear();
+    }
+
+    writer.write<uint8_t>(MSG_PROGRESS);
+    writer.write<uint32_t>(event.requestId);
+    writer.write<float>(event.objective);
+    writer.write<uint32_t>(static_cast<uint32_t>(event.iteration));
+    writer.write<float>(event.elapsedMs);
+
+    size_t numTours = event.tourLengths.size();
+    // Index and start offset in event.customers of every tour that differs from what was sent last time
+    std::vector<std::pair<uint32_t, size_t>> changed;
+    size_t offset = 0;
+    for (size_t t = 0; t < numTours; ++t) {
+        const int* begin = event.customers.data() + offset;
+        size_t length = event.tourLengths[t];
+        if (t >= state.tours.size() || !std::equal(begin, begin + length, state.tours[t].begin(), state.tours[t].end())) {
+            changed.emplace_back(static_cast<uint32_t>(t), offset);
+        }
+        offset += length;
+    }
+    writer.writeVarint(static_cast<uint32_t>(numTours));
+    writer.writeVarint(static_cast<uint32_t>(changed.size()));
+
+    state.tours.resize(numTours);
+    for (const auto& [t, start] : changed) {
+        const int* begin = event.customers.data() + start;
+        size_t length = event.tourLengths[t];
+        std::vector<int>& old = state.tours[t];
+
+        size_t prefix = 0;
+        while (prefix < length && prefix < old.size() && begin[prefix] == old[prefix]) {
+            ++prefix;
+        }
+        size_t suffix = 0;
+        while (suffix < length - prefix && suffix < old.size() - prefix &&
+               begin[length - 1 - suffix] == old[old.size() - 1 - suffix]) {
+            ++suffix;
+        }
+
+        writer.writeVarint(t);
+        writer.writeVarint(static_cast<uint32_t>(prefix));
+        writer.writeVarint(static_cast<uint32_t>(suffix));
+        writer.writeVarint(static_cast<uint32_t>(length - prefix - suffix));
+        for (size_t i = prefix; i < length - suffix; ++i) {
+            writer.writeVarint(static_cast<uint32_t>(begin[i]));
+        }
+        old.assign(begin, begin + length);
+    }
+}
+
+void encodeError(ByteWriter& writer, uint32_t requestId, const std::string& message) {
+    writer.write<uint8_t>(MSG_ERROR);
+    writer.write<uint32_t>(requestId);
+    writer.writeString(message);
+}
+
+void encodeMetrics(ByteWriter& writer, uint32_t requestId, const MetricsSnapshot& snapshot) {
+    writer.write<uint8_t>(MSG_METRICS);
+    writer.write<uint32_t>(requestId);
+    writer.write<uint32_t>(snapshot.threads);
+    writer.write<uint64_t>(snapshot.iterations);
+    writer.write<uint64_t>(snapshot.accepted);
+    writer.write<uint64_t>(snapshot.improved);
+    writer.write<double>(snapshot.cyclesPerNs);
+    writer.write<uint8_t>(static_cast<uint8_t>(kNumLnsPhases));
+    for (int p = 0; p < kNumLnsPhases; ++p) {
+        writer.writeString(lnsPhaseName(static_cast<LnsPhase>(p)));
+        writer.write<uint64_t>(snapshot.phases[p].calls);
+        writer.write<uint64_t>(snapshot.phases[p].cycles);
+        writer.write<double>(snapshot.phases[p].ms);
+        writer.write<double>(snapshot.phases[p].p50Ns);
+        writer.write<double>(snapshot.phases[p].p99Ns);
+        writer.write<double>(snapshot.phases[p].p999Ns);
+    }
+    writer.write<uint32_t>(static_cast<uint32_t>(snapshot.operatorCounters.size()));
+    for (const auto& counter : snapshot.operatorCounters) {
+        writer.writeString(counter.first);
+        writer.write<uint64_t>(counter.second);
+    }
+}
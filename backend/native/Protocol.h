@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Instance.h"
+#include "LNS.h"
+#include "Metrics.h"
+#include "WireFormat.h"
+
+struct SolveRequest {
+    uint32_t requestId = 0;
+    uint32_t progressIntervalMs = 0; // 0 disables MSG_PROGRESS
+    Instance instance;
+    LNSConfig config;
+};
+
+// Snapshot of an improved best solution, handed from the solver thread to the publisher thread.
+struct ProgressEvent {
+    uint32_t requestId = 0;
+    uint64_t iteration = 0;
+    float objective = 0;
+    float elapsedMs = 0;
+    std::vector<uint32_t> tourLengths;
+    std::vector<int> customers; // All tours concatenated
+};
+
+void captureProgress(ProgressEvent& event, uint32_t requestId, const Solution& best, uint64_t iteration, double elapsedMs);
+
+// Payload layout of MSG_SOLVE (after the type byte):
+//   u32 requestId, u8 problemType, u32 seed, u32 timeBudgetMs, u32 progressIntervalMs, i32 vehicleCapacity, u32 numNodes,
+//   f32 x[numNodes], f32 y[numNodes], i32 demand[numNodes],
+//   PCVRP: f32 prizes[numNodes], VRPTW: f32 startTW[numNodes], f32 endTW[numNodes], f32 serviceTime[numNodes]
+//   optional warm start: u32 numTours, per tour: u32 length, u32 customers[length]
+void decodeSolveRequest(ByteReader& reader, SolveRequest& request);
+
+// Payload layout of MSG_RESULT:
+//   u8 type, u32 requestId, f32 objective, f32 totalCosts, u32 iterations, f32 elapsedMs, u8 cancelled, u32 numTours,
+//   per tour: u32 length, i32 demand, f32 costs, f32 distance, u32 customers[length]
+void encodeResult(ByteWriter& writer, uint32_t requestId, const LNSResult& result);
+
+// Tours last sent for a request; MSG_PROGRESS only carries the difference to them.
+struct RouteDeltaState {
+    uint32_t requestId = 0;
+    std::vector<std::vector<int>> tours;
+};
+
+// Payload layout of MSG_PROGRESS (everything after requestId is relayed verbatim to the browser):
+//   u8 type, u32 requestId, f32 objective, u32 iteration, f32 elapsedMs, varint numTours, varint numChangedTours,
+//   per changed tour: varint tourIndex, varint keepPrefix, varint keepSuffix, varint insertLength, varint customers[insertLength]
+// A changed tour becomes old[0, keepPrefix) + inserted + the last keepSuffix customers of old; tours past numTours are dropped.
+// The first event of a request diffs against no tours, so it carries the full solution.
+void encodeProgress(ByteWriter& writer, const ProgressEvent& event, RouteDeltaState& state);
+
+// Payload layout of MSG_CANCEL (Node -> worker): u8 type, u32 requestId.
+// The worker stops the matching run and answers with its usual MSG_RESULT.
+
+// MSG_METRICS request (Node -> worker): u8 type, u32 requestId. Answered at once, also while a solve runs.
+// Reply: u8 type, u32 requestId, u32 threads, u64 iterations, u64 accepted, u64 improved, f64 cyclesPerNs,
+//   u8 numPhases, per phase: string name, u64 calls, u64 cycles, f64 ms, f64 p50Ns, f64 p99Ns, f64 p999Ns,
+//   u32 numCounters, per counter: string name, u64 value (strings are u32 length + utf8)
+void encodeMetrics(ByteWriter& writer, uint32_t requestId, const MetricsSnapshot& snapshot);
+
+// Payload layout of MSG_ERROR: u8 type, u32 requestId, u32 length, utf8 message[length]
+void encodeError(ByteWriter& writer, uint32_t requestId, const std::string& message);
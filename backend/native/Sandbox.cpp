@@ -0,0 +1,301 @@
+#include "Sandbox.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/audit.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <sched.h>
+#include <sys/prctl.h>
+#endif
+
+namespace {
+
+// Exit codes the child reserves for the sandbox's own reports
+constexpr int kExitOutOfMemory = 120;
+constexpr int kExitSetupFailed = 121;
+
+using Clock = std::chrono::steady_clock;
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+
+#if defined(__x86_64__)
+constexpr uint32_t kAuditArch = AUDIT_ARCH_X86_64;
+#else
+constexpr uint32_t kAuditArch = AUDIT_ARCH_AARCH64;
+#endif
+
+class FilterBuilder {
+public:
+    void load(uint32_t offset) { code_.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offset)); }
+    void ret(uint32_t action) { code_.push_back(BPF_STMT(BPF_RET | BPF_K, action)); }
+    void jump(uint16_t op, uint32_t value, uint8_t ifTrue, uint8_t ifFalse) {
+        code_.push_back(BPF_JUMP(BPF_JMP | op | BPF_K, value, ifTrue, ifFalse));
+    }
+
+    // nr == syscall -> action
+    void onSyscall(long syscall, uint32_t action) {
+        jump(BPF_JEQ, static_cast<uint32_t>(syscall), 0, 1);
+        ret(action);
+    }
+
+    // nr == syscall -> (args[arg] & mask ? onMatch : onMiss); leaves the syscall number unloaded on a match
+    void onSyscallArg(long syscall, int arg, uint32_t mask, uint32_t onMatch, uint32_t onMiss) {
+        jump(BPF_JEQ, static_cast<uint32_t>(syscall), 0, 4);
+        load(offsetof(seccomp_data, args) + arg * sizeof(uint64_t)); // Low 32 bits on little-endian targets
+        jump(BPF_JSET, mask, 0, 1);
+        ret(onMatch);
+        ret(onMiss);
+    }
+
+    sock_fprog program() { return {static_cast<unsigned short>(code_.size()), code_.data()}; }
+
+private:
+    std::vector<sock_filter> code_;
+};
+
+bool installSyscallFilter() {
+    const uint32_t kill = SECCOMP_RET_KILL_PROCESS;
+    const uint32_t deny = SECCOMP_RET_ERRNO | EPERM;
+    const uint32_t allow = SECCOMP_RET_ALLOW;
+    const uint32_t writeFlags = O_WRONLY | O_RDWR | O_CREAT | O_TRUNC | O_APPEND;
+
+    FilterBuilder filter;
+    filter.load(offsetof(seccomp_data, arch));
+    filter.jump(BPF_JEQ, kAuditArch, 1, 0);
+    filter.ret(kill);
+    filter.load(offsetof(seccomp_data, nr));
+#if defined(__x86_64__)
+    filter.jump(BPF_JGE, 0x40000000, 0, 1); // x32 ABI
+    filter.ret(kill);
+#endif
+
+    // Threads only: clone without CLONE_THREAD would fork. clone3 hides its flags in memory, so glibc is
+    // told it does not exist and falls back to clone.
+    filter.onSyscall(SYS_clone3, SECCOMP_RET_ERRNO | ENOSYS);
+    filter.onSyscallArg(SYS_clone, 0, CLONE_THREAD, allow, kill);
+    for (long syscall : {SYS_execve, SYS_execveat, SYS_ptrace, SYS_process_vm_readv, SYS_process_vm_writev,
+                         SYS_socket, SYS_socketpair, SYS_connect, SYS_bind, SYS_listen, SYS_accept, SYS_accept4,
+                         SYS_mount, SYS_umount2, SYS_chroot, SYS_pivot_root, SYS_unshare, SYS_setns, SYS_reboot,
+                         SYS_kexec_load, SYS_init_module, SYS_finit_module, SYS_delete_module, SYS_bpf,
+                         SYS_perf_event_open, SYS_keyctl, SYS_add_key, SYS_request_key, SYS_setuid, SYS_setgid,
+                         SYS_setreuid, SYS_setregid, SYS_setresuid, SYS_setresgid}) {
+        filter.onSyscall(syscall, kill);
+    }
+#if defined(__x86_64__)
+    filter.onSyscall(SYS_fork, kill);
+    filter.onSyscall(SYS_vfork, kill);
+    filter.onSyscall(SYS_creat, deny);
+    filter.onSyscallArg(SYS_open, 1, writeFlags, deny, allow);
+    for (long syscall : {SYS_unlink, SYS_rename, SYS_mkdir, SYS_rmdir, SYS_link, SYS_symlink, SYS_chmod, SYS_chown}) {
+        filter.onSyscall(syscall, deny);
+    }
+#endif
+    filter.onSyscall(SYS_openat2, SECCOMP_RET_ERRNO | ENOSYS);
+    filter.onSyscallArg(SYS_openat, 2, writeFlags, deny, allow);
+    for (long syscall : {SYS_unlinkat, SYS_renameat, SYS_renameat2, SYS_mkdirat, SYS_linkat, SYS_symlinkat,
+                         SYS_truncate, SYS_fchmodat, SYS_fchownat}) {
+        filter.onSyscall(syscall, deny);
+    }
+    filter.ret(allow);
+
+    sock_fprog program = filter.program();
+    return prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) == 0 &&
+           prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &program) == 0;
+}
+
+#else
+
+bool installSyscallFilter() {
+    return false; // seccomp is Linux-only; the other limits still apply
+}
+
+#endif
+
+bool setLimit(int resource, rlim_t value) {
+    rlimit limit{value, value};
+    return setrlimit(resource, &limit) == 0;
+}
+
+[[noreturn]] void exitChild(int code) {
+    std::fflush(stdout);
+    std::fflush(stderr);
+    _exit(code);
+}
+
+[[noreturn]] void runChild(const SandboxLimits& limits, const std::function<int()>& body) {
+    setLimit(RLIMIT_CORE, 0);
+    if (limits.cpuSeconds > 0) {
+        // Soft limit raises SIGXCPU; the hard limit one second later kills a child that ignores it
+        rlimit cpu{static_cast<rlim_t>(limits.cpuSeconds + 0.999), static_cast<rlim_t>(limits.cpuSeconds + 1.999)};
+        if (setrlimit(RLIMIT_CPU, &cpu) != 0) {
+            std::fprintf(stderr, "sandbox: cannot limit CPU time: %s\n", std::strerror(errno));
+            exitChild(kExitSetupFailed);
+        }
+    }
+    if (limits.memoryBytes > 0 && !setLimit(RLIMIT_AS, static_cast<rlim_t>(limits.memoryBytes))) {
+        std::fprintf(stderr, "sandbox: cannot limit memory: %s\n", std::strerror(errno));
+        exitChild(kExitSetupFailed);
+    }
+#if defined(__linux__)
+    if (limits.filterSyscalls && !installSyscallFilter()) {
+        std::fprintf(stderr, "sandbox: cannot install the syscall filter: %s\n", std::strerror(errno));
+        exitChild(kExitSetupFailed);
+    }
+#endif
+
+    // bad_alloc escaping a noexcept function ends in std::terminate rather than in the catch below
+    std::set_terminate([] {
+        if (std::exception_ptr error = std::current_exception()) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::bad_alloc&) {
+                exitChild(kExitOutOfMemory);
+            } catch (...) {
+            }
+        }
+        std::abort();
+    });
+    try {
+        exitChild(body());
+    } catch (const std::bad_alloc&) {
+        exitChild(kExitOutOfMemory);
+    }
+}
+
+void classify(SandboxResult& result, int status, bool timedOut, const SandboxLimits& limits) {
+    if (timedOut) {
+        result.status = SandboxStatus::Timeout;
+        result.signal = SIGKILL;
+        result.detail = "killed by the watchdog after " + std::to_string(static_cast<long>(limits.wallMs)) + " ms";
+    } else if (WIFSIGNALED(status)) {
+        result.signal = WTERMSIG(status);
+        bool cpuExhausted = limits.cpuSeconds > 0 && result.cpuMs >= limits.cpuSeconds * 1000;
+        if (result.signal == SIGXCPU || (result.signal == SIGKILL && cpuExhausted)) {
+            result.status = SandboxStatus::CpuLimit;
+            result.detail = "exceeded the CPU time limit";
+        } else if (result.signal == SIGSYS) {
+            result.status = SandboxStatus::Violation;
+            result.detail = "made a forbidden system call";
+        } else {
+            result.status = SandboxStatus::Crashed;
+            result.detail = std::string("terminated by ") + strsignal(result.signal);
+        }
+    } else {
+        result.exitCode = WEXITSTATUS(status);
+        if (result.exitCode == 0) {
+            result.status = SandboxStatus::Ok;
+        } else if (result.exitCode == kExitOutOfMemory) {
+            result.status = SandboxStatus::OutOfMemory;
+            result.detail = "allocation failed under the memory limit";
+        } else if (result.exitCode == kExitSetupFailed) {
+            result.status = SandboxStatus::Failed;
+            result.detail = "the sandbox could not be set up";
+        } else {
+            result.status = SandboxStatus::Failed;
+            result.detail = "exit code " + std::to_string(result.exitCode);
+        }
+    }
+}
+
+void appendJsonString(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+}
+
+const char* sandboxStatusName(SandboxStatus status) {
+    switch (status) {
+    case SandboxStatus::Ok:
+        return "ok";
+    case SandboxStatus::Failed:
+        return "failed";
+    case SandboxStatus::Timeout:
+        return "timeout";
+    case SandboxStatus::CpuLimit:
+        return "cpu_limit";
+    case SandboxStatus::OutOfMemory:
+        return "out_of_memory";
+    case SandboxStatus::Crashed:
+        return "crashed";
+    default:
+        return "violation";
+    }
+}
+
+SandboxResult runSandboxed(const SandboxLimits& limits, const std::function<int()>& body) {
+    SandboxResult result;
+    std::fflush(stdout);
+    std::fflush(stderr);
+    Clock::time_point start = Clock::now();
+    pid_t child = fork();
+    if (child < 0) {
+        result.status = SandboxStatus::Failed;
+        result.detail = std::string("fork failed: ") + std::strerror(errno);
+        return result;
+    }
+    if (child == 0) {
+        runChild(limits, body);
+    }
+
+    // Watchdog: poll for the child's exit so that a child stuck in an operator call cannot stall the caller
+    int status = 0;
+    rusage usage{};
+    bool timedOut = false;
+    for (;;) {
+        pid_t done = wait4(child, &status, WNOHANG, &usage);
+        if (done == child || (done < 0 && errno != EINTR)) {
+            break;
+        }
+        double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (!timedOut && limits.wallMs > 0 && elapsedMs > limits.wallMs) {
+            kill(child, SIGKILL);
+            timedOut = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    result.wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    result.cpuMs = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e3 +
+                   (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e3;
+    result.maxRssKb = usage.ru_maxrss;
+    classify(result, status, timedOut, limits);
+    return result;
+}
+
+std::string sandboxResultJson(const SandboxResult& result) {
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "{\"status\":\"%s\",\"exitCode\":%d,\"signal\":%d,\"wallMs\":%.6g,\"cpuMs\":%.6g,\"maxRssKb\":%ld,\"detail\":",
+                  sandboxStatusName(result.status), result.exitCode, result.signal, result.wallMs, result.cpuMs,
+                  result.maxRssKb);
+    std::string out = buffer;
+    appendJsonString(out, result.detail);
+    out += '}';
+    return out;
+}
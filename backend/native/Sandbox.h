@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+// Runs untrusted code (a generated heuristic) in a forked child under resource limits:
+//   wallMs        watchdog in the parent, SIGKILLs the child once it runs longer
+//   cpuSeconds    RLIMIT_CPU, the kernel stops the child with SIGXCPU
+//   memoryBytes   RLIMIT_AS; an allocation past it throws std::bad_alloc, reported as OutOfMemory
+//   filterSyscalls  seccomp filter (Linux): no exec, fork, sockets, ptrace, mounts or privilege changes
+//                 (SIGSYS, reported as Violation); creating, writing or deleting files fails with EPERM
+// The child inherits stdout and stderr, so whatever it prints goes straight to the caller.
+
+struct SandboxLimits {
+    double wallMs = 0; // 0 = no limit
+    double cpuSeconds = 0;
+    size_t memoryBytes = 0;
+    bool filterSyscalls = true;
+};
+
+enum class SandboxStatus {
+    Ok, // Exit code 0
+    Failed, // Any other exit code, or the sandbox could not be set up
+    Timeout,
+    CpuLimit,
+    OutOfMemory,
+    Crashed, // Killed by a signal, e.g. SIGSEGV or SIGABRT
+    Violation // A filtered syscall
+};
+
+const char* sandboxStatusName(SandboxStatus status);
+
+struct SandboxResult {
+    SandboxStatus status = SandboxStatus::Ok;
+    int exitCode = 0;
+    int signal = 0;
+    double wallMs = 0;
+    double cpuMs = 0;
+    long maxRssKb = 0;
+    std::string detail; // Human-readable cause for anything but Ok
+};
+
+// Forks, applies the limits in the child and runs body there, whose return value becomes the exit code.
+// Blocks until the child exits or is killed. stdout is flushed before forking and in the child before it exits.
+SandboxResult runSandboxed(const SandboxLimits& limits, const std::function<int()>& body);
+
+// {"status":"timeout","exitCode":0,"signal":9,"wallMs":..,"cpuMs":..,"maxRssKb":..,"detail":".."}
+std::string sandboxResultJson(const SandboxResult& result);
@@ -0,0 +1,289 @@
+#include "Solution.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace {
+
+// Undo entry of a change to tour tourIdx, before the change
+SolutionJournal::Entry journalEntry(const Solution& sol, SolutionJournal::Op op, int customer, int tourIdx, int pos,
+                                    float tourCosts) {
+    return {op, customer, tourIdx, pos, tourCosts, sol.totalCosts, sol.travelCosts, sol.uncollectedPrizes};
+}
+
+}
+
+Solution::Solution(const Instance& instance)
+    : instance(instance),
+      customerToTourMap(static_cast<size_t>(instance.numNodes), -1) {
+    if (instance.type == ProblemType::PCVRP) {
+        // Summed again in double: the float total_prizes is off by more than the objective's own rounding
+        for (int c = 1; c < instance.numNodes; ++c) {
+            uncollectedPrizes += instance.prizes[c];
+        }
+    }
+}
+
+void SolutionChanges::touchTour(int tourIdx) {
+    size_t t = static_cast<size_t>(tourIdx);
+    if (t >= tourMarked_.size()) {
+        tourMarked_.resize(t + 1, 0);
+    }
+    if (!tourMarked_[t]) {
+        tourMarked_[t] = 1;
+        tours.push_back(tourIdx);
+    }
+}
+
+void SolutionChanges::clear() {
+    for (int t : tours) {
+        tourMarked_[static_cast<size_t>(t)] = 0;
+    }
+    tours.clear();
+    customers.clear();
+}
+
+Solution::Solution(const Solution& other)
+    : instance(other.instance),
+      totalCosts(other.totalCosts),
+      tours(other.tours),
+      customerToTourMap(other.customerToTourMap),
+      travelCosts(other.travelCosts),
+      uncollectedPrizes(other.uncollectedPrizes) {}
+
+Solution& Solution::operator=(const Solution& other) {
+    assert(&instance == &other.instance);
+    totalCosts = other.totalCosts;
+    tours = other.tours;
+    customerToTourMap = other.customerToTourMap;
+    travelCosts = other.travelCosts;
+    uncollectedPrizes = other.uncollectedPrizes;
+    return *this;
+}
+
+float Solution::objective() const {
+    if (instance.type == ProblemType::PCVRP) {
+        return static_cast<float>(travelCosts + uncollectedPrizes);
+    }
+    return totalCosts;
+}
+
+void Solution::insertCustomer(int customer, int tourIdx, int pos) {
+    if (tourIdx == static_cast<int>(tours.size())) {
+        tours.emplace_back();
+        if (journal) {
+            journal->entries.push_back(journalEntry(*this, SolutionJournal::Op::OpenTour, 0, tourIdx, 0, 0));
+        }
+    }
+    Tour& tour = tours[static_cast<size_t>(tourIdx)];
+    if (journal) {
+        journal->entries.push_back(journalEntry(*this, SolutionJournal::Op::Insert, customer, tourIdx, pos, tour.costs));
+    }
+    const auto& dist = instance.distanceMatrix;
+    int prev = pos > 0 ? tour.customers[static_cast<size_t>(pos - 1)] : 0;
+    int next = pos < static_cast<int>(tour.customers.size()) ? tour.customers[static_cast<size_t>(pos)] : 0;
+    double distance = static_cast<double>(dist[prev][customer]) + dist[customer][next] - dist[prev][next];
+    float delta = static_cast<float>(distance);
+    if (instance.type == ProblemType::PCVRP) {
+        delta = static_cast<float>(instance.prizes[customer] - distance);
+        uncollectedPrizes -= instance.prizes[customer];
+    }
+
+    tour.customers.insert(tour.customers.begin() + pos, customer);
+    tour.demand += instance.demand[customer];
+    tour.costs += delta;
+    totalCosts += delta;
+    travelCosts += distance;
+    customerToTourMap[customer] = tourIdx;
+    if (changes) {
+        changes->touchTour(tourIdx);
+        changes->customers.push_back(customer);
+    }
+}
+
+void Solution::removeCustomer(int customer) {
+    int tourIdx = customerToTourMap[customer];
+    if (tourIdx < 0) {
+        return;
+    }
+    Tour& tour = tours[static_cast<size_t>(tourIdx)];
+    int pos = positionInTour(customer);
+    if (journal) {
+        journal->entries.push_back(journalEntry(*this, SolutionJournal::Op::Remove, customer, tourIdx, pos, tour.costs));
+    }
+    const auto& dist = instance.distanceMatrix;
+    int prev = pos > 0 ? tour.customers[static_cast<size_t>(pos - 1)] : 0;
+    int next = pos + 1 < static_cast<int>(tour.customers.size()) ? tour.customers[static_cast<size_t>(pos + 1)] : 0;
+    double distance = static_cast<double>(dist[prev][next]) - dist[prev][customer] - dist[customer][next];
+    float delta = static_cast<float>(distance);
+    if (instance.type == ProblemType::PCVRP) {
+        delta = static_cast<float>(-instance.prizes[customer] - distance);
+        uncollectedPrizes += instance.prizes[customer];
+    }
+
+    tour.customers.erase(tour.customers.begin() + pos);
+    tour.demand -= instance.demand[customer];
+    tour.costs += delta;
+    totalCosts += delta;
+    travelCosts += distance;
+    customerToTourMap[customer] = -1;
+    if (changes) {
+        changes->touchTour(tourIdx);
+        changes->customers.push_back(customer);
+    }
+}
+
+void Solution::removeEmptyTours() {
+    size_t firstClosed = journal ? journal->entries.size() : 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < tours.size(); ++i) {
+        if (tours[i].customers.empty()) {
+            if (journal) {
+                journal->entries.push_back(
+                    journalEntry(*this, SolutionJournal::Op::CloseTour, 0, static_cast<int>(i), 0, tours[i].costs));
+            }
+            continue;
+        }
+        if (kept != i) {
+            tours[kept] = std::move(tours[i]);
+            for (int c : tours[kept].customers) {
+                customerToTourMap[c] = static_cast<int>(kept);
+            }
+            if (changes) {
+                changes->touchTour(static_cast<int>(kept));
+                changes->customers.insert(changes->customers.end(), tours[kept].customers.begin(),
+                                          tours[kept].customers.end());
+            }
+        }
+        ++kept;
+    }
+    if (changes) {
+        for (size_t i = kept; i < tours.size(); ++i) {
+            changes->touchTour(static_cast<int>(i));
+        }
+    }
+    if (journal) {
+        // As if the empty tours were erased one by one from the highest original index down, which leaves
+        // the lower indices valid: undoing backwards then reinserts them in ascending order
+        std::reverse(journal->entries.begin() + static_cast<std::ptrdiff_t>(firstClosed), journal->entries.end());
+    }
+    tours.resize(kept);
+}
+
+int Solution::positionInTour(int customer) const {
+    int tourIdx = customerToTourMap[customer];
+    if (tourIdx < 0) {
+        return -1;
+    }
+    const std::vector<int>& customers = tours[static_cast<size_t>(tourIdx)].customers;
+    auto it = std::find(customers.begin(), customers.end(), customer);
+    return it == customers.end() ? -1 : static_cast<int>(it - customers.begin());
+}
+
+void Solution::recomputeCosts() {
+    totalCosts = 0;
+    travelCosts = 0;
+    if (changes) {
+        for (size_t t = 0; t < tours.size(); ++t) {
+            changes->touchTour(static_cast<int>(t));
+        }
+    }
+    for (Tour& tour : tours) {
+        tour.demand = 0;
+        float distance = tourDistance(instance, tour.customers);
+        tour.costs = -distance;
+        for (int c : tour.customers) {
+            tour.demand += instance.demand[c];
+            if (instance.type == ProblemType::PCVRP) {
+                tour.costs += instance.prizes[c];
+            }
+        }
+        if (instance.type != ProblemType::PCVRP) {
+            tour.costs = -tour.costs;
+        }
+        totalCosts += tour.costs;
+        travelCosts += distance;
+    }
+    uncollectedPrizes = 0;
+    if (instance.type == ProblemType::PCVRP) {
+        for (int c = 1; c < instance.numNodes; ++c) {
+            if (customerToTourMap[c] == -1) {
+                uncollectedPrizes += instance.prizes[c];
+            }
+        }
+    }
+}
+
+float tourDistance(const Instance& instance, const std::vector<int>& customers) {
+    float distance = 0;
+    int prev = 0;
+    for (int c : customers) {
+        distance += instance.distanceMatrix[prev][c];
+        prev = c;
+    }
+    return distance + instance.distanceMatrix[prev][0];
+}
+
+void syncChanges(Solution& target, const Solution& source, const SolutionChanges& changes) {
+    assert(&target.instance == &source.instance);
+    target.tours.resize(source.tours.size());
+    for (int t : changes.tours) {
+        if (static_cast<size_t>(t) < source.tours.size()) {
+            target.tours[static_cast<size_t>(t)] = source.tours[static_cast<size_t>(t)];
+        }
+    }
+    for (int c : changes.customers) {
+        target.customerToTourMap[static_cast<size_t>(c)] = source.customerToTourMap[static_cast<size_t>(c)];
+    }
+    target.totalCosts = source.totalCosts;
+    target.travelCosts = source.travelCosts;
+    target.uncollectedPrizes = source.uncollectedPrizes;
+}
+
+void undoJournal(Solution& sol, SolutionJournal& journal) {
+    const Instance& instance = sol.instance;
+    // Reopened tours shift the ones behind them; their customers are renumbered once at the end
+    size_t renumberFrom = sol.tours.size();
+    for (auto it = journal.entries.rbegin(); it != journal.entries.rend(); ++it) {
+        const SolutionJournal::Entry& entry = *it;
+        size_t t = static_cast<size_t>(entry.tourIdx);
+        switch (entry.op) {
+        case SolutionJournal::Op::OpenTour:
+            sol.tours.pop_back();
+            break;
+        case SolutionJournal::Op::Insert: {
+            Tour& tour = sol.tours[t];
+            tour.customers.erase(tour.customers.begin() + entry.pos);
+            tour.demand -= instance.demand[entry.customer];
+            tour.costs = entry.tourCosts;
+            sol.customerToTourMap[entry.customer] = -1;
+            break;
+        }
+        case SolutionJournal::Op::Remove: {
+            Tour& tour = sol.tours[t];
+            tour.customers.insert(tour.customers.begin() + entry.pos, entry.customer);
+            tour.demand += instance.demand[entry.customer];
+            tour.costs = entry.tourCosts;
+            sol.customerToTourMap[entry.customer] = entry.tourIdx;
+            break;
+        }
+        case SolutionJournal::Op::CloseTour: {
+            Tour reopened;
+            reopened.costs = entry.tourCosts;
+            sol.tours.insert(sol.tours.begin() + entry.tourIdx, std::move(reopened));
+            renumberFrom = std::min(renumberFrom, t);
+            break;
+        }
+        }
+        sol.totalCosts = entry.totalCosts;
+        sol.travelCosts = entry.travelCosts;
+        sol.uncollectedPrizes = entry.uncollectedPrizes;
+    }
+    for (size_t t = renumberFrom; t < sol.tours.size(); ++t) {
+        for (int c : sol.tours[t].customers) {
+            sol.customerToTourMap[c] = static_cast<int>(t);
+        }
+    }
+    journal.clear();
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Instance.h"
+
+struct Tour {
+    std::vector<int> customers; // Customers in the tour, excluding depot
+    int demand = 0; // Total demand of the tour
+    float costs = 0; // Travel costs of the tour (PCVRP: collected prizes minus the travel costs of the tour)
+};
+
+// Tours and customers a Solution changed since clear(), recorded by its mutation primitives while
+// Solution::changes points here. A candidate that mirrors another solution can then be committed to it or
+// rolled back from it by copying only what changed (syncChanges), however many tours there are.
+struct SolutionChanges {
+    std::vector<int> tours; // Changed tour indices, each once; after removeEmptyTours some lie past the end
+    std::vector<int> customers; // Customers whose customerToTourMap entry changed, possibly repeated
+
+    void touchTour(int tourIdx);
+    void clear();
+
+private:
+    std::vector<char> tourMarked_;
+};
+
+// Undo log of the mutation primitives, appended to while Solution::journal points here. Every entry keeps
+// the tour costs and the solution's running sums from before its change, so undoJournal restores them bit
+// for bit instead of subtracting float deltas again. Rolling back costs O(entries), however large the
+// solution.
+struct SolutionJournal {
+    enum class Op : uint8_t {
+        OpenTour, // insertCustomer appended a tour
+        Insert,
+        Remove,
+        CloseTour // removeEmptyTours erased an empty tour; recorded from the highest index down
+    };
+    struct Entry {
+        Op op;
+        int customer;
+        int tourIdx;
+        int pos;
+        float tourCosts;
+        float totalCosts;
+        double travelCosts;
+        double uncollectedPrizes;
+    };
+
+    std::vector<Entry> entries;
+
+    void clear() { entries.clear(); }
+};
+
+struct Solution {
+    const Instance& instance; // Reference to the instance to avoid copying
+    float totalCosts = 0; // Sum of all tour costs (PCVRP: sum of all collected prizes minus the travel costs)
+    std::vector<Tour> tours; // List of tours in the solution
+    std::vector<int> customerToTourMap; // Map from each customer to its tour index, -1 if not served
+    // Some operators redeclare the fields above, so keep their order and append new fields below.
+    // The objective's terms, summed in double: unlike the float totalCosts they do not drift over millions of
+    // primitive calls, and the PCVRP objective does not cancel the collected prizes against their total
+    double travelCosts = 0; // Travel distance of all tours
+    double uncollectedPrizes = 0; // PCVRP: prizes of the customers no tour serves, total_prizes when empty
+    SolutionChanges* changes = nullptr; // Records the changes if set; never copied, a copy records nothing
+    SolutionJournal* journal = nullptr; // Records undo entries if set; never copied either
+
+    explicit Solution(const Instance& instance);
+    Solution(const Solution& other);
+    Solution& operator=(const Solution& other);
+
+    // Value the driver minimises, in O(1). For PCVRP this is travel costs plus the prizes left uncollected.
+    float objective() const;
+
+    // Inserts customer before position pos of tour tourIdx. tourIdx == tours.size() opens a new tour.
+    void insertCustomer(int customer, int tourIdx, int pos);
+    // Takes a served customer out of its tour; the tour stays in place even if it becomes empty.
+    void removeCustomer(int customer);
+    // Drops empty tours and renumbers customerToTourMap.
+    void removeEmptyTours();
+
+    int positionInTour(int customer) const;
+    // Recomputes demand and costs of every tour and the running sums from scratch. Not journaled.
+    void recomputeCosts();
+};
+
+// Makes target equal to source, provided the two differed only in what changes recorded.
+void syncChanges(Solution& target, const Solution& source, const SolutionChanges& changes);
+
+// Reverts sol to its state when the journal was last cleared and clears it.
+void undoJournal(Solution& sol, SolutionJournal& journal);
+
+// Travel distance of depot -> customers -> depot.
+float tourDistance(const Instance& instance, const std::vector<int>& customers);
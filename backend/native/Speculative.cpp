@@ -0,0 +1,344 @@
+#include "Speculative.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LocalSearch.h"
+#include "Trace.h"
+#include "Utils.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// One thread's candidate of the current batch
+struct Slot {
+    LnsWorkspace* workspace = nullptr; // Owned by the thread, set before its first batch
+    bool produced = false;
+    std::vector<int> touched; // Incumbent tours the candidate changed or dropped
+    std::vector<int> changed; // Candidate tours that are not an unchanged incumbent tour
+    std::vector<char> kept; // Scratch: incumbent tours found unchanged in the candidate
+};
+
+// Splits the candidate into the incumbent tours it left alone and the ones it replaced.
+// Tours keep their customer sequence or get a new one, so an unchanged tour is found through its first customer.
+void diffTours(const Solution& incumbent, const Solution& candidate, Slot& slot) {
+    slot.kept.assign(incumbent.tours.size(), 0);
+    slot.touched.clear();
+    slot.changed.clear();
+    for (size_t t = 0; t < candidate.tours.size(); ++t) {
+        const std::vector<int>& customers = candidate.tours[t].customers;
+        int source = customers.empty() ? -1 : incumbent.customerToTourMap[customers[0]];
+        if (source >= 0 && incumbent.tours[source].customers == customers) {
+            slot.kept[source] = 1;
+        } else {
+            slot.changed.push_back(static_cast<int>(t));
+        }
+    }
+    for (size_t t = 0; t < incumbent.tours.size(); ++t) {
+        if (!slot.kept[t]) {
+            slot.touched.push_back(static_cast<int>(t));
+        }
+    }
+}
+
+class SpeculativeRun {
+public:
+    SpeculativeRun(const Instance& instance, const SpeculativeConfig& config, int numThreads)
+        : instance_(instance), config_(config), slots_(static_cast<size_t>(numThreads)), incumbent_(instance),
+          acceptance_(config.lns.acceptance, acceptanceSeed(config.lns.seed)),
+          customerUsed_(static_cast<size_t>(instance.numNodes), 0) {}
+
+    SpeculativeResult run() {
+        start_ = Clock::now();
+        seedRandomGenerators(config_.lns.seed);
+        incumbent_ = config_.lns.initialTours.empty() ? constructInitialSolution(instance_)
+                                                      : solutionFromTours(instance_, config_.lns.initialTours);
+        if (config_.lns.localSearch) {
+            LocalSearch(instance_).improve(incumbent_);
+        }
+        acceptance_.start(incumbent_.objective(), instance_.numCustomers);
+        SpeculativeResult result{incumbent_};
+        if (instance_.numCustomers == 0) {
+            result.elapsedMs = elapsedMs();
+            return result;
+        }
+        if (config_.lns.onImprovement) {
+            config_.lns.onImprovement(result.best, 0, elapsedMs());
+        }
+
+        for (int i = 1; i < static_cast<int>(slots_.size()); ++i) {
+            threads_.emplace_back(&SpeculativeRun::workerLoop, this, i);
+        }
+        LnsWorkspace workspace(instance_);
+        std::unique_ptr<LocalSearch> localSearch = makeLocalSearch();
+        workspace.localSearch = localSearch.get();
+        slots_[0].workspace = &workspace;
+
+        uint64_t numThreads = slots_.size();
+        while (result.iterations < config_.lns.maxIterations) {
+            double elapsed = elapsedMs();
+            if (elapsed >= config_.lns.timeBudgetMs) {
+                break;
+            }
+            acceptance_.setProgress(runProgress(config_.lns, elapsed, result.iterations));
+            if (config_.lns.cancelled && config_.lns.cancelled->load(std::memory_order_relaxed)) {
+                result.cancelled = true;
+                break;
+            }
+            ++result.batches;
+            if (workspace.trace) {
+                workspace.trace->beginIteration(result.batches, workspace.clock.last());
+            }
+            batchSize_ = static_cast<int>(std::min(numThreads, config_.lns.maxIterations - result.iterations));
+            runBatch();
+            result.iterations += static_cast<uint64_t>(batchSize_);
+
+            bool changed = commit(result);
+            workspace.clock.lap(LnsPhase::Accept);
+            if (changed && incumbent_.objective() < result.best.objective()) {
+                result.best = incumbent_;
+                bumpCounter(workspace.metrics.improved);
+                if (config_.lns.onImprovement) {
+                    TraceSpan span("improve", result.batches);
+                    config_.lns.onImprovement(result.best, result.iterations, elapsedMs());
+                }
+            }
+            workspace.clock.lap(LnsPhase::Bookkeeping);
+            if (workspace.trace) {
+                workspace.trace->endIteration(workspace.clock.last());
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        startBatch_.notify_all();
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+        result.best.recomputeCosts();
+        result.elapsedMs = elapsedMs();
+        return result;
+    }
+
+private:
+    double elapsedMs() const { return std::chrono::duration<double, std::milli>(Clock::now() - start_).count(); }
+
+    // One per thread, like the workspace
+    std::unique_ptr<LocalSearch> makeLocalSearch() const {
+        return config_.lns.localSearch ? std::make_unique<LocalSearch>(instance_) : nullptr;
+    }
+
+    void produce(int index) {
+        Slot& slot = slots_[index];
+        slot.produced = index < batchSize_;
+        if (slot.produced) {
+            ruinAndRecreate(incumbent_, config_.lns.operators, *slot.workspace);
+            if (config_.mergeDisjoint && slots_.size() > 1) {
+                diffTours(incumbent_, slot.workspace->candidate, slot);
+            }
+        }
+    }
+
+    void runBatch() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_ = static_cast<int>(threads_.size());
+            ++batch_;
+        }
+        startBatch_.notify_all();
+        produce(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        batchDone_.wait(lock, [this] { return pending_ == 0; });
+        slots_[0].workspace->clock.skip();
+    }
+
+    void workerLoop(int index) {
+        seedRandomGenerators(config_.lns.seed + static_cast<uint32_t>(index));
+        setTraceThreadName("speculative " + std::to_string(index));
+        LnsWorkspace workspace(instance_);
+        std::unique_ptr<LocalSearch> localSearch = makeLocalSearch();
+        workspace.localSearch = localSearch.get();
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        slots_[index].workspace = &workspace;
+        for (;;) {
+            startBatch_.wait(lock, [&] { return batch_ != seen || stop_; });
+            if (stop_) {
+                return;
+            }
+            seen = batch_;
+            lock.unlock();
+            workspace.clock.skip();
+            if (workspace.trace) {
+                workspace.trace->beginIteration(seen, workspace.clock.last());
+            }
+            produce(index);
+            if (workspace.trace) {
+                workspace.trace->endIteration(workspace.clock.last());
+            }
+            lock.lock();
+            if (--pending_ == 0) {
+                batchDone_.notify_one();
+            }
+        }
+    }
+
+    // Commits the best candidate of the batch if the acceptance criterion keeps it, then merges the other
+    // improving candidates whose tours are disjoint from everything committed so far. Returns whether the
+    // incumbent changed.
+    bool commit(SpeculativeResult& result) {
+        order_.clear();
+        for (int i = 0; i < static_cast<int>(slots_.size()); ++i) {
+            if (slots_[i].produced) {
+                order_.push_back(i);
+            }
+        }
+        auto objectiveOf = [this](int i) { return slots_[i].workspace->candidate.objective(); };
+        std::stable_sort(order_.begin(), order_.end(), [&](int a, int b) { return objectiveOf(a) < objectiveOf(b); });
+        float incumbentObjective = incumbent_.objective();
+        if (order_.empty() || !acceptance_.accept(incumbentObjective, objectiveOf(order_[0]) - incumbentObjective)) {
+            for (int i : order_) {
+                syncChanges(slots_[i].workspace->candidate, incumbent_, slots_[i].workspace->changes);
+            }
+            return false;
+        }
+        ++result.committed;
+        bumpCounter(slots_[0].workspace->metrics.accepted);
+
+        merged_.assign(1, order_[0]);
+        if (config_.mergeDisjoint && order_.size() > 1) {
+            tourUsed_.assign(incumbent_.tours.size(), 0);
+            std::fill(customerUsed_.begin(), customerUsed_.end(), 0);
+            claim(slots_[order_[0]]);
+            for (size_t k = 1; k < order_.size() && objectiveOf(order_[k]) < incumbentObjective; ++k) {
+                Slot& slot = slots_[order_[k]];
+                if (disjoint(slot)) {
+                    claim(slot);
+                    merged_.push_back(order_[k]);
+                }
+            }
+        }
+
+        if (merged_.size() == 1) {
+            // Every candidate mirrors the incumbent again after copying its own changes and the winner's back
+            const LnsWorkspace& winner = *slots_[merged_[0]].workspace;
+            syncChanges(incumbent_, winner.candidate, winner.changes);
+            for (Slot& slot : slots_) {
+                if (slot.workspace == &winner) {
+                    continue;
+                }
+                if (slot.produced) {
+                    syncChanges(slot.workspace->candidate, incumbent_, slot.workspace->changes);
+                }
+                syncChanges(slot.workspace->candidate, incumbent_, winner.changes);
+            }
+            return true;
+        }
+
+        // Untouched incumbent tours in order, then the changed tours of every merged candidate
+        result.merged += merged_.size() - 1;
+        for (Slot& slot : slots_) {
+            slot.workspace->mirrored = nullptr;
+        }
+        tours_.clear();
+        float totalCosts = incumbent_.totalCosts;
+        double travelCosts = incumbent_.travelCosts;
+        double uncollectedPrizes = incumbent_.uncollectedPrizes;
+        for (size_t t = 0; t < incumbent_.tours.size(); ++t) {
+            if (!tourUsed_[t]) {
+                tours_.push_back(std::move(incumbent_.tours[t]));
+            }
+        }
+        for (int index : merged_) {
+            Solution& candidate = slots_[index].workspace->candidate;
+            for (int t : slots_[index].changed) {
+                tours_.push_back(std::move(candidate.tours[t]));
+            }
+            totalCosts += candidate.totalCosts - incumbent_.totalCosts;
+            travelCosts += candidate.travelCosts - incumbent_.travelCosts;
+            uncollectedPrizes += candidate.uncollectedPrizes - incumbent_.uncollectedPrizes;
+        }
+        std::swap(incumbent_.tours, tours_);
+        incumbent_.totalCosts = totalCosts;
+        incumbent_.travelCosts = travelCosts;
+        incumbent_.uncollectedPrizes = uncollectedPrizes;
+        std::fill(incumbent_.customerToTourMap.begin(), incumbent_.customerToTourMap.end(), -1);
+        for (size_t t = 0; t < incumbent_.tours.size(); ++t) {
+            for (int c : incumbent_.tours[t].customers) {
+                incumbent_.customerToTourMap[c] = static_cast<int>(t);
+            }
+        }
+        return true;
+    }
+
+    bool disjoint(const Slot& slot) const {
+        for (int t : slot.touched) {
+            if (tourUsed_[t]) {
+                return false;
+            }
+        }
+        // Tours are disjoint, so only customers the incumbent left unserved (PCVRP) can collide
+        const Solution& candidate = slot.workspace->candidate;
+        for (int t : slot.changed) {
+            for (int c : candidate.tours[t].customers) {
+                if (customerUsed_[c]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void claim(const Slot& slot) {
+        for (int t : slot.touched) {
+            tourUsed_[t] = 1;
+        }
+        const Solution& candidate = slot.workspace->candidate;
+        for (int t : slot.changed) {
+            for (int c : candidate.tours[t].customers) {
+                customerUsed_[c] = 1;
+            }
+        }
+    }
+
+    const Instance& instance_;
+    const SpeculativeConfig& config_;
+    Clock::time_point start_;
+    std::vector<Slot> slots_;
+    std::vector<std::thread> threads_;
+    Solution incumbent_; // Read by every thread during a batch, written only between batches
+    Acceptance acceptance_; // Decides on the best candidate of each batch
+
+    std::mutex mutex_;
+    std::condition_variable startBatch_;
+    std::condition_variable batchDone_;
+    uint64_t batch_ = 0;
+    int batchSize_ = 0; // Threads past it sit the batch out
+    int pending_ = 0;
+    bool stop_ = false;
+
+    // Commit scratch
+    std::vector<int> order_;
+    std::vector<int> merged_;
+    std::vector<char> tourUsed_;
+    std::vector<char> customerUsed_;
+    std::vector<Tour> tours_;
+};
+
+}
+
+SpeculativeResult runSpeculativeLNS(const Instance& instance, const SpeculativeConfig& config) {
+    int numThreads = config.numThreads > 0 ? config.numThreads
+                                           : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    SpeculativeRun run(instance, config, numThreads);
+    return run.run();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "LNS.h"
+
+// Speculative batch LNS: every batch, each of numThreads threads runs ruinAndRecreate on the same
+// incumbent with its own random stream, so all threads work on one solution instead of on independent
+// restarts. The best candidate is committed if the acceptance criterion keeps it, as in lnsIteration
+// (greedy: if it is not worse). Other improving candidates whose changes touch tours that no committed
+// candidate touched are merged into it as well: tour costs are independent, so their gains add up.
+//
+// Thread i draws from seed + i, the acceptance on the calling thread from acceptanceSeed(seed), and candidates
+// are ranked by objective, then by thread, so runs stopped by an iteration limit are reproducible for a given
+// thread count.
+
+struct SpeculativeConfig {
+    int numThreads = 0; // 0 = one per hardware thread
+    bool mergeDisjoint = true; // Merge improving candidates on disjoint tours into the committed one
+    // Operators, budget, iteration limit (counting every candidate), seed, onImprovement (called on the
+    // calling thread), cancellation and warm start
+    LNSConfig lns;
+};
+
+struct SpeculativeResult {
+    Solution best;
+    uint64_t iterations = 0; // Candidates evaluated
+    double elapsedMs = 0;
+    bool cancelled = false;
+    uint64_t batches = 0;
+    uint64_t committed = 0; // Batches whose best candidate replaced the incumbent
+    uint64_t merged = 0; // Further candidates merged into a committed one
+};
+
+SpeculativeResult runSpeculativeLNS(const Instance& instance, const SpeculativeConfig& config);
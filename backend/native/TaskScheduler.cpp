@@ -0,0 +1,155 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// How long an idle worker keeps polling for the next loop before it sleeps
+constexpr auto kSpinTime = std::chrono::microseconds(200);
+// Failed steal attempts within a loop before a thread parks until a range is pushed or the loop completes
+constexpr int kStealAttempts = 32;
+
+}
+
+TaskScheduler::TaskScheduler(int numThreads) {
+    int threads = std::max(1, numThreads);
+    for (int i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 1; i < threads; ++i) {
+        workers_.emplace_back(&TaskScheduler::workerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_.store(true, std::memory_order_release);
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void TaskScheduler::run(size_t count, size_t grain, Kernel kernel, void* context) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(1, grain);
+    if (workers_.empty() || count <= grain) {
+        kernel(context, 0, count);
+        return;
+    }
+
+    kernel_ = kernel;
+    context_ = context;
+    grain_ = grain;
+    remaining_.store(count, std::memory_order_release);
+    // Sequentially consistent with the sleeper's increment and check below, so one of the two sides sees the other
+    generation_.fetch_add(1);
+    if (sleeping_.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        wake_.notify_all();
+    }
+
+    execute(0, {0, count});
+    drain(0);
+}
+
+// Runs ranges of the current loop until all of its indices have run, parking while there is nothing to take
+void TaskScheduler::drain(int self) {
+    Range range;
+    int misses = 0;
+    while (remaining_.load(std::memory_order_acquire) > 0) {
+        // Read before looking at the deques, so that a push after a failed look changes it
+        uint64_t epoch = workEpoch_.load();
+        if (popOrSteal(self, range)) {
+            execute(self, range);
+            misses = 0;
+        } else if (++misses < kStealAttempts) {
+            std::this_thread::yield();
+        } else {
+            std::unique_lock<std::mutex> lock(workMutex_);
+            // Sequentially consistent with signalWork's increment and check, like sleeping_ in run
+            idle_.fetch_add(1);
+            workReady_.wait(lock, [&] { return workEpoch_.load() != epoch || remaining_.load() == 0; });
+            idle_.fetch_sub(1);
+            misses = 0;
+        }
+    }
+}
+
+// Wakes the threads parked in drain: a range was pushed or the loop completed
+void TaskScheduler::signalWork() {
+    workEpoch_.fetch_add(1);
+    if (idle_.load() > 0) {
+        std::lock_guard<std::mutex> lock(workMutex_);
+        workReady_.notify_all();
+    }
+}
+
+void TaskScheduler::execute(int self, Range range) {
+    Queue& own = *queues_[self];
+    // Keep the lower half, offer the upper half to thieves
+    while (range.end - range.begin > grain_) {
+        size_t middle = range.begin + (range.end - range.begin) / 2;
+        {
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.ranges.push_back({middle, range.end});
+        }
+        signalWork();
+        range.end = middle;
+    }
+    kernel_(context_, range.begin, range.end);
+    size_t length = range.end - range.begin;
+    if (remaining_.fetch_sub(length, std::memory_order_acq_rel) == length) {
+        signalWork();
+    }
+}
+
+bool TaskScheduler::popOrSteal(int self, Range& range) {
+    {
+        Queue& own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.ranges.empty()) {
+            range = own.ranges.back();
+            own.ranges.pop_back();
+            return true;
+        }
+    }
+    int numQueues = static_cast<int>(queues_.size());
+    for (int k = 1; k < numQueues; ++k) {
+        Queue& victim = *queues_[(self + k) % numQueues];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.ranges.empty()) {
+            range = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::workerLoop(int self) {
+    uint64_t seen = 0;
+    for (;;) {
+        auto spinUntil = std::chrono::steady_clock::now() + kSpinTime;
+        while (generation_.load(std::memory_order_acquire) == seen && !stop_.load(std::memory_order_acquire) &&
+               std::chrono::steady_clock::now() < spinUntil) {
+            std::this_thread::yield();
+        }
+        if (generation_.load(std::memory_order_acquire) == seen && !stop_.load(std::memory_order_acquire)) {
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+            sleeping_.fetch_add(1);
+            wake_.wait(lock, [&] { return generation_.load() != seen || stop_.load(std::memory_order_acquire); });
+            sleeping_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        if (stop_.load(std::memory_order_acquire)) {
+            return;
+        }
+        seen = generation_.load(std::memory_order_acquire);
+        drain(self);
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Work-stealing fork-join scheduler for data-parallel loops inside one LNS iteration, e.g. the cheapest
+// insertion scan over the tours of a huge instance (LNS.cpp). Every thread owns a deque of index ranges:
+// it splits its range in halves, pushing the upper halves to the back of its own deque and working on the
+// lower half, and pops from the back when done. Idle threads steal from the front of other deques, where
+// the largest ranges are. The calling thread takes part, so numThreads counts it.
+//
+// Workers spin briefly between loops, since repair issues one loop per reinserted customer, then sleep.
+// Within a loop, a thread that finds no range to take after a few attempts parks until one is pushed or
+// the loop completes, rather than burning a core that the other threads could use.
+// parallelFor must be called from one thread at a time; results a body writes to per-index slots are
+// merged by the caller in index order, which keeps them independent of the scheduling.
+
+class TaskScheduler {
+public:
+    explicit TaskScheduler(int numThreads);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    int numThreads() const { return static_cast<int>(queues_.size()); }
+
+    // Calls body(begin, end) on disjoint ranges covering [0, count), each at most grain long, and returns
+    // when all have run.
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, Body&& body) {
+        using Callable = typename std::remove_reference<Body>::type;
+        run(count, grain, [](void* context, size_t begin, size_t end) { (*static_cast<Callable*>(context))(begin, end); },
+            &body);
+    }
+
+private:
+    using Kernel = void (*)(void* context, size_t begin, size_t end);
+
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    void run(size_t count, size_t grain, Kernel kernel, void* context);
+    void workerLoop(int self);
+    bool popOrSteal(int self, Range& range);
+    void execute(int self, Range range);
+    void drain(int self);
+    void signalWork();
+
+    std::vector<std::unique_ptr<Queue>> queues_; // Index 0 belongs to the calling thread
+    std::vector<std::thread> workers_;
+
+    // Current loop; written before its first range is pushed, read after a range is taken
+    Kernel kernel_ = nullptr;
+    void* context_ = nullptr;
+    size_t grain_ = 1;
+    std::atomic<size_t> remaining_{0}; // Indices not run yet
+    std::atomic<uint64_t> generation_{0}; // Loops started
+
+    std::atomic<bool> stop_{false};
+    std::atomic<int> sleeping_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+
+    // Threads with nothing to take within a loop park here until a range is pushed or the loop completes
+    std::atomic<uint64_t> workEpoch_{0}; // Pushes and completed loops
+    std::atomic<int> idle_{0};
+    std::mutex workMutex_;
+    std::condition_variable workReady_;
+};
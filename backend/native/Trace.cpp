@@ -0,0 +1,210 @@
+#include "Trace.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+struct RegisteredTrace {
+    std::unique_ptr<ThreadTrace> trace;
+    bool exited = false; // Its thread has ended; the events stay until the next clearTrace
+};
+
+std::mutex registryMutex;
+std::vector<RegisteredTrace> threadTraces;
+// Rings of exited threads, emptied by clearTrace and handed to the next new thread, so a long-lived process
+// holds at most as many rings as it ever ran traced threads at once
+std::vector<std::unique_ptr<ThreadTrace>> freeTraces;
+uint32_t nextTid = 1;
+TraceOptions traceOptions;
+std::atomic<uint64_t> traceStartCycles{0};
+std::atomic<uint64_t> traceGeneration{0}; // Bumped by clearTrace
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void appendJsonString(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+}
+
+ThreadTrace::ThreadTrace(uint32_t tid, size_t capacity)
+    : tid_(tid), ring_(roundUpToPowerOfTwo(capacity)), generation_(traceGeneration.load()) {}
+
+void ThreadTrace::record(const char* name, uint64_t begin, uint64_t end, uint64_t arg) {
+    uint64_t generation = traceGeneration.load(std::memory_order_relaxed);
+    if (generation_.load(std::memory_order_relaxed) != generation) {
+        // Only this thread writes its ring: empty it, then publish the generation it now belongs to
+        written_.store(0, std::memory_order_relaxed);
+        generation_.store(generation, std::memory_order_release);
+    }
+    uint64_t n = written_.load(std::memory_order_relaxed);
+    ring_[n & (ring_.size() - 1)] = {name, begin, end, arg};
+    written_.store(n + 1, std::memory_order_release);
+}
+
+void ThreadTrace::beginIteration(uint64_t iteration, uint64_t now) {
+    iteration_ = iteration;
+    iterationBegin_ = now;
+    numStaged_ = 0;
+}
+
+void ThreadTrace::span(const char* name, uint64_t begin, uint64_t end) {
+    if (numStaged_ < kMaxStaged) {
+        staged_[numStaged_++] = {name, begin, end, 0};
+    }
+}
+
+void ThreadTrace::endIteration(uint64_t now) {
+    double cycles = static_cast<double>(now - iterationBegin_);
+    bool tail = meanIterationCycles_ > 0 && cycles > traceOptions.tailFactor * meanIterationCycles_;
+    // Running mean over roughly the last 64 iterations
+    meanIterationCycles_ = meanIterationCycles_ > 0 ? meanIterationCycles_ + (cycles - meanIterationCycles_) / 64 : cycles;
+
+    if (tail || iteration_ % traceOptions.sampleEvery == 0) {
+        record(tail ? "iteration (tail)" : "iteration", iterationBegin_, now, iteration_);
+        for (size_t i = 0; i < numStaged_; ++i) {
+            record(staged_[i].name, staged_[i].begin, staged_[i].end, iteration_);
+        }
+    }
+    numStaged_ = 0;
+}
+
+void enableTracing(const TraceOptions& options) {
+    traceOptions = options;
+    if (traceOptions.sampleEvery == 0) {
+        traceOptions.sampleEvery = 1;
+    }
+    traceStartCycles.store(readCycleCounter());
+    tracingFlag().store(true);
+}
+
+namespace {
+
+// Registers a ring for the calling thread and marks it exited when the thread ends
+struct ThreadTraceOwner {
+    ThreadTrace* trace;
+
+    ThreadTraceOwner() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        RegisteredTrace registered;
+        if (freeTraces.empty()) {
+            registered.trace = std::make_unique<ThreadTrace>(nextTid++, traceOptions.eventsPerThread);
+        } else {
+            registered.trace = std::move(freeTraces.back());
+            freeTraces.pop_back();
+        }
+        trace = registered.trace.get();
+        threadTraces.push_back(std::move(registered));
+    }
+
+    ~ThreadTraceOwner() {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (RegisteredTrace& registered : threadTraces) {
+            if (registered.trace.get() == trace) {
+                registered.exited = true;
+            }
+        }
+    }
+};
+
+}
+
+ThreadTrace& threadTrace() {
+    thread_local ThreadTraceOwner owner;
+    return *owner.trace;
+}
+
+void setTraceThreadName(const std::string& name) {
+    if (tracingEnabled()) {
+        threadTrace().setName(name);
+    }
+}
+
+std::string chromeTraceJson() {
+    double cyclesPerUs = cyclesPerNs() * 1000;
+    uint64_t start = traceStartCycles.load();
+    int pid = static_cast<int>(getpid());
+    char buffer[256];
+
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t generation = traceGeneration.load();
+    for (const RegisteredTrace& registered : threadTraces) {
+        const ThreadTrace* trace = registered.trace.get();
+        if (!trace->name_.empty()) {
+            std::snprintf(buffer, sizeof(buffer), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":",
+                          first ? "" : ",", pid, trace->tid_);
+            out += buffer;
+            appendJsonString(out, trace->name_);
+            out += "}}";
+            first = false;
+        }
+        // Events from before the last clearTrace that the thread has not dropped yet
+        if (trace->generation_.load(std::memory_order_acquire) != generation) {
+            continue;
+        }
+        uint64_t written = trace->written_.load(std::memory_order_acquire);
+        uint64_t capacity = trace->ring_.size();
+        for (uint64_t n = written > capacity ? written - capacity : 0; n < written; ++n) {
+            const TraceEvent& event = trace->ring_[n & (capacity - 1)];
+            if (event.begin < start) {
+                continue;
+            }
+            std::snprintf(buffer, sizeof(buffer),
+                          "%s{\"name\":\"%s\",\"cat\":\"lns\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u,\"args\":{\"id\":%llu}}",
+                          first ? "" : ",", event.name, static_cast<double>(event.begin - start) / cyclesPerUs,
+                          static_cast<double>(event.end - event.begin) / cyclesPerUs, pid, trace->tid_,
+                          static_cast<unsigned long long>(event.arg));
+            out += buffer;
+            first = false;
+        }
+    }
+    out += "]}\n";
+    return out;
+}
+
+bool writeChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    file << chromeTraceJson();
+    return static_cast<bool>(file);
+}
+
+void clearTrace() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t generation = traceGeneration.fetch_add(1) + 1;
+    std::vector<RegisteredTrace> running;
+    for (RegisteredTrace& registered : threadTraces) {
+        // Running threads may be inside record; they empty their own rings when they see the new generation
+        if (registered.exited) {
+            ThreadTrace& trace = *registered.trace;
+            trace.written_.store(0);
+            trace.generation_.store(generation);
+            trace.name_.clear();
+            trace.numStaged_ = 0;
+            trace.meanIterationCycles_ = 0;
+            freeTraces.push_back(std::move(registered.trace));
+        } else {
+            running.push_back(std::move(registered));
+        }
+    }
+    threadTraces = std::move(running);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CycleClock.h"
+
+// Timeline of solver runs in Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+// Every thread records complete events (name, begin and end cycle count) into its own ring buffer, which
+// keeps the most recent eventsPerThread events. Disabled tracing costs one well-predicted branch per event.
+//
+// Recording the spans of every LNS iteration would be dominated by memory traffic, so iterations are
+// decimated: their spans are staged and only kept for every sampleEvery-th iteration and for tail
+// iterations, those slower than tailFactor times the thread's running mean. Rare events (improvements,
+// progress publication, hand-offs between threads) are always kept.
+
+struct TraceOptions {
+    uint32_t sampleEvery = 64;
+    double tailFactor = 4;
+    size_t eventsPerThread = size_t(1) << 16;
+};
+
+struct TraceEvent {
+    const char* name; // String literal, shared by all events of the kind
+    uint64_t begin;
+    uint64_t end;
+    uint64_t arg; // Iteration or request id, shown as args.id
+};
+
+class ThreadTrace {
+public:
+    ThreadTrace(uint32_t tid, size_t capacity);
+
+    // Appends to the ring, overwriting the oldest event when full. The first record after a clearTrace empties the
+    // ring first.
+    void record(const char* name, uint64_t begin, uint64_t end, uint64_t arg = 0);
+
+    // Iteration staging: spans between beginIteration and endIteration are kept or dropped together.
+    void beginIteration(uint64_t iteration, uint64_t now);
+    void span(const char* name, uint64_t begin, uint64_t end);
+    void endIteration(uint64_t now);
+
+    void setName(const std::string& name) { name_ = name; }
+
+private:
+    friend std::string chromeTraceJson();
+    friend void clearTrace();
+
+    static constexpr size_t kMaxStaged = 16;
+
+    uint32_t tid_;
+    std::string name_;
+    std::vector<TraceEvent> ring_;
+    std::atomic<uint64_t> written_{0}; // Events ever recorded; the ring holds the last min(written, capacity)
+    std::atomic<uint64_t> generation_; // clearTrace calls the events belong to; older rings count as empty
+    TraceEvent staged_[kMaxStaged];
+    size_t numStaged_ = 0;
+    uint64_t iteration_ = 0;
+    uint64_t iterationBegin_ = 0;
+    double meanIterationCycles_ = 0;
+};
+
+// Turns tracing on for the whole process; threads allocate their ring on first use.
+void enableTracing(const TraceOptions& options = TraceOptions());
+
+inline std::atomic<bool>& tracingFlag() {
+    static std::atomic<bool> enabled{false};
+    return enabled;
+}
+
+inline bool tracingEnabled() {
+    return tracingFlag().load(std::memory_order_relaxed);
+}
+
+// Ring of the calling thread. Only valid while tracing is enabled. Its events outlive the thread until the
+// next clearTrace.
+ThreadTrace& threadTrace();
+
+// Names the calling thread in the trace (thread_name metadata); a no-op while tracing is disabled.
+void setTraceThreadName(const std::string& name);
+
+// Records its lifetime as one event if tracing is enabled, independent of the iteration sampling.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, uint64_t arg = 0)
+        : trace_(tracingEnabled() ? &threadTrace() : nullptr), name_(name), arg_(arg),
+          begin_(trace_ ? readCycleCounter() : 0) {}
+
+    ~TraceSpan() {
+        if (trace_) {
+            trace_->record(name_, begin_, readCycleCounter(), arg_);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    ThreadTrace* trace_;
+    const char* name_;
+    uint64_t arg_;
+    uint64_t begin_;
+};
+
+// All threads' events as Chrome trace JSON, timestamps in microseconds since tracing was enabled.
+// Meant to be called while the traced threads are idle; events overwritten meanwhile may come out torn.
+std::string chromeTraceJson();
+bool writeChromeTrace(const std::string& path);
+
+// Drops the recorded events of all threads, e.g. between two solves. The rings of threads that have exited are
+// emptied and recycled for threads started later. A running thread empties its own ring on its next record,
+// since it may be recording right now; until then its old events are left out of chromeTraceJson.
+void clearTrace();
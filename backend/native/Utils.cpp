@@ -0,0 +1,74 @@
+#include "Utils.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace {
+
+thread_local std::mt19937 generator(std::random_device{}());
+thread_local uint32_t fastState = std::random_device{}() | 1u;
+
+}
+
+int getRandomNumber(int min, int max) {
+    if (max <= min) {
+        return min;
+    }
+    std::uniform_int_distribution<int> distribution(min, max);
+    return distribution(generator);
+}
+
+float getRandomFraction(float min, float max) {
+    std::uniform_real_distribution<float> distribution(min, max);
+    return distribution(generator);
+}
+
+float getRandomFractionFast() {
+    fastState ^= fastState << 13;
+    fastState ^= fastState >> 17;
+    fastState ^= fastState << 5;
+    return static_cast<float>(fastState >> 8) * (1.0f / 16777216.0f);
+}
+
+void seedRandomGenerators(uint32_t seed) {
+    generator.seed(seed);
+    fastState = seed * 2654435761u | 1u;
+}
+
+std::vector<int> argsort(const std::vector<float>& values) {
+    std::vector<int> indices(values.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(), indices.end(), [&values](int a, int b) { return values[a] < values[b]; });
+    return indices;
+}
+
+UniqueSampler::UniqueSampler(int min, int max) : min_(min), size_(max >= min ? max - min + 1 : 0) {}
+
+int UniqueSampler::valueAt(int position) const {
+    auto it = swapped_.find(position);
+    return it == swapped_.end() ? position : it->second;
+}
+
+int UniqueSampler::next() {
+    if (empty()) {
+        return min_ - 1;
+    }
+    int position = getRandomNumber(drawn_, size_ - 1);
+    int value = valueAt(position);
+    // Position drawn_ is never read again, so only the other side of the swap is stored
+    swapped_[position] = valueAt(drawn_);
+    swapped_.erase(drawn_);
+    ++drawn_;
+    return min_ + value;
+}
+
+std::vector<int> sampleWithoutReplacement(int min, int max, int k) {
+    UniqueSampler sampler(min, max);
+    std::vector<int> values;
+    values.reserve(static_cast<size_t>(std::max(0, std::min(k, sampler.remaining()))));
+    while (static_cast<int>(values.size()) < k && !sampler.empty()) {
+        values.push_back(sampler.next());
+    }
+    return values;
+}
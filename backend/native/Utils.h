@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Random helpers used by the generated operators. Every thread owns its generators.
+int getRandomNumber(int min, int max); // Uniform integer in [min, max]
+float getRandomFraction(float min = 0.0, float max = 1.0); // Uniform float in [min, max)
+float getRandomFractionFast(); // Uniform float in [0, 1) from a cheap xorshift generator
+
+// Reseeds the generators of the calling thread, making a run reproducible.
+void seedRandomGenerators(uint32_t seed);
+
+// Indices that would sort values in ascending order.
+std::vector<int> argsort(const std::vector<float>& values);
+
+// Draws distinct integers from [min, max] in random order, O(1) per draw however many are taken:
+// a Fisher-Yates shuffle that only stores the positions it has swapped. Use it instead of rejection loops like
+//   do { c = getRandomNumber(1, n); } while (selected.count(c));
+// which spin for ever once every value is taken and degrade long before.
+class UniqueSampler {
+public:
+    UniqueSampler(int min, int max);
+
+    bool empty() const { return drawn_ >= size_; }
+    int remaining() const { return size_ - drawn_; }
+    int next(); // A value not drawn before, or min - 1 once empty
+
+private:
+    int valueAt(int position) const;
+
+    int min_;
+    int size_;
+    int drawn_ = 0;
+    std::unordered_map<int, int> swapped_; // position -> value offset, for positions that differ from the identity
+};
+
+// k distinct integers from [min, max] in random order; the whole range, shuffled, if k exceeds it.
+std::vector<int> sampleWithoutReplacement(int min, int max, int k);
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Little-endian framing shared with backend/solver/protocol.js.
+// Every message on the pipe is a uint32 payload length followed by the payload; the first payload byte is the MessageType.
+enum MessageType : uint8_t {
+    MSG_SOLVE = 1,
+    MSG_RESULT = 2,
+    MSG_ERROR = 3,
+    MSG_PROGRESS = 4,
+    MSG_CANCEL = 5,
+    MSG_METRICS = 6
+};
+
+class ByteReader {
+public:
+    ByteReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    T read() {
+        T value;
+        take(&value, sizeof(T));
+        return value;
+    }
+
+    // Unsigned LEB128
+    uint32_t readVarint() {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t byte = read<uint8_t>();
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw std::runtime_error("malformed varint");
+    }
+
+    // count comes off the wire: it is checked against the bytes left before anything is allocated
+    template <typename T>
+    void readArray(std::vector<T>& out, size_t count) {
+        if (count > remaining() / sizeof(T)) {
+            throw std::runtime_error("truncated message");
+        }
+        out.resize(count);
+        if (count > 0) {
+            take(out.data(), count * sizeof(T));
+        }
+    }
+
+    size_t remaining() const { return size_ - offset_; }
+
+private:
+    void take(void* out, size_t bytes) {
+        if (bytes > size_ - offset_) {
+            throw std::runtime_error("truncated message");
+        }
+        std::memcpy(out, data_ + offset_, bytes);
+        offset_ += bytes;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+class ByteWriter {
+public:
+    template <typename T>
+    void write(T value) {
+        append(&value, sizeof(T));
+    }
+
+    // Unsigned LEB128: ids below 128 take one byte, below 16384 two
+    void writeVarint(uint32_t value) {
+        while (value >= 0x80) {
+            write<uint8_t>(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        write<uint8_t>(static_cast<uint8_t>(value));
+    }
+
+    template <typename T>
+    void writeArray(const T* values, size_t count) {
+        append(values, count * sizeof(T));
+    }
+
+    void writeString(const std::string& value) {
+        write<uint32_t>(static_cast<uint32_t>(value.size()));
+        append(value.data(), value.size());
+    }
+
+    const std::vector<uint8_t>& bytes() const { return bytes_; }
+
+private:
+    void append(const void* data, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        bytes_.insert(bytes_.end(), p, p + size);
+    }
+
+    std::vector<uint8_t> bytes_;
+};
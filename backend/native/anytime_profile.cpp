@@ -0,0 +1,327 @@
+// Anytime profiling driver: runs one heuristic's LNS on a set of instances and seeds and records the
+// best objective over wall time. backend/profile-anytime.js builds it per heuristic and turns the curves
+// into primal-integral metrics.
+//
+// Prints one JSON object per run and line:
+//   {"instance":"clustered","numCustomers":1000,"seed":1,"iterations":..,"elapsedMs":..,
+//    "timesMs":[..],"objectives":[..]}
+// timesMs/objectives is the best-objective step function: the initial solution, then every improvement.
+// After the runs follows one line with the LNS phase totals of all of them (Metrics.h):
+//   {"metrics":{"select":{"calls":..,"ms":..,"p50Ns":..,"p99Ns":..,"p999Ns":..},"sort":{..},..}}
+//
+// Options:
+//   --type=cvrp|pcvrp|vrptw       problem variant the heuristic was evolved for (required)
+//   --sizes=100,1000              synthetic instance sizes
+//   --families=uniform,clustered  synthetic instance families
+//   --instance=<file.vrp>         CVRPLIB instance, repeatable
+//   --seeds=1,2,3                 LNS seeds; every instance is run once per seed
+//   --budget-ms=2000              wall-clock budget per run
+//   --max-iterations=<n>          also stop after n iterations; with a generous --budget-ms the run is
+//                                 deterministic per seed, independent of machine load (evaluate-generation.js)
+//   --repair-threads=1            threads of the insertion scan (TaskScheduler.h); same results for any count
+//   --speculative=<n>             speculative batch LNS with n threads (Speculative.h) instead of runLNS;
+//                                 run lines then also carry "batches", "committed" and "merged"
+//   --no-merge                    speculative batches commit only their best candidate
+//   --local-search                polish the initial solution and every repaired candidate (LocalSearch.h)
+//   --acceptance=greedy|sa|rrt|lahc  acceptance criterion (Acceptance.h)
+//   --temperature=0.1,0.002       start and end temperature of sa, per customer of the initial objective
+//   --deviation=0.003,0           start and end deviation of rrt, relative to the best objective
+//   --lahc-length=100             history length of lahc
+//   --instance-seed=<n>           seed of the synthetic instances and prizes/windows of files
+//   --trace=<file.json>           also write a Chrome trace of all runs (Trace.h)
+//   --trace-sample=64             keep the spans of every n-th iteration (plus tail iterations)
+//   --sandbox                     run the heuristic in a forked child under the limits below (Sandbox.h) and
+//                                 finish with a line {"sandbox":{"status":"ok|timeout|cpu_limit|..",..}}
+//   --wall-ms=<n>                 sandbox watchdog: kill the child after n ms
+//   --cpu-seconds=<n>             sandbox CPU time limit
+//   --memory-mb=2048              sandbox address space limit
+//   --no-syscall-filter           sandbox without the seccomp filter
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "InstanceFactory.h"
+#include "LNS.h"
+#include "Metrics.h"
+#include "Sandbox.h"
+#include "Speculative.h"
+#include "Trace.h"
+
+namespace {
+
+struct Options {
+    ProblemType type = ProblemType::CVRP;
+    bool typeGiven = false;
+    std::vector<int> sizes{100, 1000};
+    std::vector<std::string> families{"uniform", "clustered"};
+    std::vector<std::string> files;
+    std::vector<uint32_t> seeds{1, 2, 3};
+    double budgetMs = 2000;
+    uint64_t maxIterations = UINT64_MAX;
+    int repairThreads = 1;
+    int speculativeThreads = 0;
+    bool mergeDisjoint = true;
+    bool localSearch = false;
+    AcceptanceConfig acceptance;
+    uint32_t instanceSeed = 1;
+    std::string tracePath;
+    uint32_t traceSample = 64;
+    bool sandbox = false;
+    SandboxLimits limits;
+};
+
+struct InstanceSpec {
+    std::string name;
+    std::function<Instance()> build;
+};
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// "start,end", or one value for both
+std::pair<double, double> parseRange(const std::string& value) {
+    std::vector<std::string> items = splitList(value);
+    if (items.empty() || items.size() > 2) {
+        throw std::runtime_error("expected start,end instead of " + value);
+    }
+    return {std::stod(items.front()), std::stod(items.back())};
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    options.limits.memoryBytes = size_t(2048) << 20;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg](const char* prefix) -> const char* {
+            size_t length = std::char_traits<char>::length(prefix);
+            return arg.compare(0, length, prefix) == 0 ? arg.c_str() + length : nullptr;
+        };
+        if (const char* v = value("--type=")) {
+            options.type = parseProblemType(v);
+            options.typeGiven = true;
+        } else if (const char* v = value("--sizes=")) {
+            options.sizes.clear();
+            for (const std::string& size : splitList(v)) {
+                options.sizes.push_back(std::stoi(size));
+            }
+        } else if (const char* v = value("--families=")) {
+            options.families = splitList(v);
+        } else if (const char* v = value("--instance=")) {
+            options.files.push_back(v);
+        } else if (const char* v = value("--seeds=")) {
+            options.seeds.clear();
+            for (const std::string& seed : splitList(v)) {
+                options.seeds.push_back(static_cast<uint32_t>(std::stoul(seed)));
+            }
+        } else if (const char* v = value("--budget-ms=")) {
+            options.budgetMs = std::stod(v);
+        } else if (const char* v = value("--max-iterations=")) {
+            options.maxIterations = std::stoull(v);
+        } else if (const char* v = value("--repair-threads=")) {
+            options.repairThreads = std::stoi(v);
+        } else if (const char* v = value("--speculative=")) {
+            options.speculativeThreads = std::stoi(v);
+        } else if (arg == "--no-merge") {
+            options.mergeDisjoint = false;
+        } else if (arg == "--local-search") {
+            options.localSearch = true;
+        } else if (const char* v = value("--acceptance=")) {
+            options.acceptance.kind = parseAcceptanceKind(v);
+        } else if (const char* v = value("--temperature=")) {
+            std::tie(options.acceptance.startTemperature, options.acceptance.endTemperature) = parseRange(v);
+        } else if (const char* v = value("--deviation=")) {
+            std::tie(options.acceptance.startDeviation, options.acceptance.endDeviation) = parseRange(v);
+        } else if (const char* v = value("--lahc-length=")) {
+            options.acceptance.lateAcceptanceLength = std::stoi(v);
+        } else if (const char* v = value("--instance-seed=")) {
+            options.instanceSeed = static_cast<uint32_t>(std::stoul(v));
+        } else if (const char* v = value("--trace=")) {
+            options.tracePath = v;
+        } else if (const char* v = value("--trace-sample=")) {
+            options.traceSample = static_cast<uint32_t>(std::stoul(v));
+        } else if (arg == "--sandbox") {
+            options.sandbox = true;
+        } else if (const char* v = value("--wall-ms=")) {
+            options.limits.wallMs = std::stod(v);
+        } else if (const char* v = value("--cpu-seconds=")) {
+            options.limits.cpuSeconds = std::stod(v);
+        } else if (const char* v = value("--memory-mb=")) {
+            options.limits.memoryBytes = static_cast<size_t>(std::stoull(v)) << 20;
+        } else if (arg == "--no-syscall-filter") {
+            options.limits.filterSyscalls = false;
+        } else {
+            throw std::runtime_error("unknown option " + arg);
+        }
+    }
+    if (!options.typeGiven) {
+        throw std::runtime_error("--type=cvrp|pcvrp|vrptw is required");
+    }
+    return options;
+}
+
+std::vector<InstanceSpec> instanceSpecs(const Options& options) {
+    std::vector<InstanceSpec> specs;
+    for (const std::string& family : options.families) {
+        if (family != "uniform" && family != "clustered") {
+            throw std::runtime_error("unknown family " + family);
+        }
+        InstanceFamily kind = family == "uniform" ? InstanceFamily::Uniform : InstanceFamily::Clustered;
+        for (int size : options.sizes) {
+            specs.push_back({family, [=] { return generateInstance(options.type, kind, size, options.instanceSeed); }});
+        }
+    }
+    for (const std::string& path : options.files) {
+        std::string stem = path.substr(path.find_last_of('/') + 1);
+        stem = stem.substr(0, stem.find('.'));
+        specs.push_back({"file:" + stem, [=] { return loadInstanceFile(path, options.type, options.instanceSeed); }});
+    }
+    return specs;
+}
+
+void printSeries(const char* key, const std::vector<double>& values) {
+    std::printf("\"%s\":[", key);
+    for (size_t i = 0; i < values.size(); ++i) {
+        std::printf(i ? ",%.9g" : "%.9g", values[i]);
+    }
+    std::printf("]");
+}
+
+// Runs every instance and seed; everything that executes heuristic code happens in here, so that --sandbox
+// can move it into the child as a whole
+int profileRuns(const Options& options, const std::vector<InstanceSpec>& specs, std::ofstream* traceFile) {
+    for (const InstanceSpec& spec : specs) {
+        Instance instance;
+        try {
+            instance = spec.build();
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "anytime_profile: %s\n", e.what());
+            return 2;
+        }
+        for (uint32_t seed : options.seeds) {
+            std::vector<double> timesMs;
+            std::vector<double> objectives;
+            LNSConfig config;
+            config.timeBudgetMs = options.budgetMs;
+            config.maxIterations = options.maxIterations;
+            config.seed = seed;
+            config.repairThreads = options.repairThreads;
+            config.localSearch = options.localSearch;
+            config.acceptance = options.acceptance;
+            config.onImprovement = [&](const Solution& best, uint64_t, double elapsedMs) {
+                timesMs.push_back(elapsedMs);
+                objectives.push_back(best.objective());
+            };
+            uint64_t iterations = 0;
+            double elapsedMs = 0;
+            float objective = 0;
+            char speculativeStats[128] = "";
+            if (options.speculativeThreads > 0) {
+                SpeculativeConfig speculative;
+                speculative.numThreads = options.speculativeThreads;
+                speculative.mergeDisjoint = options.mergeDisjoint;
+                speculative.lns = config;
+                SpeculativeResult result = runSpeculativeLNS(instance, speculative);
+                iterations = result.iterations;
+                elapsedMs = result.elapsedMs;
+                objective = result.best.objective();
+                std::snprintf(speculativeStats, sizeof(speculativeStats), "\"batches\":%llu,\"committed\":%llu,\"merged\":%llu,",
+                              static_cast<unsigned long long>(result.batches),
+                              static_cast<unsigned long long>(result.committed),
+                              static_cast<unsigned long long>(result.merged));
+            } else {
+                LNSResult result = runLNS(instance, config);
+                iterations = result.iterations;
+                elapsedMs = result.elapsedMs;
+                objective = result.best.objective();
+            }
+            // The final costs are recomputed exactly; replace the drifted incremental value of the last step
+            if (!objectives.empty()) {
+                objectives.back() = objective;
+            }
+
+            std::printf("{\"instance\":\"%s\",\"numCustomers\":%d,\"seed\":%u,\"iterations\":%llu,\"elapsedMs\":%.9g,%s",
+                        spec.name.c_str(), instance.numCustomers, seed, static_cast<unsigned long long>(iterations),
+                        elapsedMs, speculativeStats);
+            printSeries("timesMs", timesMs);
+            std::printf(",");
+            printSeries("objectives", objectives);
+            std::printf("}\n");
+            std::fflush(stdout);
+        }
+    }
+
+    MetricsSnapshot metrics = snapshotMetrics();
+    std::printf("{\"metrics\":{");
+    for (int p = 0; p < kNumLnsPhases; ++p) {
+        const PhaseTotals& phase = metrics.phases[p];
+        std::printf("%s\"%s\":{\"calls\":%llu,\"ms\":%.6g,\"p50Ns\":%.6g,\"p99Ns\":%.6g,\"p999Ns\":%.6g}", p ? "," : "",
+                    lnsPhaseName(static_cast<LnsPhase>(p)), static_cast<unsigned long long>(phase.calls), phase.ms,
+                    phase.p50Ns, phase.p99Ns, phase.p999Ns);
+    }
+    std::printf("}}\n");
+    std::fflush(stdout);
+
+    if (traceFile) {
+        *traceFile << chromeTraceJson();
+        traceFile->flush();
+        if (!*traceFile) {
+            std::fprintf(stderr, "anytime_profile: cannot write %s\n", options.tracePath.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<InstanceSpec> specs;
+    try {
+        options = parseOptions(argc, argv);
+        specs = instanceSpecs(options);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "anytime_profile: %s\n", e.what());
+        return 2;
+    }
+
+    // Opened here because the sandboxed child may not create files; it inherits the descriptor
+    std::ofstream traceFile;
+    if (!options.tracePath.empty()) {
+        traceFile.open(options.tracePath);
+        if (!traceFile) {
+            std::fprintf(stderr, "anytime_profile: cannot write %s\n", options.tracePath.c_str());
+            return 1;
+        }
+        TraceOptions traceOptions;
+        traceOptions.sampleEvery = options.traceSample;
+        enableTracing(traceOptions);
+        setTraceThreadName("lns");
+    }
+    std::ofstream* trace = options.tracePath.empty() ? nullptr : &traceFile;
+
+    if (!options.sandbox) {
+        return profileRuns(options, specs, trace);
+    }
+    SandboxResult result = runSandboxed(options.limits, [&] { return profileRuns(options, specs, trace); });
+    std::printf("{\"sandbox\":%s}\n", sandboxResultJson(result).c_str());
+    return result.status == SandboxStatus::Ok ? 0 : 1;
+}
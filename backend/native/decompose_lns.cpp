@@ -0,0 +1,151 @@
+// Decomposition driver: runs runDecomposedLNS (Decomposition.h) on one instance of 10k-100k customers with
+// the operators of the plugin named by $VRP_HEURISTIC_PLUGIN. Built as a plugin host only
+// (solver/compiler.js compilePluginHost('decompose')); backend/run-decomposition.js builds and sweeps it.
+// The instance never gets a dense distance matrix, only its subproblems do.
+//
+// Prints one JSON object:
+//   {"instance":"uniform","numCustomers":100000,"method":"barycenter","subproblemSize":1000,"threads":1,
+//    "objective":..,"feasible":true,"tours":..,"served":..,"iterations":..,"elapsedMs":..,
+//    "rounds":[{"subproblems":..,"improved":..,"iterations":..,"elapsedMs":..,"objective":..},..]}
+//
+// Options:
+//   --type=cvrp|pcvrp|vrptw       problem variant (required)
+//   --size=10000                  synthetic instance size
+//   --family=uniform|clustered    synthetic instance family
+//   --instance=<file.vrp>         CVRPLIB instance instead of a synthetic one
+//   --instance-seed=1             seed of the synthetic instance and of prizes/windows of files
+//   --method=barycenter|sector    partition of the rounds
+//   --subproblem-size=1000        customers per subproblem, at most
+//   --rounds=0                    rounds, 0 = until the budget is spent
+//   --threads=0                   subproblems solved at once, 0 = one per hardware thread
+//   --subproblem-budget-ms=1000   wall-clock budget per subproblem and round
+//   --subproblem-iterations=<n>   iteration limit per subproblem and round
+//   --budget-ms=60000             wall-clock budget of the whole run
+//   --seed=1                      LNS seed; subproblems derive theirs from it
+//   --local-search                polish subproblem solutions and candidates (LocalSearch.h)
+//   --acceptance=greedy|sa|rrt|lahc  acceptance criterion of the subproblem runs (Acceptance.h)
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include "Decomposition.h"
+#include "InstanceFactory.h"
+
+namespace {
+
+struct Options {
+    ProblemType type = ProblemType::CVRP;
+    bool typeGiven = false;
+    int size = 10000;
+    std::string family = "uniform";
+    std::string file;
+    uint32_t instanceSeed = 1;
+    DecompositionConfig decomposition;
+};
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    options.decomposition.lns.timeBudgetMs = 60000;
+    options.decomposition.lns.seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg](const char* prefix) -> const char* {
+            size_t length = std::char_traits<char>::length(prefix);
+            return arg.compare(0, length, prefix) == 0 ? arg.c_str() + length : nullptr;
+        };
+        if (const char* v = value("--type=")) {
+            options.type = parseProblemType(v);
+            options.typeGiven = true;
+        } else if (const char* v = value("--size=")) {
+            options.size = std::stoi(v);
+        } else if (const char* v = value("--family=")) {
+            options.family = v;
+        } else if (const char* v = value("--instance=")) {
+            options.file = v;
+        } else if (const char* v = value("--instance-seed=")) {
+            options.instanceSeed = static_cast<uint32_t>(std::stoul(v));
+        } else if (const char* v = value("--method=")) {
+            std::string method = v;
+            if (method != "barycenter" && method != "sector") {
+                throw std::runtime_error("unknown method " + method);
+            }
+            options.decomposition.method = method == "sector" ? PartitionMethod::Sector : PartitionMethod::Barycenter;
+        } else if (const char* v = value("--subproblem-size=")) {
+            options.decomposition.subproblemSize = std::stoi(v);
+        } else if (const char* v = value("--rounds=")) {
+            options.decomposition.rounds = std::stoi(v);
+        } else if (const char* v = value("--threads=")) {
+            options.decomposition.numThreads = std::stoi(v);
+        } else if (const char* v = value("--subproblem-budget-ms=")) {
+            options.decomposition.subproblemBudgetMs = std::stod(v);
+        } else if (const char* v = value("--subproblem-iterations=")) {
+            options.decomposition.subproblemIterations = std::stoull(v);
+        } else if (const char* v = value("--budget-ms=")) {
+            options.decomposition.lns.timeBudgetMs = std::stod(v);
+        } else if (const char* v = value("--seed=")) {
+            options.decomposition.lns.seed = static_cast<uint32_t>(std::stoul(v));
+        } else if (arg == "--local-search") {
+            options.decomposition.lns.localSearch = true;
+        } else if (const char* v = value("--acceptance=")) {
+            options.decomposition.lns.acceptance.kind = parseAcceptanceKind(v);
+        } else {
+            throw std::runtime_error("unknown option " + arg);
+        }
+    }
+    if (!options.typeGiven) {
+        throw std::runtime_error("--type=cvrp|pcvrp|vrptw is required");
+    }
+    if (options.family != "uniform" && options.family != "clustered") {
+        throw std::runtime_error("unknown family " + options.family);
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    Instance instance;
+    std::string instanceName;
+    try {
+        options = parseOptions(argc, argv);
+        if (options.file.empty()) {
+            InstanceFamily family = options.family == "uniform" ? InstanceFamily::Uniform : InstanceFamily::Clustered;
+            instance = generateInstance(options.type, family, options.size, options.instanceSeed, false);
+            instanceName = options.family;
+        } else {
+            instance = loadInstanceFile(options.file, options.type, options.instanceSeed, false);
+            std::string stem = options.file.substr(options.file.find_last_of('/') + 1);
+            instanceName = "file:" + stem.substr(0, stem.find('.'));
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "decompose_lns: %s\n", e.what());
+        return 2;
+    }
+
+    const DecompositionConfig& config = options.decomposition;
+    DecompositionResult result = runDecomposedLNS(instance, config);
+    size_t served = 0;
+    for (const std::vector<int>& tour : result.tours) {
+        served += tour.size();
+    }
+
+    std::printf("{\"instance\":\"%s\",\"numCustomers\":%d,\"method\":\"%s\",\"subproblemSize\":%d,\"threads\":%d,"
+                "\"objective\":%.9g,\"feasible\":%s,\"tours\":%zu,\"served\":%zu,\"iterations\":%llu,"
+                "\"elapsedMs\":%.9g,\"rounds\":[",
+                instanceName.c_str(), instance.numCustomers,
+                config.method == PartitionMethod::Sector ? "sector" : "barycenter", config.subproblemSize,
+                config.numThreads, result.objective, toursFeasible(instance, result.tours) ? "true" : "false",
+                result.tours.size(), served, static_cast<unsigned long long>(result.iterations), result.elapsedMs);
+    for (size_t r = 0; r < result.rounds.size(); ++r) {
+        const DecompositionRound& round = result.rounds[r];
+        std::printf("%s{\"subproblems\":%d,\"improved\":%d,\"iterations\":%llu,\"elapsedMs\":%.9g,\"objective\":%.9g}",
+                    r ? "," : "", round.subproblems, round.improved, static_cast<unsigned long long>(round.iterations),
+                    round.elapsedMs, round.objective);
+    }
+    std::printf("]}\n");
+    return 0;
+}
@@ -0,0 +1,187 @@
+// Island-model driver: runs runIslandLNS (Islands.h) on one instance with operator sets loaded from plugins.
+// Built as a plugin host only (solver/compiler.js compilePluginHost('islands')), which can load any number
+// of heuristic plugins side by side; backend/run-islands.js builds and sweeps it.
+//
+// Prints one JSON object:
+//   {"instance":"uniform","numCustomers":1000,"islands":8,"topology":"ring","objective":..,"iterations":..,
+//    "elapsedMs":..,"perIsland":[{"operatorSet":0,"iterations":..,"emigrants":..,"dropped":..,
+//    "immigrants":..,"bestObjective":..},..]}
+//
+// Options:
+//   --type=cvrp|pcvrp|vrptw       problem variant (required)
+//   --size=1000                   synthetic instance size
+//   --family=uniform|clustered    synthetic instance family
+//   --instance=<file.vrp>         CVRPLIB instance instead of a synthetic one
+//   --instance-seed=1             seed of the synthetic instance and of prizes/windows of files
+//   --operators=a.so,b.so         heuristic plugins, island i runs the (i mod count)-th; repeatable.
+//                                 Default: the plugin named by $VRP_HEURISTIC_PLUGIN on every island
+//   --islands=0                   island threads, 0 = one per hardware thread
+//   --topology=ring|random        migration topology
+//   --fanout=2                    out-edges per island of the random topology
+//   --migration-interval=100      iterations between two looks at the mailboxes
+//   --population=4                solutions per island
+//   --budget-ms=5000              wall-clock budget
+//   --max-iterations=<n>          iteration limit per island
+//   --seed=1                      LNS seed; island i uses seed + i
+//   --local-search                polish initial solutions and repaired candidates (LocalSearch.h)
+//   --acceptance=greedy|sa|rrt|lahc  acceptance criterion of every island (Acceptance.h)
+//   --trace=<file.json>           also write a Chrome trace (Trace.h)
+
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "HeuristicPlugin.h"
+#include "InstanceFactory.h"
+#include "Islands.h"
+#include "Trace.h"
+
+namespace {
+
+struct Options {
+    ProblemType type = ProblemType::CVRP;
+    bool typeGiven = false;
+    int size = 1000;
+    std::string family = "uniform";
+    std::string file;
+    uint32_t instanceSeed = 1;
+    std::vector<std::string> plugins;
+    IslandConfig islands;
+    std::string tracePath;
+};
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    options.islands.lns.timeBudgetMs = 5000;
+    options.islands.lns.seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg](const char* prefix) -> const char* {
+            size_t length = std::char_traits<char>::length(prefix);
+            return arg.compare(0, length, prefix) == 0 ? arg.c_str() + length : nullptr;
+        };
+        if (const char* v = value("--type=")) {
+            options.type = parseProblemType(v);
+            options.typeGiven = true;
+        } else if (const char* v = value("--size=")) {
+            options.size = std::stoi(v);
+        } else if (const char* v = value("--family=")) {
+            options.family = v;
+        } else if (const char* v = value("--instance=")) {
+            options.file = v;
+        } else if (const char* v = value("--instance-seed=")) {
+            options.instanceSeed = static_cast<uint32_t>(std::stoul(v));
+        } else if (const char* v = value("--operators=")) {
+            for (const std::string& plugin : splitList(v)) {
+                options.plugins.push_back(plugin);
+            }
+        } else if (const char* v = value("--islands=")) {
+            options.islands.numIslands = std::stoi(v);
+        } else if (const char* v = value("--topology=")) {
+            std::string topology = v;
+            if (topology != "ring" && topology != "random") {
+                throw std::runtime_error("unknown topology " + topology);
+            }
+            options.islands.topology = topology == "ring" ? MigrationTopology::Ring : MigrationTopology::Random;
+        } else if (const char* v = value("--fanout=")) {
+            options.islands.fanout = std::stoi(v);
+        } else if (const char* v = value("--migration-interval=")) {
+            options.islands.migrationInterval = std::stoull(v);
+        } else if (const char* v = value("--population=")) {
+            options.islands.populationSize = std::stoi(v);
+        } else if (const char* v = value("--budget-ms=")) {
+            options.islands.lns.timeBudgetMs = std::stod(v);
+        } else if (const char* v = value("--max-iterations=")) {
+            options.islands.lns.maxIterations = std::stoull(v);
+        } else if (const char* v = value("--seed=")) {
+            options.islands.lns.seed = static_cast<uint32_t>(std::stoul(v));
+        } else if (arg == "--local-search") {
+            options.islands.lns.localSearch = true;
+        } else if (const char* v = value("--acceptance=")) {
+            options.islands.lns.acceptance.kind = parseAcceptanceKind(v);
+        } else if (const char* v = value("--trace=")) {
+            options.tracePath = v;
+        } else {
+            throw std::runtime_error("unknown option " + arg);
+        }
+    }
+    if (!options.typeGiven) {
+        throw std::runtime_error("--type=cvrp|pcvrp|vrptw is required");
+    }
+    if (options.family != "uniform" && options.family != "clustered") {
+        throw std::runtime_error("unknown family " + options.family);
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    Instance instance;
+    std::string instanceName;
+    try {
+        options = parseOptions(argc, argv);
+        for (const std::string& path : options.plugins) {
+            HeuristicPlugin plugin = loadHeuristicPlugin(path);
+            LnsOperators operators;
+            operators.select = plugin.select;
+            operators.sort = plugin.sort;
+            options.islands.operatorSets.push_back(operators);
+        }
+        if (options.file.empty()) {
+            InstanceFamily family = options.family == "uniform" ? InstanceFamily::Uniform : InstanceFamily::Clustered;
+            instance = generateInstance(options.type, family, options.size, options.instanceSeed);
+            instanceName = options.family;
+        } else {
+            instance = loadInstanceFile(options.file, options.type, options.instanceSeed);
+            std::string stem = options.file.substr(options.file.find_last_of('/') + 1);
+            instanceName = "file:" + stem.substr(0, stem.find('.'));
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "island_lns: %s\n", e.what());
+        return 2;
+    }
+
+    if (!options.tracePath.empty()) {
+        enableTracing();
+    }
+    IslandResult result = runIslandLNS(instance, options.islands);
+
+    std::printf("{\"instance\":\"%s\",\"numCustomers\":%d,\"islands\":%zu,\"topology\":\"%s\",\"objective\":%.9g,"
+                "\"iterations\":%llu,\"elapsedMs\":%.9g,\"perIsland\":[",
+                instanceName.c_str(), instance.numCustomers, result.islands.size(),
+                options.islands.topology == MigrationTopology::Ring ? "ring" : "random", result.best.objective(),
+                static_cast<unsigned long long>(result.iterations), result.elapsedMs);
+    for (size_t i = 0; i < result.islands.size(); ++i) {
+        const IslandStats& island = result.islands[i];
+        std::printf("%s{\"operatorSet\":%d,\"iterations\":%llu,\"emigrants\":%llu,\"dropped\":%llu,\"immigrants\":%llu,"
+                    "\"bestObjective\":%.9g}",
+                    i ? "," : "", island.operatorSet, static_cast<unsigned long long>(island.iterations),
+                    static_cast<unsigned long long>(island.emigrants), static_cast<unsigned long long>(island.dropped),
+                    static_cast<unsigned long long>(island.immigrants), island.bestObjective);
+    }
+    std::printf("]}\n");
+
+    if (!options.tracePath.empty() && !writeChromeTrace(options.tracePath)) {
+        std::fprintf(stderr, "island_lns: cannot write %s\n", options.tracePath.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,499 @@
+// Native test driver, linked against one heuristic like the other targets (backend/solver/compiler.js, target 'tests').
+// backend/test-native.js builds it with an example heuristic of every problem type and runs it.
+//
+//   <type>            runs the tests on synthetic instances of cvrp, pcvrp or vrptw with the linked heuristic's
+//                     operators; prints one line per test and exits non-zero if any failed
+//   encode-progress   reads solution snapshots from stdin, one per line as numTours followed by length and customers
+//                     of every tour, and prints the MSG_PROGRESS frame of each (Protocol.h) in hex, without the type
+//                     byte and requestId, i.e. what the server relays to the browser. backend/test-route-delta.js
+//                     decodes them with the frontend's decoder.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "InstanceFactory.h"
+#include "LNS.h"
+#include "LocalSearch.h"
+#include "Protocol.h"
+#include "Utils.h"
+
+namespace {
+
+// A test returns an empty string when it passes, otherwise what went wrong
+using TestCase = std::function<std::string(ProblemType type)>;
+
+template <typename T>
+bool sameBits(const T& a, const T& b) {
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+// First difference between two solutions, compared bit for bit, or an empty string
+std::string compareSolutions(const Solution& expected, const Solution& actual) {
+    if (expected.tours.size() != actual.tours.size()) {
+        return std::to_string(actual.tours.size()) + " tours instead of " + std::to_string(expected.tours.size());
+    }
+    for (size_t t = 0; t < expected.tours.size(); ++t) {
+        const Tour& a = expected.tours[t];
+        const Tour& b = actual.tours[t];
+        if (a.customers != b.customers || a.demand != b.demand || !sameBits(a.costs, b.costs)) {
+            return "tour " + std::to_string(t) + " differs";
+        }
+    }
+    if (expected.customerToTourMap != actual.customerToTourMap) {
+        return "customerToTourMap differs";
+    }
+    if (!sameBits(expected.totalCosts, actual.totalCosts)) {
+        return "totalCosts differs";
+    }
+    if (!sameBits(expected.travelCosts, actual.travelCosts)) {
+        return "travelCosts differs";
+    }
+    if (!sameBits(expected.uncollectedPrizes, actual.uncollectedPrizes)) {
+        return "uncollectedPrizes differs";
+    }
+    return "";
+}
+
+// Random removals and insertions through the mutation primitives, including emptying tours, dropping them
+// with removeEmptyTours (which shifts the tours behind them) and opening new ones. Ignores capacities.
+void mutateRandomly(Solution& sol, std::mt19937& rng) {
+    const Instance& instance = sol.instance;
+    std::vector<int> removed;
+    auto pick = [&](size_t size) { return static_cast<size_t>(rng() % size); };
+
+    // Empty a whole tour now and then, so that removeEmptyTours has something to close
+    if (!sol.tours.empty() && rng() % 2 == 0) {
+        std::vector<int> customers = sol.tours[pick(sol.tours.size())].customers;
+        for (int c : customers) {
+            sol.removeCustomer(c);
+            removed.push_back(c);
+        }
+    }
+    int extra = static_cast<int>(rng() % 20);
+    for (int i = 0; i < extra; ++i) {
+        int c = 1 + static_cast<int>(pick(static_cast<size_t>(instance.numCustomers)));
+        if (sol.customerToTourMap[c] >= 0) {
+            sol.removeCustomer(c);
+            removed.push_back(c);
+        }
+    }
+    if (rng() % 2 == 0) {
+        sol.removeEmptyTours();
+    }
+    std::shuffle(removed.begin(), removed.end(), rng);
+    for (int c : removed) {
+        // PCVRP customers may stay unserved
+        if (instance.type == ProblemType::PCVRP && rng() % 4 == 0) {
+            continue;
+        }
+        size_t tourIdx = rng() % 8 == 0 ? sol.tours.size() : pick(sol.tours.size() + 1);
+        int pos = tourIdx < sol.tours.size() ? static_cast<int>(pick(sol.tours[tourIdx].customers.size() + 1)) : 0;
+        sol.insertCustomer(c, static_cast<int>(tourIdx), pos);
+    }
+    if (rng() % 2 == 0) {
+        sol.removeEmptyTours();
+    }
+}
+
+// The linked operators read the solution through their own declaration of it, which for some generated
+// heuristics is a copy of the leading fields of Solution: they must pick customers (served ones, except for
+// PCVRP, whose operators may also pick unserved customers to insert), and sorting must permute the selection
+std::string testLinkedOperators(ProblemType type) {
+    Instance instance = generateInstance(type, InstanceFamily::Uniform, 300, 43);
+    seedRandomGenerators(15);
+    Solution sol = constructInitialSolution(instance);
+    LnsWorkspace workspace(instance);
+    LnsOperators operators;
+    for (int round = 0; round < 200; ++round) {
+        std::vector<int> selected = operators.select(sol);
+        for (int c : selected) {
+            if (c < 1 || c > instance.numCustomers) {
+                return "select returned " + std::to_string(c) + ", not a customer";
+            }
+            if (type != ProblemType::PCVRP && sol.customerToTourMap[c] < 0) {
+                return "select returned " + std::to_string(c) + ", which is not served";
+            }
+        }
+        std::vector<int> sorted = selected;
+        operators.sort(sorted, instance);
+        std::sort(selected.begin(), selected.end());
+        std::vector<int> check = sorted;
+        std::sort(check.begin(), check.end());
+        if (check != selected) {
+            return "sort changed the selected customers";
+        }
+        lnsIteration(sol, operators, workspace);
+    }
+    return "";
+}
+
+// Undoing random primitive calls, with tours closed and reopened at shifted indices, restores the solution
+// bit for bit; every other round is kept instead, so rounds start from varied solutions
+std::string testJournalUndo(ProblemType type) {
+    for (InstanceFamily family : {InstanceFamily::Uniform, InstanceFamily::Clustered}) {
+        Instance instance = generateInstance(type, family, 300, 11);
+        seedRandomGenerators(5);
+        Solution sol = constructInitialSolution(instance);
+        std::mt19937 rng(17);
+        SolutionJournal journal;
+        for (int round = 0; round < 2000; ++round) {
+            Solution saved = sol;
+            sol.journal = &journal;
+            mutateRandomly(sol, rng);
+            sol.journal = nullptr;
+            if (round % 2 == 0) {
+                journal.clear();
+                continue;
+            }
+            undoJournal(sol, journal);
+            std::string difference = compareSolutions(saved, sol);
+            if (!difference.empty()) {
+                return "round " + std::to_string(round) + ": " + difference;
+            }
+        }
+    }
+    return "";
+}
+
+// A rejected lnsIteration leaves the solution as it was, bit for bit
+std::string testRejectedIterationsUndo(ProblemType type) {
+    Instance instance = generateInstance(type, InstanceFamily::Clustered, 300, 13);
+    seedRandomGenerators(7);
+    Solution sol = constructInitialSolution(instance);
+    LnsWorkspace workspace(instance);
+    int rejected = 0;
+    for (int iteration = 0; iteration < 3000; ++iteration) {
+        Solution saved = sol;
+        if (!lnsIteration(sol, LnsOperators(), workspace)) {
+            ++rejected;
+            std::string difference = compareSolutions(saved, sol);
+            if (!difference.empty()) {
+                return "iteration " + std::to_string(iteration) + ": " + difference;
+            }
+        }
+    }
+    return rejected > 0 ? "" : "no iteration was rejected";
+}
+
+// Objective of a solution summed from scratch in double: travel distance plus, for PCVRP, the unserved prizes
+double exactObjective(const Solution& sol) {
+    const Instance& instance = sol.instance;
+    double objective = 0;
+    for (const Tour& tour : sol.tours) {
+        int prev = 0;
+        for (int c : tour.customers) {
+            objective += instance.distanceMatrix[prev][c];
+            prev = c;
+        }
+        objective += instance.distanceMatrix[prev][0];
+    }
+    if (instance.type == ProblemType::PCVRP) {
+        for (int c = 1; c <= instance.numCustomers; ++c) {
+            if (sol.customerToTourMap[c] < 0) {
+                objective += instance.prizes[c];
+            }
+        }
+    }
+    return objective;
+}
+
+// The running sums the primitives keep agree with recomputeCosts after many kept insertions and removals
+std::string testRunningSumsDrift(ProblemType type) {
+    Instance instance = generateInstance(type, InstanceFamily::Uniform, 1000, 19);
+    seedRandomGenerators(9);
+    Solution sol = constructInitialSolution(instance);
+    std::mt19937 rng(23);
+    for (int round = 1; round <= 20000; ++round) {
+        mutateRandomly(sol, rng);
+        if (round % 2000 != 0) {
+            continue;
+        }
+        Solution recomputed = sol;
+        recomputed.recomputeCosts();
+        // Each primitive adds one float distance to a double sum; the error stays far below one float step
+        double tolerance = 1e-6 * recomputed.travelCosts;
+        if (std::fabs(sol.travelCosts - recomputed.travelCosts) > tolerance) {
+            return "travelCosts off by " + std::to_string(sol.travelCosts - recomputed.travelCosts) + " after " +
+                   std::to_string(round) + " rounds";
+        }
+        if (std::fabs(sol.uncollectedPrizes - recomputed.uncollectedPrizes) > 1e-6 * instance.total_prizes) {
+            return "uncollectedPrizes off by " + std::to_string(sol.uncollectedPrizes - recomputed.uncollectedPrizes) +
+                   " after " + std::to_string(round) + " rounds";
+        }
+        // The PCVRP objective is built from the two sums; the other types still report the float totalCosts
+        if (type == ProblemType::PCVRP && std::fabs(sol.objective() - exactObjective(sol)) > 1e-6 * exactObjective(sol)) {
+            return "objective " + std::to_string(sol.objective()) + " instead of " + std::to_string(exactObjective(sol));
+        }
+    }
+    return "";
+}
+
+// objective() orders the solutions of an LNS run like their exact objectives, except for pairs closer than
+// float resolution
+std::string testObjectiveRanking(ProblemType type) {
+    Instance instance = generateInstance(type, InstanceFamily::Clustered, 1000, 29);
+    seedRandomGenerators(11);
+    Solution sol = constructInitialSolution(instance);
+    LnsWorkspace workspace(instance);
+    std::vector<std::pair<float, double>> objectives;
+    std::mt19937 rng(31);
+    for (int iteration = 0; iteration < 4000; ++iteration) {
+        lnsIteration(sol, LnsOperators(), workspace);
+        if (iteration % 40 == 0) {
+            objectives.emplace_back(sol.objective(), exactObjective(sol));
+            // Detours through random solutions, which are worse by varying amounts
+            Solution detour = sol;
+            mutateRandomly(detour, rng);
+            objectives.emplace_back(detour.objective(), exactObjective(detour));
+        }
+    }
+    int compared = 0;
+    for (size_t i = 0; i < objectives.size(); ++i) {
+        for (size_t j = i + 1; j < objectives.size(); ++j) {
+            const auto& [fastA, exactA] = objectives[i];
+            const auto& [fastB, exactB] = objectives[j];
+            if (std::fabs(exactA - exactB) <= 1e-5 * std::max(exactA, exactB)) {
+                continue;
+            }
+            ++compared;
+            if ((fastA < fastB) != (exactA < exactB)) {
+                return "objective() ranks " + std::to_string(fastA) + " and " + std::to_string(fastB) +
+                       " against their exact values " + std::to_string(exactA) + " and " + std::to_string(exactB);
+            }
+        }
+    }
+    return compared > 0 ? "" : "no pair of solutions to compare";
+}
+
+// Capacity and, for VRPTW, the time windows of one tour; an empty tour is feasible
+bool tourFeasible(const Instance& instance, const Tour& tour) {
+    if (tour.demand > instance.vehicleCapacity) {
+        return false;
+    }
+    if (instance.type != ProblemType::VRPTW) {
+        return true;
+    }
+    float time = instance.startTW[0];
+    int prev = 0;
+    for (int c : tour.customers) {
+        time = std::max(time + instance.distanceMatrix[prev][c], instance.startTW[c]);
+        if (time > instance.endTW[c]) {
+            return false;
+        }
+        time += instance.serviceTime[c];
+        prev = c;
+    }
+    return tour.customers.empty() || time + instance.distanceMatrix[prev][0] <= instance.endTW[0];
+}
+
+std::string infeasibleTour(const Solution& sol) {
+    for (size_t t = 0; t < sol.tours.size(); ++t) {
+        if (!tourFeasible(sol.instance, sol.tours[t])) {
+            return "tour " + std::to_string(t) + " is infeasible";
+        }
+    }
+    return "";
+}
+
+// Every move local search applies changes the recomputed travel distance by what it predicted, and keeps
+// every tour within capacity and time windows
+std::string testLocalSearchMoves(ProblemType type) {
+    Instance instance = generateInstance(type, InstanceFamily::Clustered, 300, 37);
+    seedRandomGenerators(13);
+    Solution sol = constructInitialSolution(instance);
+    std::string error = infeasibleTour(sol);
+    if (!error.empty()) {
+        return "initial solution: " + error;
+    }
+
+    LocalSearch localSearch(instance);
+    Solution recomputed = sol;
+    recomputed.recomputeCosts();
+    double travel = recomputed.travelCosts;
+    int moves = 0;
+    localSearch.onMove = [&](const Solution& moved, float delta) {
+        ++moves;
+        if (!error.empty()) {
+            return;
+        }
+        recomputed = moved;
+        recomputed.recomputeCosts();
+        double change = recomputed.travelCosts - travel;
+        travel = recomputed.travelCosts;
+        // delta sums six float distances of up to ~1200, each rounded to a few 1e-5
+        if (delta >= 0 || std::fabs(change - delta) > 1e-2) {
+            error = "move " + std::to_string(moves) + " predicted " + std::to_string(delta) + ", changed " +
+                    std::to_string(change);
+        } else if (!(error = infeasibleTour(moved)).empty()) {
+            error = "move " + std::to_string(moves) + ": " + error;
+        }
+    };
+    localSearch.improve(sol);
+    // Repaired customers, as LNS passes them, after random destroys
+    std::mt19937 rng(41);
+    for (int round = 0; round < 200 && error.empty(); ++round) {
+        std::vector<int> removed;
+        for (int i = 0; i < 15; ++i) {
+            int c = 1 + static_cast<int>(rng() % static_cast<uint32_t>(instance.numCustomers));
+            if (sol.customerToTourMap[c] >= 0) {
+                sol.removeCustomer(c);
+                removed.push_back(c);
+            }
+        }
+        reinsertCustomers(sol, removed);
+        recomputed = sol;
+        recomputed.recomputeCosts();
+        travel = recomputed.travelCosts;
+        localSearch.improve(sol, removed);
+    }
+    if (!error.empty()) {
+        return error;
+    }
+    return moves > 0 ? "" : "no move was applied";
+}
+
+// Depot at the origin and two customers next to each other 100 away, demand 6 each, on tours of their own
+Instance pairInstance(ProblemType type, int capacity, float customerEndTW) {
+    Instance instance;
+    instance.type = type;
+    instance.vehicleCapacity = capacity;
+    instance.nodePositions = {{0, 0}, {100, 0}, {101, 0}};
+    instance.demand = {0, 6, 6};
+    if (type == ProblemType::VRPTW) {
+        instance.startTW = {0, 0, 0};
+        instance.endTW = {10000, customerEndTW, customerEndTW};
+        instance.serviceTime = {0, 100, 100};
+    }
+    if (type == ProblemType::PCVRP) {
+        instance.prizes = {0, 1000, 1000};
+    }
+    instance.finalize();
+    return instance;
+}
+
+// Serving both customers on one tour saves 200, so local search merges the tours exactly when that is feasible
+std::string checkMerge(const Instance& instance, bool feasible) {
+    Solution sol = solutionFromTours(instance, {{1}, {2}});
+    if (sol.tours.size() != 2) {
+        return "start with " + std::to_string(sol.tours.size()) + " tours instead of 2";
+    }
+    LocalSearch localSearch(instance);
+    int moves = localSearch.improve(sol);
+    std::string error = infeasibleTour(sol);
+    if (!error.empty()) {
+        return error;
+    }
+    if (feasible != (sol.tours.size() == 1)) {
+        return std::to_string(moves) + " moves left " + std::to_string(sol.tours.size()) + " tours";
+    }
+    return "";
+}
+
+std::string testLocalSearchCapacity(ProblemType type) {
+    std::string error = checkMerge(pairInstance(type, 10, 10000), false);
+    if (!error.empty()) {
+        return "capacity 10: " + error;
+    }
+    error = checkMerge(pairInstance(type, 20, 10000), true);
+    return error.empty() ? "" : "capacity 20: " + error;
+}
+
+// Always on VRPTW: served back to back, the second customer starts at 201 or 202
+std::string testLocalSearchTimeWindows(ProblemType) {
+    std::string error = checkMerge(pairInstance(ProblemType::VRPTW, 100, 150), false);
+    if (!error.empty()) {
+        return "windows ending at 150: " + error;
+    }
+    error = checkMerge(pairInstance(ProblemType::VRPTW, 100, 1000), true);
+    return error.empty() ? "" : "windows ending at 1000: " + error;
+}
+
+int runTests(ProblemType type) {
+    const std::pair<const char*, TestCase> tests[] = {
+        {"linked operators read the solution layout", testLinkedOperators},
+        {"journal undo restores random primitive calls", testJournalUndo},
+        {"rejected LNS iterations are undone", testRejectedIterationsUndo},
+        {"running sums do not drift from recomputeCosts", testRunningSumsDrift},
+        {"objective ranks solutions like their exact objectives", testObjectiveRanking},
+        {"local search moves change the travel distance as predicted", testLocalSearchMoves},
+        {"local search respects capacity", testLocalSearchCapacity},
+        {"local search respects time windows", testLocalSearchTimeWindows},
+    };
+    int failures = 0;
+    for (const auto& [name, test] : tests) {
+        std::string error = test(type);
+        if (error.empty()) {
+            std::printf("ok    %s %s\n", problemTypeName(type), name);
+        } else {
+            std::printf("FAIL  %s %s: %s\n", problemTypeName(type), name, error.c_str());
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+int encodeProgressFrames() {
+    RouteDeltaState state;
+    ProgressEvent event;
+    event.requestId = 1;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream numbers(line);
+        uint32_t numTours = 0;
+        numbers >> numTours;
+        event.tourLengths.assign(numTours, 0);
+        event.customers.clear();
+        for (uint32_t& length : event.tourLengths) {
+            numbers >> length;
+            for (uint32_t i = 0; i < length; ++i) {
+                int customer = 0;
+                numbers >> customer;
+                event.customers.push_back(customer);
+            }
+        }
+        if (!numbers) {
+            std::fprintf(stderr, "malformed snapshot: %s\n", line.c_str());
+            return 1;
+        }
+
+        ByteWriter writer;
+        encodeProgress(writer, event, state);
+        const std::vector<uint8_t>& bytes = writer.bytes();
+        for (size_t i = 5; i < bytes.size(); ++i) {
+            std::printf("%02x", bytes[i]);
+        }
+        std::printf("\n");
+        ++event.iteration;
+        event.elapsedMs += 1;
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "";
+    try {
+        if (mode == "encode-progress") {
+            return encodeProgressFrames();
+        }
+        if (!mode.empty()) {
+            return runTests(parseProblemType(mode));
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+    std::fprintf(stderr, "usage: %s cvrp|pcvrp|vrptw|encode-progress\n", argv[0]);
+    return 2;
+}
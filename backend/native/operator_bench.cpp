@@ -0,0 +1,316 @@
+// Google Benchmark driver for one heuristic's select_by_llm_1 / sort_by_llm_1.
+// backend/benchmark-operators.js links it against every generated heuristic and merges the JSON output.
+//
+// Benchmarks are named <operator>/<instance>/<numCustomers>, e.g. select/clustered/1000 or sort/file:X-n101-k25/100.
+// Besides time per call, each reports these user counters per call:
+//   allocs, alloc_bytes   global operator new calls and bytes
+//   cache_misses          hardware cache misses of the calling thread (only where perf events are permitted)
+//   selected              size of the selection (select) or of the sorted list (sort)
+//
+// Options, given before the Google Benchmark flags:
+//   --type=cvrp|pcvrp|vrptw       problem variant the heuristic was evolved for (required)
+//   --sizes=100,1000,10000        synthetic instance sizes
+//   --families=uniform,clustered  synthetic instance families
+//   --instance=<file.vrp>         CVRPLIB instance, repeatable
+//   --seed=<n>                    seed of the instances and the operators' random generators
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "AgentDesigned.h"
+#include "InstanceFactory.h"
+#include "LNS.h"
+
+namespace {
+
+std::atomic<uint64_t> allocationCount{0};
+std::atomic<uint64_t> allocationBytes{0};
+
+void* countedAlloc(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+// Counts hardware cache misses of this thread in user space; unavailable without perf event permissions
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~CacheMissCounter() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    bool available() const { return fd_ >= 0; }
+
+    void start() {
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    uint64_t stop() {
+        uint64_t value = 0;
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &value, sizeof(value)) != sizeof(value)) {
+                value = 0;
+            }
+        }
+        return value;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+struct Options {
+    ProblemType type = ProblemType::CVRP;
+    bool typeGiven = false;
+    std::vector<int> sizes{100, 1000, 10000};
+    std::vector<std::string> families{"uniform", "clustered"};
+    std::vector<std::string> files;
+    uint32_t seed = 1;
+};
+
+// One instance is alive at a time: benchmarks are registered grouped by instance, and a 10k instance
+// holds a 400 MB distance matrix.
+struct Fixture {
+    std::string name;
+    std::unique_ptr<Instance> instance;
+    std::unique_ptr<Solution> solution; // Greedy initial solution, the input of select
+    std::vector<int> selection; // One selection on it, the input of sort
+};
+
+Fixture fixture;
+
+const Fixture& loadFixture(const std::string& name, const std::function<Instance()>& build, uint32_t seed) {
+    if (fixture.name != name) {
+        fixture = Fixture();
+        fixture.instance = std::make_unique<Instance>(build());
+        seedRandomGenerators(seed);
+        fixture.solution = std::make_unique<Solution>(constructInitialSolution(*fixture.instance));
+        fixture.selection = select_by_llm_1(*fixture.solution);
+        fixture.name = name;
+    }
+    return fixture;
+}
+
+void reportCounters(benchmark::State& state, uint64_t allocs, uint64_t bytes, uint64_t misses, bool missesAvailable, size_t selected) {
+    using benchmark::Counter;
+    state.counters["allocs"] = Counter(static_cast<double>(allocs), Counter::kAvgIterations);
+    state.counters["alloc_bytes"] = Counter(static_cast<double>(bytes), Counter::kAvgIterations);
+    if (missesAvailable) {
+        state.counters["cache_misses"] = Counter(static_cast<double>(misses), Counter::kAvgIterations);
+    }
+    state.counters["selected"] = static_cast<double>(selected);
+}
+
+void benchmarkSelect(benchmark::State& state, const std::string& name, const std::function<Instance()>& build, uint32_t seed) {
+    const Fixture& f = loadFixture(name, build, seed);
+    seedRandomGenerators(seed);
+    CacheMissCounter misses;
+    size_t selected = 0;
+    uint64_t allocs = allocationCount.load();
+    uint64_t bytes = allocationBytes.load();
+    misses.start();
+    for (auto _ : state) {
+        std::vector<int> removed = select_by_llm_1(*f.solution);
+        selected += removed.size();
+        benchmark::DoNotOptimize(removed.data());
+    }
+    uint64_t missCount = misses.stop();
+    reportCounters(state, allocationCount.load() - allocs, allocationBytes.load() - bytes, missCount,
+                   misses.available(), state.iterations() ? selected / state.iterations() : 0);
+}
+
+void benchmarkSort(benchmark::State& state, const std::string& name, const std::function<Instance()>& build, uint32_t seed) {
+    const Fixture& f = loadFixture(name, build, seed);
+    seedRandomGenerators(seed);
+    // Refilled in place every call, so the copy neither allocates nor shows up in the counters
+    std::vector<int> order;
+    order.reserve(f.selection.size() * 2 + 16);
+    CacheMissCounter misses;
+    uint64_t allocs = allocationCount.load();
+    uint64_t bytes = allocationBytes.load();
+    misses.start();
+    for (auto _ : state) {
+        order.assign(f.selection.begin(), f.selection.end());
+        sort_by_llm_1(order, *f.instance);
+        benchmark::DoNotOptimize(order.data());
+    }
+    uint64_t missCount = misses.stop();
+    reportCounters(state, allocationCount.load() - allocs, allocationBytes.load() - bytes, missCount,
+                   misses.available(), f.selection.size());
+}
+
+std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// Consumes our options from argv, leaving the rest for benchmark::Initialize
+Options parseOptions(int& argc, char** argv) {
+    Options options;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg](const char* prefix) -> const char* {
+            size_t length = std::char_traits<char>::length(prefix);
+            return arg.compare(0, length, prefix) == 0 ? arg.c_str() + length : nullptr;
+        };
+        if (const char* v = value("--type=")) {
+            options.type = parseProblemType(v);
+            options.typeGiven = true;
+        } else if (const char* v = value("--sizes=")) {
+            options.sizes.clear();
+            for (const std::string& size : splitList(v)) {
+                options.sizes.push_back(std::stoi(size));
+            }
+        } else if (const char* v = value("--families=")) {
+            options.families = splitList(v);
+        } else if (const char* v = value("--instance=")) {
+            options.files.push_back(v);
+        } else if (const char* v = value("--seed=")) {
+            options.seed = static_cast<uint32_t>(std::stoul(v));
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    if (!options.typeGiven) {
+        throw std::runtime_error("--type=cvrp|pcvrp|vrptw is required");
+    }
+    return options;
+}
+
+void registerPair(const std::string& label, int numCustomers, const std::function<Instance()>& build, uint32_t seed) {
+    std::string name = label + "/" + std::to_string(numCustomers);
+    benchmark::RegisterBenchmark(("select/" + name).c_str(), benchmarkSelect, name, build, seed);
+    benchmark::RegisterBenchmark(("sort/" + name).c_str(), benchmarkSort, name, build, seed);
+}
+
+}
+
+void* operator new(size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+// False positive: every operator new above allocates with malloc (countedAlloc), which GCC does not track
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "operator_bench: %s\n", e.what());
+        return 2;
+    }
+
+    for (const std::string& family : options.families) {
+        if (family != "uniform" && family != "clustered") {
+            std::fprintf(stderr, "operator_bench: unknown family %s\n", family.c_str());
+            return 2;
+        }
+        InstanceFamily kind = family == "uniform" ? InstanceFamily::Uniform : InstanceFamily::Clustered;
+        for (int size : options.sizes) {
+            registerPair(family, size, [=] { return generateInstance(options.type, kind, size, options.seed); }, options.seed);
+        }
+    }
+    for (const std::string& path : options.files) {
+        Instance probe;
+        try {
+            probe = loadInstanceFile(path, options.type, options.seed);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "operator_bench: %s\n", e.what());
+            return 2;
+        }
+        std::string stem = path.substr(path.find_last_of('/') + 1);
+        stem = stem.substr(0, stem.find('.'));
+        registerPair("file:" + stem, probe.numCustomers, [=] { return loadInstanceFile(path, options.type, options.seed); }, options.seed);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 2;
+    }
+    benchmark::AddCustomContext("problem_type", problemTypeName(options.type));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
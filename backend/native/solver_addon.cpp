@@ -0,0 +1,323 @@
+// Node-API addon running the LNS in-process on the libuv thread pool.
+//
+//   solve(instance, { timeBudgetMs, seed }) -> Promise<{ objective, totalCosts, iterations, elapsedMs, tours }>
+//   metrics() -> { threads, iterations, accepted, improved, cyclesPerNs, phases, operatorCounters }, the LNS
+//                counters of this addon (Metrics.h) in the shape backend/solver/protocol.js decodes MSG_METRICS to
+//
+// instance has the layout built by backend/solver/instance.js: vrpType, vehicleCapacity and the typed arrays
+// x, y (Float32Array), demand (Int32Array), plus prizes (PCVRP) or startTW, endTW, serviceTime (VRPTW).
+// The event loop only takes references to the array buffers; copying them into the Instance happens on the
+// worker thread. Callers must not modify the arrays until the promise settles.
+
+#include <node_api.h>
+
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "LNS.h"
+#include "Metrics.h"
+
+namespace {
+
+#define NAPI_CALL(env, call)                                              \
+    do {                                                                  \
+        if ((call) != napi_ok) {                                          \
+            napi_throw_error((env), nullptr, "Node-API call failed: " #call); \
+            return nullptr;                                               \
+        }                                                                 \
+    } while (0)
+
+struct ArrayView {
+    const void* data = nullptr;
+    size_t length = 0;
+    napi_ref ref = nullptr;
+};
+
+struct SolveJob {
+    napi_async_work work = nullptr;
+    napi_deferred deferred = nullptr;
+    ProblemType type = ProblemType::CVRP;
+    int vehicleCapacity = 0;
+    ArrayView x, y, demand, prizes, startTW, endTW, serviceTime;
+    LNSConfig config;
+    std::unique_ptr<Instance> instance;
+    std::unique_ptr<LNSResult> result;
+    std::string error;
+};
+
+bool readTypedArray(napi_env env, napi_value object, const char* name, napi_typedarray_type expected,
+                    ArrayView& view, std::string& error) {
+    napi_value value;
+    bool isTypedArray = false;
+    if (napi_get_named_property(env, object, name, &value) != napi_ok ||
+        napi_is_typedarray(env, value, &isTypedArray) != napi_ok || !isTypedArray) {
+        error = std::string("instance.") + name + " must be a typed array";
+        return false;
+    }
+    napi_typedarray_type type;
+    void* data = nullptr;
+    napi_value buffer;
+    size_t byteOffset = 0;
+    napi_get_typedarray_info(env, value, &type, &view.length, &data, &buffer, &byteOffset);
+    if (type != expected) {
+        error = std::string("instance.") + name + (expected == napi_float32_array ? " must be a Float32Array" : " must be an Int32Array");
+        return false;
+    }
+    view.data = data;
+    napi_create_reference(env, value, 1, &view.ref);
+    return true;
+}
+
+void releaseView(napi_env env, ArrayView& view) {
+    if (view.ref) {
+        napi_delete_reference(env, view.ref);
+        view.ref = nullptr;
+    }
+}
+
+template <typename T>
+void copyView(const ArrayView& view, std::vector<T>& out) {
+    const T* data = static_cast<const T*>(view.data);
+    out.assign(data, data + view.length);
+}
+
+void executeSolve(napi_env, void* data) {
+    SolveJob* job = static_cast<SolveJob*>(data);
+    try {
+        job->instance = std::make_unique<Instance>();
+        Instance& instance = *job->instance;
+        instance.type = job->type;
+        instance.vehicleCapacity = job->vehicleCapacity;
+
+        const float* x = static_cast<const float*>(job->x.data);
+        const float* y = static_cast<const float*>(job->y.data);
+        instance.nodePositions.resize(job->x.length);
+        for (size_t i = 0; i < job->x.length; ++i) {
+            instance.nodePositions[i] = {x[i], y[i]};
+        }
+        copyView(job->demand, instance.demand);
+        if (job->type == ProblemType::PCVRP) {
+            copyView(job->prizes, instance.prizes);
+        }
+        if (job->type == ProblemType::VRPTW) {
+            copyView(job->startTW, instance.startTW);
+            copyView(job->endTW, instance.endTW);
+            copyView(job->serviceTime, instance.serviceTime);
+        }
+        instance.finalize();
+
+        job->result = std::make_unique<LNSResult>(runLNS(instance, job->config));
+    } catch (const std::exception& e) {
+        job->error = e.what();
+    }
+}
+
+napi_value makeNumber(napi_env env, double value) {
+    napi_value result;
+    napi_create_double(env, value, &result);
+    return result;
+}
+
+napi_value buildResult(napi_env env, const LNSResult& result) {
+    const Solution& best = result.best;
+    napi_value object;
+    napi_create_object(env, &object);
+    napi_set_named_property(env, object, "objective", makeNumber(env, best.objective()));
+    napi_set_named_property(env, object, "totalCosts", makeNumber(env, best.totalCosts));
+    napi_set_named_property(env, object, "iterations", makeNumber(env, static_cast<double>(result.iterations)));
+    napi_set_named_property(env, object, "elapsedMs", makeNumber(env, result.elapsedMs));
+
+    napi_value tours;
+    napi_create_array_with_length(env, best.tours.size(), &tours);
+    for (size_t t = 0; t < best.tours.size(); ++t) {
+        const Tour& tour = best.tours[t];
+        napi_value customers;
+        napi_create_array_with_length(env, tour.customers.size(), &customers);
+        for (size_t i = 0; i < tour.customers.size(); ++i) {
+            napi_value id;
+            napi_create_uint32(env, static_cast<uint32_t>(tour.customers[i]), &id);
+            napi_set_element(env, customers, static_cast<uint32_t>(i), id);
+        }
+        napi_value entry;
+        napi_create_object(env, &entry);
+        napi_set_named_property(env, entry, "customers", customers);
+        napi_set_named_property(env, entry, "demand", makeNumber(env, tour.demand));
+        napi_set_named_property(env, entry, "costs", makeNumber(env, tour.costs));
+        napi_set_named_property(env, entry, "distance", makeNumber(env, tourDistance(best.instance, tour.customers)));
+        napi_set_element(env, tours, static_cast<uint32_t>(t), entry);
+    }
+    napi_set_named_property(env, object, "tours", tours);
+    return object;
+}
+
+void releaseJob(napi_env env, SolveJob* job) {
+    for (ArrayView* view : {&job->x, &job->y, &job->demand, &job->prizes, &job->startTW, &job->endTW, &job->serviceTime}) {
+        releaseView(env, *view);
+    }
+    if (job->work) {
+        napi_delete_async_work(env, job->work);
+    }
+    delete job;
+}
+
+void completeSolve(napi_env env, napi_status status, void* data) {
+    SolveJob* job = static_cast<SolveJob*>(data);
+    if (status == napi_ok && job->error.empty()) {
+        napi_resolve_deferred(env, job->deferred, buildResult(env, *job->result));
+    } else {
+        napi_value message;
+        napi_value error;
+        const std::string text = job->error.empty() ? "solve cancelled" : job->error;
+        napi_create_string_utf8(env, text.c_str(), text.size(), &message);
+        napi_create_error(env, nullptr, message, &error);
+        napi_reject_deferred(env, job->deferred, error);
+    }
+    releaseJob(env, job);
+}
+
+bool parseProblemType(napi_env env, napi_value instance, ProblemType& type) {
+    napi_value value;
+    char name[16] = {0};
+    size_t length = 0;
+    if (napi_get_named_property(env, instance, "vrpType", &value) != napi_ok ||
+        napi_get_value_string_utf8(env, value, name, sizeof(name), &length) != napi_ok) {
+        return false;
+    }
+    if (std::strcmp(name, "cvrp") == 0) {
+        type = ProblemType::CVRP;
+    } else if (std::strcmp(name, "pcvrp") == 0) {
+        type = ProblemType::PCVRP;
+    } else if (std::strcmp(name, "vrptw") == 0) {
+        type = ProblemType::VRPTW;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+double readOption(napi_env env, napi_value options, const char* name, double fallback) {
+    napi_valuetype type;
+    if (napi_typeof(env, options, &type) != napi_ok || type != napi_object) {
+        return fallback;
+    }
+    napi_value value;
+    double number = fallback;
+    if (napi_get_named_property(env, options, name, &value) == napi_ok &&
+        napi_typeof(env, value, &type) == napi_ok && type == napi_number) {
+        napi_get_value_double(env, value, &number);
+    }
+    return number;
+}
+
+napi_value Solve(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+    if (argc < 1) {
+        napi_throw_type_error(env, nullptr, "solve(instance, options) expects an instance");
+        return nullptr;
+    }
+
+    auto job = std::make_unique<SolveJob>();
+    std::string error;
+    if (!parseProblemType(env, argv[0], job->type)) {
+        error = "instance.vrpType must be 'cvrp', 'pcvrp' or 'vrptw'";
+    }
+
+    bool ok = error.empty() &&
+              readTypedArray(env, argv[0], "x", napi_float32_array, job->x, error) &&
+              readTypedArray(env, argv[0], "y", napi_float32_array, job->y, error) &&
+              readTypedArray(env, argv[0], "demand", napi_int32_array, job->demand, error);
+    if (ok && job->type == ProblemType::PCVRP) {
+        ok = readTypedArray(env, argv[0], "prizes", napi_float32_array, job->prizes, error);
+    }
+    if (ok && job->type == ProblemType::VRPTW) {
+        ok = readTypedArray(env, argv[0], "startTW", napi_float32_array, job->startTW, error) &&
+             readTypedArray(env, argv[0], "endTW", napi_float32_array, job->endTW, error) &&
+             readTypedArray(env, argv[0], "serviceTime", napi_float32_array, job->serviceTime, error);
+    }
+    if (ok) {
+        size_t n = job->x.length;
+        for (const ArrayView* view : {&job->y, &job->demand, &job->prizes, &job->startTW, &job->endTW, &job->serviceTime}) {
+            if (view->ref && view->length != n) {
+                ok = false;
+                error = "instance arrays must all have one entry per node";
+            }
+        }
+        if (ok && n == 0) {
+            ok = false;
+            error = "instance without depot";
+        }
+    }
+    if (!ok) {
+        releaseJob(env, job.release());
+        napi_throw_type_error(env, nullptr, error.c_str());
+        return nullptr;
+    }
+
+    job->vehicleCapacity = static_cast<int>(readOption(env, argv[0], "vehicleCapacity", 0));
+    napi_value options = argc > 1 ? argv[1] : nullptr;
+    if (options) {
+        job->config.timeBudgetMs = readOption(env, options, "timeBudgetMs", job->config.timeBudgetMs);
+        job->config.seed = static_cast<uint32_t>(readOption(env, options, "seed", 0));
+    }
+
+    napi_value promise;
+    napi_value resourceName;
+    NAPI_CALL(env, napi_create_promise(env, &job->deferred, &promise));
+    NAPI_CALL(env, napi_create_string_utf8(env, "vrpSolve", NAPI_AUTO_LENGTH, &resourceName));
+    NAPI_CALL(env, napi_create_async_work(env, nullptr, resourceName, executeSolve, completeSolve, job.get(), &job->work));
+    NAPI_CALL(env, napi_queue_async_work(env, job->work));
+    job.release();
+    return promise;
+}
+
+napi_value Metrics(napi_env env, napi_callback_info) {
+    MetricsSnapshot snapshot = snapshotMetrics();
+    napi_value object;
+    NAPI_CALL(env, napi_create_object(env, &object));
+    napi_set_named_property(env, object, "threads", makeNumber(env, snapshot.threads));
+    napi_set_named_property(env, object, "iterations", makeNumber(env, static_cast<double>(snapshot.iterations)));
+    napi_set_named_property(env, object, "accepted", makeNumber(env, static_cast<double>(snapshot.accepted)));
+    napi_set_named_property(env, object, "improved", makeNumber(env, static_cast<double>(snapshot.improved)));
+    napi_set_named_property(env, object, "cyclesPerNs", makeNumber(env, snapshot.cyclesPerNs));
+
+    napi_value phases;
+    napi_create_object(env, &phases);
+    for (int p = 0; p < kNumLnsPhases; ++p) {
+        const PhaseTotals& totals = snapshot.phases[p];
+        napi_value phase;
+        napi_create_object(env, &phase);
+        napi_set_named_property(env, phase, "calls", makeNumber(env, static_cast<double>(totals.calls)));
+        napi_set_named_property(env, phase, "cycles", makeNumber(env, static_cast<double>(totals.cycles)));
+        napi_set_named_property(env, phase, "ms", makeNumber(env, totals.ms));
+        napi_set_named_property(env, phase, "p50Ns", makeNumber(env, totals.p50Ns));
+        napi_set_named_property(env, phase, "p99Ns", makeNumber(env, totals.p99Ns));
+        napi_set_named_property(env, phase, "p999Ns", makeNumber(env, totals.p999Ns));
+        napi_set_named_property(env, phases, lnsPhaseName(static_cast<LnsPhase>(p)), phase);
+    }
+    napi_set_named_property(env, object, "phases", phases);
+
+    napi_value counters;
+    napi_create_object(env, &counters);
+    for (const auto& counter : snapshot.operatorCounters) {
+        napi_set_named_property(env, counters, counter.first.c_str(), makeNumber(env, static_cast<double>(counter.second)));
+    }
+    napi_set_named_property(env, object, "operatorCounters", counters);
+    return object;
+}
+
+}
+
+NAPI_MODULE_INIT() {
+    napi_value solve;
+    napi_value metrics;
+    NAPI_CALL(env, napi_create_function(env, "solve", NAPI_AUTO_LENGTH, Solve, nullptr, &solve));
+    NAPI_CALL(env, napi_set_named_property(env, exports, "solve", solve));
+    NAPI_CALL(env, napi_create_function(env, "metrics", NAPI_AUTO_LENGTH, Metrics, nullptr, &metrics));
+    NAPI_CALL(env, napi_set_named_property(env, exports, "metrics", metrics));
+    return exports;
+}
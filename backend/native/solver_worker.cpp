@@ -0,0 +1,261 @@
+// Long-lived solver process for backend/solver/workerPool.js.
+// Reads length-prefixed frames from stdin and answers each MSG_SOLVE with one MSG_RESULT or MSG_ERROR frame on stdout,
+// optionally preceded by throttled MSG_PROGRESS frames. A MSG_CANCEL stops the running solve early, a MSG_METRICS
+// is answered with a snapshot of the LNS counters (Metrics.h) right away.
+//
+// Threads: the reader thread owns stdin, the main thread runs the solver, and the publisher thread drains
+// progress snapshots from a lock-free ring so the solver never blocks on the pipe.
+//
+// With VRP_TRACE_DIR set, every solve is traced (Trace.h) and written to <dir>/<binary>-<pid>-<requestId>.trace.json
+// (<binary> is the plugin's name in a plugin host)
+// after its result; VRP_TRACE_SAMPLE sets the iteration sampling (default every 64th).
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HeuristicPlugin.h"
+#include "LNS.h"
+#include "Protocol.h"
+#include "SpscRing.h"
+#include "Trace.h"
+
+namespace {
+
+bool readFully(int fd, void* buffer, size_t size) {
+    uint8_t* p = static_cast<uint8_t*>(buffer);
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool writeFully(int fd, const void* buffer, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(buffer);
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+std::mutex stdoutMutex;
+
+bool writeFrame(const ByteWriter& writer) {
+    std::lock_guard<std::mutex> lock(stdoutMutex);
+    uint32_t length = static_cast<uint32_t>(writer.bytes().size());
+    return writeFully(STDOUT_FILENO, &length, sizeof(length)) &&
+           writeFully(STDOUT_FILENO, writer.bytes().data(), length);
+}
+
+struct Inbox {
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::vector<uint8_t>> frames;
+    bool closed = false;
+};
+
+Inbox inbox;
+std::atomic<uint32_t> activeRequestId{0};
+std::atomic<uint32_t> cancelRequestId{0};
+std::atomic<bool> cancelled{false};
+std::atomic<bool> shuttingDown{false};
+SpscRing<ProgressEvent, 16> progressRing;
+std::string tracePrefix; // <dir>/<binary>-<pid>, empty when tracing is off
+// Far above any instance the server accepts (SOLVER_MAX_CUSTOMERS); a longer length means a corrupt stream
+constexpr uint32_t kMaxFrameBytes = 256u << 20;
+
+void readerLoop() {
+    std::vector<uint8_t> payload;
+    uint32_t length = 0;
+    while (readFully(STDIN_FILENO, &length, sizeof(length))) {
+        if (length > kMaxFrameBytes) {
+            break; // The stream is out of sync; shut down like on EOF
+        }
+        payload.resize(length);
+        if (!readFully(STDIN_FILENO, payload.data(), length)) {
+            break;
+        }
+        if (length >= 5 && payload[0] == MSG_CANCEL) {
+            ByteReader reader(payload.data() + 1, payload.size() - 1);
+            uint32_t requestId = reader.read<uint32_t>();
+            // Paired with the main thread storing activeRequestId before reading cancelRequestId
+            cancelRequestId.store(requestId);
+            if (activeRequestId.load() == requestId) {
+                cancelled.store(true);
+            }
+            continue;
+        }
+        if (length >= 5 && payload[0] == MSG_METRICS) {
+            ByteReader reader(payload.data() + 1, payload.size() - 1);
+            ByteWriter writer;
+            encodeMetrics(writer, reader.read<uint32_t>(), snapshotMetrics());
+            writeFrame(writer);
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(inbox.mutex);
+        inbox.frames.push_back(payload);
+        inbox.ready.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(inbox.mutex);
+    inbox.closed = true;
+    cancelled.store(true);
+    inbox.ready.notify_one();
+}
+
+void publisherLoop() {
+    setTraceThreadName("publisher");
+    RouteDeltaState sent;
+    while (!shuttingDown.load()) {
+        ProgressEvent* event = progressRing.front();
+        if (!event) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            continue;
+        }
+        TraceSpan span("publish", event->requestId);
+        ByteWriter writer;
+        encodeProgress(writer, *event, sent);
+        writeFrame(writer);
+        progressRing.pop();
+    }
+}
+
+void solve(const std::vector<uint8_t>& payload) {
+    ByteWriter writer;
+    SolveRequest request;
+    try {
+        ByteReader reader(payload.data(), payload.size());
+        if (reader.read<uint8_t>() != MSG_SOLVE) {
+            throw std::runtime_error("unexpected message type");
+        }
+        decodeSolveRequest(reader, request);
+
+        activeRequestId.store(request.requestId);
+        cancelled.store(cancelRequestId.load() == request.requestId);
+        request.config.cancelled = &cancelled;
+
+        double lastPublishedMs = 0;
+        bool published = false;
+        // Last improvement that was throttled or found the ring full; published after the run
+        bool behind = false;
+        uint64_t behindIteration = 0;
+        double behindMs = 0;
+        if (request.progressIntervalMs > 0) {
+            request.config.onImprovement = [&](const Solution& best, uint64_t iteration, double elapsedMs) {
+                behind = true;
+                behindIteration = iteration;
+                behindMs = elapsedMs;
+                if (published && elapsedMs - lastPublishedMs < request.progressIntervalMs) {
+                    return;
+                }
+                // A full ring means the publisher is behind; the next improvement or the end of the run catches up
+                TraceSpan span("share progress", iteration);
+                ProgressEvent* slot = progressRing.beginPush();
+                if (!slot) {
+                    return;
+                }
+                captureProgress(*slot, request.requestId, best, iteration, elapsedMs);
+                progressRing.commitPush();
+                lastPublishedMs = elapsedMs;
+                published = true;
+                behind = false;
+            };
+        }
+
+        LNSResult result = runLNS(request.instance, request.config);
+        // The last progress frame shows the result's tours, so a live view ends on what the result reports
+        if (behind) {
+            ProgressEvent* slot;
+            while (!(slot = progressRing.beginPush())) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            captureProgress(*slot, request.requestId, result.best, behindIteration, behindMs);
+            progressRing.commitPush();
+        }
+        // Progress frames of this request must reach Node before its result
+        while (!progressRing.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        encodeResult(writer, request.requestId, result);
+    } catch (const std::exception& e) {
+        writer = ByteWriter();
+        encodeError(writer, request.requestId, e.what());
+    }
+    activeRequestId.store(0);
+    writeFrame(writer);
+
+    if (!tracePrefix.empty()) {
+        writeChromeTrace(tracePrefix + "-" + std::to_string(request.requestId) + ".trace.json");
+        clearTrace();
+    }
+}
+
+}
+
+int main(int, char** argv) {
+    if (const char* dir = std::getenv("VRP_TRACE_DIR")) {
+        TraceOptions options;
+        if (const char* sample = std::getenv("VRP_TRACE_SAMPLE")) {
+            options.sampleEvery = static_cast<uint32_t>(std::strtoul(sample, nullptr, 10));
+        }
+        // A plugin host (HeuristicPlugin.h) is named after the heuristic it runs
+        const char* plugin = std::getenv(kHeuristicPluginEnv);
+        std::string binary = plugin && *plugin ? plugin : argv[0];
+        binary = binary.substr(binary.find_last_of('/') + 1);
+        if (binary.size() > 3 && binary.compare(binary.size() - 3, 3, ".so") == 0) {
+            binary.resize(binary.size() - 3);
+        }
+        tracePrefix = std::string(dir) + "/" + binary + "-" + std::to_string(getpid());
+        enableTracing(options);
+        setTraceThreadName("solver");
+    }
+
+    std::thread reader(readerLoop);
+    std::thread publisher(publisherLoop);
+
+    while (true) {
+        std::vector<uint8_t> payload;
+        {
+            std::unique_lock<std::mutex> lock(inbox.mutex);
+            inbox.ready.wait(lock, [] { return inbox.closed || !inbox.frames.empty(); });
+            if (inbox.frames.empty()) {
+                break;
+            }
+            payload = std::move(inbox.frames.front());
+            inbox.frames.pop_front();
+        }
+        solve(payload);
+    }
+
+    shuttingDown.store(true);
+    publisher.join();
+    reader.join();
+    return 0;
+}
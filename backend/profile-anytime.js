@@ -0,0 +1,311 @@
+/**
+ * Anytime Quality Profiling
+ * Runs every optimized heuristic's LNS (backend/native/anytime_profile.cpp)
+ * on synthetic instances and optional CVRPLIB files, once per seed, and
+ * records the best objective over wall time. Each curve is scored against
+ * the best objective known for its instance (over all heuristics profiled
+ * so far):
+ *   gap(t)          |f(t) - best| / max(|f(t)|, |best|), 1 before the first solution
+ *   primalIntegral  integral of gap(t) over the budget, in gap x seconds
+ *   meanGap         primalIntegral / budget, 0 = optimal from the start
+ *   gapAt<ms>       gap at each checkpoint (the SLA candidates)
+ *   timeTo1Pct/5Pct first time the gap falls to 1% / 5%
+ * and the metrics are averaged over seeds and instances per heuristic.
+ *
+ * Usage: node profile-anytime.js [options]
+ *   --types cvrp,pcvrp,vrptw        problem variants to include
+ *   --sets optimized,population     heuristic sets to include (default optimized)
+ *   --filter <text>                 only heuristics whose name contains text
+ *   --sizes 100,1000                synthetic instance sizes
+ *   --families uniform,clustered    synthetic instance families
+ *   --instance <file.vrp>           CVRPLIB instance, repeatable
+ *   --seeds <n>|<a,b,c>             number of seeds (1..n) or explicit list (default 3)
+ *   --budget-ms <ms>                wall-clock budget per run (default 2000)
+ *   --checkpoints 100,500,1000      times at which the gap is reported (default 100,500,1000,budget)
+ *   --out-dir <dir>                 reports (default build/profile)
+ *   --local-search                  polish every candidate with the granular local search
+ *   --acceptance greedy|sa|rrt|lahc acceptance criterion of the LNS (default greedy)
+ *
+ * Writes per heuristic <out-dir>/<type>/<name>.json (curves and metrics) and
+ * .csv (one row per run), and <out-dir>/summary.{json,csv} ranking all
+ * heuristics by mean primal integral.
+ */
+
+const { execFile } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+const { promisify } = require('util');
+const { compileHeuristic } = require('./solver/compiler');
+const { listHeuristics } = require('./benchmark-operators');
+
+const execFileAsync = promisify(execFile);
+
+const colors = {
+  reset: '\x1b[0m',
+  green: '\x1b[32m',
+  red: '\x1b[31m',
+  yellow: '\x1b[33m',
+  blue: '\x1b[36m',
+  bold: '\x1b[1m'
+};
+
+function log(message, color = 'reset') {
+  console.log(`${colors[color]}${message}${colors.reset}`);
+}
+
+function parseArgs(argv) {
+  const options = {
+    types: ['cvrp', 'pcvrp', 'vrptw'],
+    sets: ['optimized'],
+    filter: '',
+    sizes: '100,1000',
+    families: 'uniform,clustered',
+    instances: [],
+    seeds: [1, 2, 3],
+    budgetMs: 2000,
+    checkpoints: null,
+    outDir: path.join(__dirname, 'build', 'profile'),
+    localSearch: false,
+    acceptance: 'greedy'
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const value = argv[i + 1];
+    switch (argv[i]) {
+      case '--types': options.types = value.split(','); i++; break;
+      case '--sets': options.sets = value.split(','); i++; break;
+      case '--filter': options.filter = value; i++; break;
+      case '--sizes': options.sizes = value; i++; break;
+      case '--families': options.families = value; i++; break;
+      case '--instance': options.instances.push(path.resolve(value)); i++; break;
+      case '--seeds':
+        options.seeds = value.includes(',')
+          ? value.split(',').map(seed => parseInt(seed, 10))
+          : Array.from({ length: parseInt(value, 10) }, (_, k) => k + 1);
+        i++;
+        break;
+      case '--budget-ms': options.budgetMs = parseFloat(value); i++; break;
+      case '--checkpoints': options.checkpoints = value.split(',').map(parseFloat); i++; break;
+      case '--out-dir': options.outDir = path.resolve(value); i++; break;
+      case '--local-search': options.localSearch = true; break;
+      case '--acceptance': options.acceptance = value; i++; break;
+      default: throw new Error(`Unknown option ${argv[i]}`);
+    }
+  }
+  if (!options.checkpoints) {
+    options.checkpoints = [100, 500, 1000, options.budgetMs];
+  }
+  options.checkpoints = [...new Set(options.checkpoints.filter(t => t <= options.budgetMs))].sort((a, b) => a - b);
+  return options;
+}
+
+// Runs of one heuristic: { instance, numCustomers, seed, iterations, elapsedMs, timesMs, objectives }
+async function profileHeuristic(heuristic, options) {
+  const binary = await compileHeuristic(heuristic, 'profile');
+  const args = [
+    `--type=${heuristic.type}`,
+    `--sizes=${options.sizes}`,
+    `--families=${options.families}`,
+    ...options.instances.map(file => `--instance=${file}`),
+    `--seeds=${options.seeds.join(',')}`,
+    `--budget-ms=${options.budgetMs}`,
+    ...(options.localSearch ? ['--local-search'] : []),
+    `--acceptance=${options.acceptance}`
+  ];
+  const numInstances = options.sizes.split(',').length * options.families.split(',').length + options.instances.length;
+  // Generous allowance for instance construction on top of the run budgets
+  const timeout = numInstances * options.seeds.length * options.budgetMs * 3 + 60000;
+  const { stdout } = await execFileAsync(binary, args, { timeout, maxBuffer: 256 * 1024 * 1024 });
+  return stdout.split('\n').filter(Boolean).map(line => JSON.parse(line)).filter(line => line.objectives);
+}
+
+const instanceKey = run => `${run.instance}/${run.numCustomers}`;
+
+function primalGap(objective, best) {
+  if (objective === best) return 0;
+  if (objective * best < 0) return 1;
+  return Math.abs(objective - best) / Math.max(Math.abs(objective), Math.abs(best));
+}
+
+// Gap of the best-objective step function at time t (1 before the first solution)
+function gapAt(run, best, t) {
+  let gap = 1;
+  for (let i = 0; i < run.timesMs.length && run.timesMs[i] <= t; i++) {
+    gap = primalGap(run.objectives[i], best);
+  }
+  return gap;
+}
+
+function timeToGap(run, best, target) {
+  for (let i = 0; i < run.timesMs.length; i++) {
+    if (primalGap(run.objectives[i], best) <= target) return run.timesMs[i];
+  }
+  return null;
+}
+
+function runMetrics(run, best, options) {
+  // Integral of the step function over [0, budget]
+  let integral = 0;
+  let previousTime = 0;
+  let previousGap = 1;
+  for (let i = 0; i < run.timesMs.length && run.timesMs[i] < options.budgetMs; i++) {
+    integral += previousGap * (run.timesMs[i] - previousTime);
+    previousTime = run.timesMs[i];
+    previousGap = primalGap(run.objectives[i], best);
+  }
+  integral += previousGap * (options.budgetMs - previousTime);
+
+  const metrics = {
+    instance: run.instance,
+    numCustomers: run.numCustomers,
+    seed: run.seed,
+    bestKnown: best,
+    finalObjective: run.objectives.length ? run.objectives[run.objectives.length - 1] : null,
+    iterations: run.iterations,
+    primalIntegral: integral / 1000,
+    meanGap: integral / options.budgetMs
+  };
+  for (const t of options.checkpoints) {
+    metrics[`gapAt${t}ms`] = gapAt(run, best, t);
+  }
+  metrics.timeTo5Pct = timeToGap(run, best, 0.05);
+  metrics.timeTo1Pct = timeToGap(run, best, 0.01);
+  return metrics;
+}
+
+const mean = values => values.reduce((sum, v) => sum + v, 0) / values.length;
+
+function std(values) {
+  const m = mean(values);
+  return Math.sqrt(values.reduce((sum, v) => sum + (v - m) ** 2, 0) / Math.max(values.length - 1, 1));
+}
+
+// Means over all runs; times to a gap are averaged over the runs that reached it
+function aggregate(rows, options) {
+  const summary = {
+    runs: rows.length,
+    primalIntegral: mean(rows.map(r => r.primalIntegral)),
+    meanGap: mean(rows.map(r => r.meanGap)),
+    meanGapStd: std(rows.map(r => r.meanGap))
+  };
+  for (const t of options.checkpoints) {
+    summary[`gapAt${t}ms`] = mean(rows.map(r => r[`gapAt${t}ms`]));
+  }
+  for (const key of ['timeTo5Pct', 'timeTo1Pct']) {
+    const reached = rows.map(r => r[key]).filter(v => v !== null);
+    summary[key] = reached.length ? mean(reached) : null;
+    summary[`${key}Reached`] = reached.length / rows.length;
+  }
+  return summary;
+}
+
+function toCsv(rows) {
+  const columns = Object.keys(rows[0]);
+  const cell = value => value === null || value === undefined ? '' :
+    typeof value === 'number' ? String(Number(value.toPrecision(6))) : `"${String(value).replace(/"/g, '""')}"`;
+  return [columns.join(','), ...rows.map(row => columns.map(c => cell(row[c])).join(','))].join('\n') + '\n';
+}
+
+// Best objective per type and instance over this and earlier profiling runs, so partial reruns keep a fair reference
+function loadBestKnown(options) {
+  const file = path.join(options.outDir, 'best-known.json');
+  return fs.existsSync(file) ? JSON.parse(fs.readFileSync(file, 'utf8')) : {};
+}
+
+function saveBestKnown(options, bestKnown) {
+  fs.writeFileSync(path.join(options.outDir, 'best-known.json'), JSON.stringify(bestKnown, null, 2));
+}
+
+async function runProfiling() {
+  const options = parseArgs(process.argv.slice(2));
+  const heuristics = listHeuristics(options);
+  log(`\nProfiling ${heuristics.length} heuristics on ${options.families} x ${options.sizes}` +
+      (options.instances.length ? ` and ${options.instances.length} instance files` : '') +
+      `, ${options.seeds.length} seeds x ${options.budgetMs} ms`, 'bold');
+
+  // Runs one at a time so that wall-clock curves are not skewed by each other
+  const profiled = [];
+  for (const heuristic of heuristics) {
+    try {
+      profiled.push({ heuristic, runs: await profileHeuristic(heuristic, options) });
+      log(`✓ ${heuristic.name}`, 'green');
+    } catch (error) {
+      const reason = error.killed ? 'timed out' : (error.stderr || error.message).split('\n')[0];
+      log(`✗ ${heuristic.name}: ${reason}`, 'red');
+    }
+  }
+
+  fs.mkdirSync(options.outDir, { recursive: true });
+  const bestKnown = loadBestKnown(options);
+  for (const { heuristic, runs } of profiled) {
+    const references = bestKnown[heuristic.type] = bestKnown[heuristic.type] || {};
+    for (const run of runs) {
+      const final = run.objectives[run.objectives.length - 1];
+      const key = instanceKey(run);
+      if (final !== undefined && (references[key] === undefined || final < references[key])) {
+        references[key] = final;
+      }
+    }
+  }
+  saveBestKnown(options, bestKnown);
+
+  const summaries = [];
+  for (const { heuristic, runs } of profiled) {
+    const rows = runs.map(run => runMetrics(run, bestKnown[heuristic.type][instanceKey(run)], options));
+    const byInstance = {};
+    for (const key of [...new Set(runs.map(instanceKey))]) {
+      byInstance[key] = aggregate(rows.filter(row => `${row.instance}/${row.numCustomers}` === key), options);
+    }
+    const summary = { name: heuristic.name, type: heuristic.type, ...aggregate(rows, options) };
+    summaries.push(summary);
+
+    const dir = path.join(options.outDir, heuristic.type);
+    fs.mkdirSync(dir, { recursive: true });
+    fs.writeFileSync(path.join(dir, `${heuristic.name}.json`), JSON.stringify({
+      name: heuristic.name,
+      source: path.relative(path.join(__dirname, '..'), heuristic.source),
+      budgetMs: options.budgetMs,
+      summary,
+      byInstance,
+      runs: runs.map((run, i) => ({ ...rows[i], timesMs: run.timesMs, objectives: run.objectives }))
+    }));
+    fs.writeFileSync(path.join(dir, `${heuristic.name}.csv`), toCsv(rows));
+  }
+
+  summaries.sort((a, b) => a.type.localeCompare(b.type) || a.primalIntegral - b.primalIntegral);
+  if (summaries.length) {
+    fs.writeFileSync(path.join(options.outDir, 'summary.json'), JSON.stringify({
+      date: new Date().toISOString(),
+      options: { ...options, outDir: undefined },
+      heuristics: summaries
+    }, null, 2));
+    fs.writeFileSync(path.join(options.outDir, 'summary.csv'), toCsv(summaries));
+  }
+
+  console.log('\n' + '='.repeat(90));
+  log('Anytime Profile Summary (mean over seeds and instances, ranked by primal integral)', 'bold');
+  console.log('='.repeat(90));
+  console.log('Heuristic'.padEnd(24) + 'integral'.padStart(10) + 'mean gap'.padStart(10) +
+    options.checkpoints.map(t => `@${t}ms`.padStart(10)).join('') + 'to 1%'.padStart(12));
+  for (const summary of summaries) {
+    const percent = value => `${(value * 100).toFixed(2)}%`.padStart(10);
+    const reached = summary.timeTo1Pct === null ? '-' :
+      `${summary.timeTo1Pct.toFixed(0)}ms${summary.timeTo1PctReached < 1 ? '*' : ''}`;
+    console.log(summary.name.padEnd(24) + summary.primalIntegral.toFixed(4).padStart(10) + percent(summary.meanGap) +
+      options.checkpoints.map(t => percent(summary[`gapAt${t}ms`])).join('') + reached.padStart(12));
+  }
+  console.log('='.repeat(90));
+  log('* not every run reached the gap', 'yellow');
+  log(`\nReports written to ${path.relative(process.cwd(), options.outDir)}`, 'blue');
+  if (profiled.length < heuristics.length) {
+    process.exitCode = 1;
+  }
+}
+
+if (require.main === module) {
+  runProfiling().catch(error => {
+    console.error('Profiling error:', error);
+    process.exit(1);
+  });
+}
+
+module.exports = { parseArgs, profileHeuristic, runMetrics, aggregate };
@@ -0,0 +1,113 @@
+/**
+ * Evaluation Ranking
+ * Ranks individuals across generations from their evaluation stores
+ * (solver/evaluationStore.js), without running anything. Only the latest
+ * row of each individual counts, and only individuals evaluated with the
+ * same settings are ranked against each other: one ranking per problem
+ * type and settings.
+ *
+ * Usage: node rank-evaluations.js [options] [store or population dir ...]
+ *   --types cvrp,pcvrp,vrptw        problem variants to include
+ *   --top 10                        rows shown per ranking
+ *   --json <file>                   also write the full rankings
+ *
+ * Without paths, every generated_heuristics/<type>/<population>/evaluations.store is read.
+ */
+
+const fs = require('fs');
+const path = require('path');
+const { HEURISTICS_DIR } = require('./solver/compiler');
+const { STORE_FILE, loadStore, latestRows } = require('./solver/evaluationStore');
+
+const colors = {
+  reset: '\x1b[0m',
+  green: '\x1b[32m',
+  red: '\x1b[31m',
+  yellow: '\x1b[33m',
+  blue: '\x1b[36m',
+  bold: '\x1b[1m'
+};
+
+function log(message, color = 'reset') {
+  console.log(`${colors[color]}${message}${colors.reset}`);
+}
+
+function parseArgs(argv) {
+  const options = { types: ['cvrp', 'pcvrp', 'vrptw'], top: 10, json: null, paths: [] };
+  for (let i = 0; i < argv.length; i++) {
+    const value = argv[i + 1];
+    switch (argv[i]) {
+      case '--types': options.types = value.split(','); i++; break;
+      case '--top': options.top = parseInt(value, 10); i++; break;
+      case '--json': options.json = path.resolve(value); i++; break;
+      default:
+        if (argv[i].startsWith('--')) throw new Error(`Unknown option ${argv[i]}`);
+        options.paths.push(path.resolve(argv[i]));
+    }
+  }
+  return options;
+}
+
+// Store files { file, type, population }; the type is the directory above the population
+function listStores(options) {
+  const stores = options.paths.length
+    ? options.paths.map(file => (fs.statSync(file).isDirectory() ? path.join(file, STORE_FILE) : file))
+    : options.types.flatMap(type => {
+      const typeDir = path.join(HEURISTICS_DIR, type);
+      return fs.existsSync(typeDir) ? fs.readdirSync(typeDir).map(population => path.join(typeDir, population, STORE_FILE)) : [];
+    });
+  return stores
+    .filter(file => fs.existsSync(file))
+    .map(file => ({ file, type: path.basename(path.dirname(path.dirname(file))), population: path.basename(path.dirname(file)) }))
+    .filter(store => options.types.includes(store.type));
+}
+
+function runRanking() {
+  const options = parseArgs(process.argv.slice(2));
+  const started = Date.now();
+  const rankings = new Map();
+  let numRows = 0;
+  for (const { file, type, population } of listStores(options)) {
+    const store = loadStore(file);
+    numRows += store.rows;
+    for (const row of latestRows(store, ['name', 'status', 'fitness', 'error', 'iterationsPerSec', 'maxRssKb']).values()) {
+      const key = `${type} ${JSON.stringify(row.settings)}`;
+      if (!rankings.has(key)) rankings.set(key, { type, settings: row.settings, individuals: [] });
+      rankings.get(key).individuals.push({ ...row, population, settings: undefined });
+    }
+  }
+  log(`\nLoaded ${numRows} rows in ${Date.now() - started} ms`, 'blue');
+
+  for (const ranking of rankings.values()) {
+    ranking.individuals.sort((a, b) => (a.fitness === null) - (b.fitness === null) || a.fitness - b.fitness);
+    const failed = ranking.individuals.filter(row => row.fitness === null).length;
+    log(`\n${ranking.type}: ${ranking.individuals.length} individuals` + (failed ? `, ${failed} without fitness` : ''), 'bold');
+    console.log(`  ${JSON.stringify(ranking.settings)}`);
+    for (const row of ranking.individuals.slice(0, options.top)) {
+      if (row.fitness === null) {
+        log(`  ${row.population}/${row.name}: ${row.status}${row.error ? `, ${row.error}` : ''}`, 'red');
+      } else {
+        console.log(`  ${row.fitness.toFixed(4).padStart(12)}  ${row.population}/${row.name}` +
+          (row.iterationsPerSec ? `  ${Math.round(row.iterationsPerSec)} it/s` : '') +
+          (row.maxRssKb ? `  ${(row.maxRssKb / 1024).toFixed(0)} MB` : ''));
+      }
+    }
+  }
+
+  if (options.json) {
+    fs.mkdirSync(path.dirname(options.json), { recursive: true });
+    fs.writeFileSync(options.json, JSON.stringify([...rankings.values()], null, 2));
+    log(`\nRankings written to ${path.relative(process.cwd(), options.json)}`, 'blue');
+  }
+}
+
+if (require.main === module) {
+  try {
+    runRanking();
+  } catch (error) {
+    console.error('Ranking error:', error);
+    process.exit(1);
+  }
+}
+
+module.exports = { parseArgs, listStores };
@@ -0,0 +1,133 @@
+/**
+ * Decomposition Runs
+ * Solves synthetic instances of 10k-100k customers with the decomposition
+ * solver (backend/native/Decomposition.h) and one optimized heuristic, once
+ * per size and partition method. Reports the time to the first complete
+ * solution, the rounds that fit the budget and the objective after each, so
+ * the scaling in the instance size can be read off directly.
+ *
+ * Usage: node run-decomposition.js [options]
+ *   --type cvrp                     problem variant
+ *   --filter <text>                 first optimized heuristic whose name contains text
+ *   --sizes 10000,20000,50000,100000
+ *   --methods barycenter,sector     partition methods to run
+ *   --family uniform|clustered      synthetic instance family
+ *   --subproblem-size 1000          customers per subproblem, at most
+ *   --subproblem-budget-ms 1000     wall-clock budget per subproblem and round
+ *   --threads 0                     subproblems solved at once (0 = CPU count)
+ *   --budget-ms 60000               wall-clock budget per run
+ *   --seed 1                        LNS seed
+ *   --local-search                  polish subproblem solutions and candidates
+ *   --acceptance greedy|sa|rrt|lahc acceptance criterion of the subproblem runs (default greedy)
+ *
+ * Linux only: the heuristic is loaded as a plugin (solver/compiler.js).
+ */
+
+const { execFile } = require('child_process');
+const { promisify } = require('util');
+const { compileHeuristic, compilePluginHost, pluginHostPath, usePlugins } = require('./solver/compiler');
+const { listHeuristics } = require('./benchmark-operators');
+
+const execFileAsync = promisify(execFile);
+
+const colors = {
+  reset: '\x1b[0m',
+  green: '\x1b[32m',
+  red: '\x1b[31m',
+  yellow: '\x1b[33m',
+  blue: '\x1b[36m',
+  bold: '\x1b[1m'
+};
+
+function log(message, color = 'reset') {
+  console.log(`${colors[color]}${message}${colors.reset}`);
+}
+
+function parseArgs(argv) {
+  const options = {
+    type: 'cvrp',
+    filter: '',
+    sizes: [10000, 20000, 50000, 100000],
+    methods: ['barycenter', 'sector'],
+    family: 'uniform',
+    subproblemSize: 1000,
+    subproblemBudgetMs: 1000,
+    threads: 0,
+    budgetMs: 60000,
+    seed: 1,
+    localSearch: false,
+    acceptance: 'greedy'
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const value = argv[i + 1];
+    switch (argv[i]) {
+      case '--type': options.type = value; i++; break;
+      case '--filter': options.filter = value; i++; break;
+      case '--sizes': options.sizes = value.split(',').map(n => parseInt(n, 10)); i++; break;
+      case '--methods': options.methods = value.split(','); i++; break;
+      case '--family': options.family = value; i++; break;
+      case '--subproblem-size': options.subproblemSize = parseInt(value, 10); i++; break;
+      case '--subproblem-budget-ms': options.subproblemBudgetMs = parseFloat(value); i++; break;
+      case '--threads': options.threads = parseInt(value, 10); i++; break;
+      case '--budget-ms': options.budgetMs = parseFloat(value); i++; break;
+      case '--seed': options.seed = parseInt(value, 10); i++; break;
+      case '--local-search': options.localSearch = true; break;
+      case '--acceptance': options.acceptance = value; i++; break;
+      default: throw new Error(`Unknown option ${argv[i]}`);
+    }
+  }
+  return options;
+}
+
+async function runDecomposition() {
+  const options = parseArgs(process.argv.slice(2));
+  if (!usePlugins()) {
+    throw new Error('the decomposition solver loads its heuristic as a plugin, which needs Linux and SOLVER_LINK unset');
+  }
+  const [heuristic] = listHeuristics({ types: [options.type], sets: ['optimized'], filter: options.filter });
+  if (!heuristic) {
+    throw new Error(`no optimized ${options.type} heuristic matches`);
+  }
+  const [plugin] = await Promise.all([compileHeuristic(heuristic, 'plugin'), compilePluginHost('decompose')]);
+
+  log(`\nDecomposition: ${heuristic.name}, subproblems of ${options.subproblemSize} customers, ` +
+      `${options.budgetMs} ms per run`, 'bold');
+  for (const size of options.sizes) {
+    for (const method of options.methods) {
+      const args = [
+        `--type=${options.type}`,
+        `--size=${size}`,
+        `--family=${options.family}`,
+        `--method=${method}`,
+        `--subproblem-size=${options.subproblemSize}`,
+        `--subproblem-budget-ms=${options.subproblemBudgetMs}`,
+        `--threads=${options.threads}`,
+        `--budget-ms=${options.budgetMs}`,
+        `--seed=${options.seed}`,
+        ...(options.localSearch ? ['--local-search'] : []),
+        `--acceptance=${options.acceptance}`
+      ];
+      const { stdout } = await execFileAsync(pluginHostPath('decompose'), args, {
+        env: { ...process.env, VRP_HEURISTIC_PLUGIN: plugin },
+        timeout: options.budgetMs * 3 + 120000,
+        maxBuffer: 16 * 1024 * 1024
+      });
+      const result = JSON.parse(stdout);
+      const [first] = result.rounds;
+      log(`  ${String(size).padStart(6)} ${method.padEnd(10)}  first solution ${first.objective.toFixed(0).padStart(10)} ` +
+          `after ${(first.elapsedMs / 1000).toFixed(1).padStart(5)} s  ${String(result.rounds.length).padStart(3)} rounds  ` +
+          `objective ${result.objective.toFixed(0).padStart(10)}  ${first.subproblems} subproblems` +
+          (result.feasible ? '' : '  INFEASIBLE'),
+          result.feasible ? 'green' : 'red');
+    }
+  }
+}
+
+if (require.main === module) {
+  runDecomposition().catch(error => {
+    console.error('Decomposition run error:', error.message);
+    process.exit(1);
+  });
+}
+
+module.exports = { parseArgs };
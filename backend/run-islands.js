@@ -0,0 +1,142 @@
+/**
+ * Island-Model Runs
+ * Runs the island-model LNS (backend/native/Islands.h) with the optimized
+ * heuristics of one problem type as operator sets, once per island count,
+ * and reports the final objective and the iteration throughput. Throughput
+ * relative to one island measures how close to linear the islands scale
+ * (each island is one thread; islands only meet in lock-free mailboxes).
+ *
+ * Usage: node run-islands.js [options]
+ *   --type cvrp                     problem variant
+ *   --filter <text>                 only optimized heuristics whose name contains text
+ *   --operators <n>                 use the first n optimized heuristics (default all)
+ *   --islands 1,2,4                 island counts to run (default 1 and the CPU count)
+ *   --topology ring|random          migration topology (default ring)
+ *   --migration-interval 100        iterations between mailbox checks
+ *   --population 4                  solutions per island
+ *   --size 1000                     synthetic instance size
+ *   --family uniform|clustered      synthetic instance family
+ *   --instance <file.vrp>           CVRPLIB instance instead
+ *   --budget-ms 5000                wall-clock budget per run
+ *   --seed 1                        LNS seed
+ *   --local-search                  polish population members and candidates
+ *   --acceptance greedy|sa|rrt|lahc acceptance criterion of every island (default greedy)
+ *
+ * Linux only: operator sets are heuristic plugins (solver/compiler.js).
+ */
+
+const { execFile } = require('child_process');
+const os = require('os');
+const path = require('path');
+const { promisify } = require('util');
+const { compileHeuristic, compilePluginHost, pluginHostPath, usePlugins } = require('./solver/compiler');
+const { listHeuristics } = require('./benchmark-operators');
+
+const execFileAsync = promisify(execFile);
+
+const colors = {
+  reset: '\x1b[0m',
+  green: '\x1b[32m',
+  red: '\x1b[31m',
+  yellow: '\x1b[33m',
+  blue: '\x1b[36m',
+  bold: '\x1b[1m'
+};
+
+function log(message, color = 'reset') {
+  console.log(`${colors[color]}${message}${colors.reset}`);
+}
+
+function parseArgs(argv) {
+  const options = {
+    type: 'cvrp',
+    filter: '',
+    operators: Infinity,
+    islands: [...new Set([1, os.cpus().length])],
+    topology: 'ring',
+    migrationInterval: 100,
+    population: 4,
+    size: 1000,
+    family: 'uniform',
+    instance: null,
+    budgetMs: 5000,
+    seed: 1,
+    localSearch: false,
+    acceptance: 'greedy'
+  };
+  for (let i = 0; i < argv.length; i++) {
+    const value = argv[i + 1];
+    switch (argv[i]) {
+      case '--type': options.type = value; i++; break;
+      case '--filter': options.filter = value; i++; break;
+      case '--operators': options.operators = parseInt(value, 10); i++; break;
+      case '--islands': options.islands = value.split(',').map(n => parseInt(n, 10)); i++; break;
+      case '--topology': options.topology = value; i++; break;
+      case '--migration-interval': options.migrationInterval = parseInt(value, 10); i++; break;
+      case '--population': options.population = parseInt(value, 10); i++; break;
+      case '--size': options.size = parseInt(value, 10); i++; break;
+      case '--family': options.family = value; i++; break;
+      case '--instance': options.instance = path.resolve(value); i++; break;
+      case '--budget-ms': options.budgetMs = parseFloat(value); i++; break;
+      case '--seed': options.seed = parseInt(value, 10); i++; break;
+      case '--local-search': options.localSearch = true; break;
+      case '--acceptance': options.acceptance = value; i++; break;
+      default: throw new Error(`Unknown option ${argv[i]}`);
+    }
+  }
+  return options;
+}
+
+async function runIslands() {
+  const options = parseArgs(process.argv.slice(2));
+  if (!usePlugins()) {
+    throw new Error('the island model loads heuristics as plugins, which needs Linux and SOLVER_LINK unset');
+  }
+  const heuristics = listHeuristics({ types: [options.type], sets: ['optimized'], filter: options.filter })
+    .slice(0, options.operators);
+  if (!heuristics.length) {
+    throw new Error(`no optimized ${options.type} heuristics match`);
+  }
+  const [plugins] = await Promise.all([
+    Promise.all(heuristics.map(heuristic => compileHeuristic(heuristic, 'plugin'))),
+    compilePluginHost('islands')
+  ]);
+
+  log(`\nIsland model: ${heuristics.length} operator sets, ${options.topology} topology, ` +
+      `${options.budgetMs} ms per run`, 'bold');
+  const rows = [];
+  for (const islands of options.islands) {
+    const args = [
+      `--type=${options.type}`,
+      options.instance ? `--instance=${options.instance}` : `--size=${options.size}`,
+      `--family=${options.family}`,
+      `--operators=${plugins.join(',')}`,
+      `--islands=${islands}`,
+      `--topology=${options.topology}`,
+      `--migration-interval=${options.migrationInterval}`,
+      `--population=${options.population}`,
+      `--budget-ms=${options.budgetMs}`,
+      `--seed=${options.seed}`,
+      ...(options.localSearch ? ['--local-search'] : []),
+      `--acceptance=${options.acceptance}`
+    ];
+    const { stdout } = await execFileAsync(pluginHostPath('islands'), args, { timeout: options.budgetMs * 3 + 60000, maxBuffer: 16 * 1024 * 1024 });
+    const result = JSON.parse(stdout);
+    const perSec = result.iterations / result.elapsedMs * 1000;
+    rows.push({ islands, perSec });
+    // Speedup over the single-island run, if the sweep starts with one
+    const speedup = rows[0].islands === 1 ? `  speedup ${(perSec / rows[0].perSec).toFixed(2)}` : '';
+    const migrated = result.perIsland.reduce((sum, island) => sum + island.immigrants, 0);
+    log(`  ${String(islands).padStart(3)} islands  objective ${result.objective.toFixed(2).padStart(12)}  ` +
+        `${Math.round(perSec).toString().padStart(9)} it/s${speedup}  ${migrated} immigrants`, 'green');
+  }
+}
+
+if (require.main === module) {
+  runIslands().catch(error => {
+    console.error('Island run error:', error.message);
+    process.exit(1);
+  });
+}
+
+module.exports = { parseArgs };
@@ -1,9 +1,10 @@
 const express = require('express');
 const cors = require('cors');
 const bodyParser = require('body-parser');
-const { exec } = require('child_process');
-const fs = require('fs');
-const path = require('path');
+const { compileSolver, loadAddon, pluginHostPath, resolveHeuristic, solverFingerprint } = require('./solver/compiler');
+const { createInstance } = require('./solver/instance');
+const { SolveCache, solveKey } = require('./solver/solveCache');
+const { SolverPool, heavyTailPhases } = require('./solver/workerPool');
 
 const app = express();
 const PORT = process.env.PORT || 3001;
@@ -22,8 +23,27 @@ app.use(cors({
 }));
 app.use(bodyParser.json({ limit: '50mb' }));
 
-// Store compiled executables
-const compiledAlgorithms = new Map();
+// Solver backend: 'native' (worker processes), 'addon' (in-process Node-API) or 'mock'
+const SOLVER_MODE = process.env.VRP_SOLVER || 'native';
+const MAX_TIME_BUDGET_MS = 60000;
+// The native solver builds a dense numNodes² float distance matrix: 5000 customers take 100 MB per worker.
+// Larger instances go through the decomposition solver (npm run run:decomposition) instead.
+const MAX_CUSTOMERS = parseInt(process.env.SOLVER_MAX_CUSTOMERS, 10) || 5000;
+const DEPOT = { x: 500, y: 300 };
+const solverPool = new SolverPool({
+  maxWorkers: parseInt(process.env.SOLVER_WORKERS, 10) || undefined,
+  maxQueueLength: parseInt(process.env.SOLVER_QUEUE_LENGTH, 10) || undefined,
+  quarantineMs: parseInt(process.env.SOLVER_QUARANTINE_MS, 10) || undefined,
+  tailRatio: parseFloat(process.env.SOLVER_TAIL_RATIO) || undefined,
+  quarantineHeavyTails: process.env.SOLVER_QUARANTINE_TAILS === '1',
+  pluginHost: pluginHostPath('worker')
+});
+const solveCache = new SolveCache({
+  maxEntries: parseInt(process.env.SOLVE_CACHE_ENTRIES, 10) || undefined,
+  maxDiskBytes: (parseInt(process.env.SOLVE_CACHE_DISK_MB, 10) * 1024 * 1024) || undefined
+});
+// Addons loaded in addon mode, by heuristic, for /api/metrics
+const loadedAddons = new Map();
 
 // Algorithm metadata
 const algorithms = {
@@ -67,7 +87,32 @@ const algorithms = {
 
 // Health check endpoint
 app.get('/api/health', (req, res) => {
-  res.json({ status: 'ok', message: 'VRP Agent Backend is running' });
+  res.json({
+    status: 'ok',
+    message: 'VRP Agent Backend is running',
+    solverMode: SOLVER_MODE,
+    solverPool: solverPool.stats(),
+    solveCache: solveCache.stats()
+  });
+});
+
+// LNS hot-path counters (backend/native/Metrics.h) of every live worker process and loaded addon:
+// iterations, time and latency quantiles per phase (select, sort, reinsert, localSearch, accept,
+// bookkeeping), operator rejection counts, and heavyTail: the operator phases whose p99.9 latency is far
+// above their median.
+// Counters are totals since each process started; a recycled worker takes its counts with it.
+app.get('/api/metrics', async (req, res) => {
+  try {
+    const sources = await solverPool.metrics();
+    for (const [heuristic, addon] of loadedAddons) {
+      const metrics = addon.metrics();
+      sources.push({ heuristic, pid: process.pid, busy: false, addon: true, metrics, heavyTail: heavyTailPhases(metrics, solverPool.tail) });
+    }
+    res.json({ totals: totalMetrics(sources.map(source => source.metrics).filter(Boolean)), sources });
+  } catch (error) {
+    console.error('Error:', error);
+    res.status(500).json({ error: error.message });
+  }
 });
 
 // Get available algorithms
@@ -78,11 +123,15 @@ app.get('/api/algorithms', (req, res) => {
 // Solve VRP problem
 app.post('/api/solve', async (req, res) => {
   try {
-    const { vrpType, algorithmId, parameters } = req.body;
+    const { vrpType, algorithmId } = req.body;
 
-    if (!vrpType || !algorithmId || !parameters) {
+    if (!vrpType || !algorithmId || !req.body.parameters) {
       return res.status(400).json({ error: 'Missing required parameters' });
     }
+    const { parameters, error } = validateParameters(req.body.parameters);
+    if (error) {
+      return res.status(400).json({ error });
+    }
 
     console.log(`Solving ${vrpType} with algorithm ${algorithmId}`);
     console.log('Parameters:', parameters);
@@ -97,34 +146,191 @@ app.post('/api/solve', async (req, res) => {
     res.json({
       success: true,
       solution,
-      metrics: {
-        executionTime,
-        totalDistance: solution.totalDistance,
-        numRoutes: solution.routes.length,
-        avgRouteLength: solution.totalDistance / solution.routes.length,
-        customersServed: solution.routes.reduce((sum, r) => sum + r.customers.length, 0)
-      }
+      metrics: solutionMetrics(solution, executionTime)
     });
 
   } catch (error) {
+    if (error.code === 'QUEUE_FULL') {
+      res.set('Retry-After', '1');
+      return res.status(503).json({ error: error.message });
+    }
     console.error('Error solving VRP:', error);
     res.status(500).json({ error: error.message });
   }
 });
 
-// Generate VRP solution (currently using enhanced mock data)
-async function generateVRPSolution(vrpType, algorithmId, parameters) {
-  // For now, we'll use an enhanced algorithm-specific mock
-  // This will be replaced with actual C++ execution
-  
+// Open solve streams, by streamId, so they can be cancelled from a separate request
+const activeStreams = new Map();
+let nextStreamId = 1;
+
+// Solve VRP problem, streaming incumbent improvements as Server-Sent Events:
+//   start    { streamId, depot, x, y, demand } - base64 little-endian Float32/Int32 arrays indexed by node id
+//            (0 is the depot), so coordinates cross the wire once per instance
+//   progress base64 route delta from the native solver (layout in backend/native/Protocol.h), no JSON
+//   result   { success, cancelled, solution, metrics } (same shape as POST /api/solve)
+//   error    { error }
+// Closing the connection or POST /api/solve/stream/:streamId/cancel stops the solver early.
+app.get('/api/solve/stream', async (req, res) => {
+  const { vrpType, algorithmId } = req.query;
+  if (!vrpType || !algorithmId || !req.query.numCustomers || !req.query.vehicleCapacity || !req.query.numVehicles) {
+    return res.status(400).json({ error: 'Missing required parameters' });
+  }
+  const { parameters, error } = validateParameters(req.query);
+  if (error) {
+    return res.status(400).json({ error });
+  }
+
+  res.writeHead(200, {
+    'Content-Type': 'text/event-stream',
+    'Cache-Control': 'no-cache',
+    Connection: 'keep-alive'
+  });
+  const send = (event, data) => {
+    const line = typeof data === 'string' ? data : JSON.stringify(data);
+    if (!res.destroyed) res.write(`event: ${event}\ndata: ${line}\n\n`);
+  };
+
+  const streamId = String(nextStreamId++);
+  const controller = new AbortController();
+  activeStreams.set(streamId, controller);
+  res.on('close', () => {
+    activeStreams.delete(streamId);
+    controller.abort();
+  });
+
+  console.log(`Streaming ${vrpType} with algorithm ${algorithmId} (stream ${streamId})`);
+  const startTime = Date.now();
+
+  try {
+    const solution = await generateVRPSolution(vrpType, algorithmId, parameters, {
+      signal: controller.signal,
+      onStart: customers => send('start', { streamId, depot: DEPOT, ...encodeNodes(customers) }),
+      onProgress: progress => send('progress', progress.routeDelta.toString('base64'))
+    });
+
+    send('result', {
+      success: true,
+      cancelled: Boolean(solution.cancelled),
+      solution,
+      metrics: solutionMetrics(solution, Date.now() - startTime)
+    });
+  } catch (error) {
+    if (error.code !== 'CANCELLED') {
+      console.error('Error streaming VRP solution:', error);
+    }
+    send('error', { error: error.message, code: error.code });
+  }
+  activeStreams.delete(streamId);
+  res.end();
+});
+
+// Stop a running stream; it still ends with a result event carrying the best solution so far
+app.post('/api/solve/stream/:streamId/cancel', (req, res) => {
+  const controller = activeStreams.get(req.params.streamId);
+  if (!controller) {
+    return res.status(404).json({ error: 'Unknown stream' });
+  }
+  controller.abort();
+  res.json({ success: true });
+});
+
+// Parses the instance size parameters of a solve request (JSON body or query string) and bounds them.
+// numVehicles only limits the routes of the mock solver: the native solver opens as many tours as the
+// capacities need, so it is neither passed to it nor part of the solve cache key.
+// Returns { parameters } or { error }.
+function validateParameters(raw) {
+  const integer = value => (typeof value === 'number' || /^\s*\d+\s*$/.test(String(value)) ? Number(value) : NaN);
+  const parameters = {
+    numCustomers: integer(raw.numCustomers),
+    vehicleCapacity: integer(raw.vehicleCapacity),
+    numVehicles: integer(raw.numVehicles),
+    timeBudgetMs: raw.timeBudgetMs,
+    seed: raw.seed,
+    instanceSeed: raw.instanceSeed
+  };
+  if (!Number.isInteger(parameters.numCustomers) || parameters.numCustomers < 1 || parameters.numCustomers > MAX_CUSTOMERS) {
+    return { error: `numCustomers must be an integer between 1 and ${MAX_CUSTOMERS}` };
+  }
+  if (!Number.isInteger(parameters.vehicleCapacity) || parameters.vehicleCapacity < 1) {
+    return { error: 'vehicleCapacity must be a positive integer' };
+  }
+  if (!Number.isInteger(parameters.numVehicles) || parameters.numVehicles < 1 || parameters.numVehicles > parameters.numCustomers) {
+    return { error: 'numVehicles must be an integer between 1 and numCustomers' };
+  }
+  return { parameters };
+}
+
+function encodeNodes(customers) {
+  const x = new Float32Array(customers.length + 1);
+  const y = new Float32Array(customers.length + 1);
+  const demand = new Int32Array(customers.length + 1);
+  x[0] = DEPOT.x;
+  y[0] = DEPOT.y;
+  customers.forEach((customer, i) => {
+    x[i + 1] = customer.x;
+    y[i + 1] = customer.y;
+    demand[i + 1] = customer.demand;
+  });
+  const base64 = array => Buffer.from(array.buffer).toString('base64');
+  return { x: base64(x), y: base64(y), demand: base64(demand) };
+}
+
+// Sums counter snapshots and adds each phase's share of the measured time and its cost per iteration
+function totalMetrics(snapshots) {
+  const totals = { iterations: 0, accepted: 0, improved: 0, phases: {}, operatorCounters: {} };
+  for (const snapshot of snapshots) {
+    totals.iterations += snapshot.iterations;
+    totals.accepted += snapshot.accepted;
+    totals.improved += snapshot.improved;
+    for (const [name, phase] of Object.entries(snapshot.phases)) {
+      const total = totals.phases[name] = totals.phases[name] || { calls: 0, ms: 0 };
+      total.calls += phase.calls;
+      total.ms += phase.ms;
+    }
+    for (const [name, count] of Object.entries(snapshot.operatorCounters)) {
+      totals.operatorCounters[name] = (totals.operatorCounters[name] || 0) + count;
+    }
+  }
+  const phaseMs = Object.values(totals.phases).reduce((sum, phase) => sum + phase.ms, 0);
+  for (const phase of Object.values(totals.phases)) {
+    phase.share = phaseMs > 0 ? phase.ms / phaseMs : 0;
+    phase.usPerIteration = totals.iterations > 0 ? phase.ms * 1000 / totals.iterations : 0;
+  }
+  return totals;
+}
+
+function solutionMetrics(solution, executionTime) {
+  return {
+    executionTime,
+    totalDistance: solution.totalDistance,
+    numRoutes: solution.routes.length,
+    avgRouteLength: solution.totalDistance / solution.routes.length,
+    customersServed: solution.routes.reduce((sum, r) => sum + r.customers.length, 0)
+  };
+}
+
+// Generate VRP solution with the native heuristic, or enhanced mock data if it is unavailable
+// stream (optional): { onStart(customers), onProgress(progress), signal } for /api/solve/stream
+async function generateVRPSolution(vrpType, algorithmId, parameters, stream = {}) {
   const { numCustomers, vehicleCapacity, numVehicles } = parameters;
   
   // Parse algorithm score from ID
   const scoreMatch = algorithmId.match(/(\d+\.\d+)/);
   const algorithmScore = scoreMatch ? parseFloat(scoreMatch[1]) : 40.0;
   
-  // Generate customers with spatial clustering
-  const customers = generateCustomers(numCustomers, algorithmScore);
+  // Generate customers with spatial clustering; an instanceSeed makes the instance (and the solve) reproducible
+  const random = parameters.instanceSeed !== undefined ? seededRandom(parseInt(parameters.instanceSeed, 10) || 0) : Math.random;
+  const customers = generateCustomers(numCustomers, algorithmScore, random);
+  if (stream.onStart) stream.onStart(customers);
+  
+  if (SOLVER_MODE !== 'mock' && resolveHeuristic(vrpType, algorithmId)) {
+    try {
+      return await solveNative(vrpType, algorithmId, customers, parameters, stream);
+    } catch (error) {
+      if (error.code === 'QUEUE_FULL' || error.code === 'CANCELLED') throw error;
+      console.warn(`Native solver failed, falling back to mock routes: ${error.message}`);
+    }
+  }
   
   // Create routes using a simple nearest neighbor heuristic
   const routes = createRoutes(customers, numVehicles, vehicleCapacity, algorithmScore);
@@ -140,7 +346,90 @@ async function generateVRPSolution(vrpType, algorithmId, parameters) {
   };
 }
 
-function generateCustomers(numCustomers, algorithmScore) {
+// Run the compiled heuristic (pooled worker or in-process addon) and map its tours back to customers.
+// Reproducible requests (parameters.instanceSeed) go through the solve cache.
+async function solveNative(vrpType, algorithmId, customers, parameters, stream = {}) {
+  const timeBudgetMs = Math.min(parseInt(parameters.timeBudgetMs, 10) || 1000, MAX_TIME_BUDGET_MS);
+  const reproducible = parameters.instanceSeed !== undefined;
+  const seed = parseInt(parameters.seed, 10) || (reproducible ? 0 : Math.floor(Math.random() * 0xffffffff));
+
+  const instance = createInstance(vrpType, customers, {
+    vehicleCapacity: parameters.vehicleCapacity,
+    depot: DEPOT,
+    random: reproducible ? seededRandom(parseInt(parameters.instanceSeed, 10) + 1) : Math.random
+  });
+  // A cached run is shared by identical requests and only cancelled once all of them have given up
+  const run = (warmStart, signal) => runSolver(vrpType, algorithmId, instance, { timeBudgetMs, seed, warmStart, stream: { ...stream, signal } });
+  const entry = reproducible
+    ? await solveCache.solve(solveKey(instance, solverFingerprint(resolveHeuristic(vrpType, algorithmId)), seed), timeBudgetMs, run, stream.signal)
+    : await run(null, stream.signal);
+  const { result } = entry;
+
+  const routes = result.tours.map((tour, id) => ({
+    id,
+    customers: tour.customers.map(c => customers[c - 1]),
+    load: tour.demand,
+    distance: tour.distance
+  }));
+
+  return {
+    routes,
+    totalDistance: routes.reduce((sum, route) => sum + route.distance, 0),
+    objective: result.objective,
+    iterations: result.iterations,
+    solverTimeMs: result.elapsedMs,
+    convergence: entry.trace,
+    cancelled: Boolean(result.cancelled),
+    cached: Boolean(entry.cached),
+    warmStarted: Boolean(entry.warmStarted),
+    algorithmId,
+    vrpType
+  };
+}
+
+// One solver run; resolves with a solve cache entry { result, trace, timeBudgetMs }.
+// trace lists [elapsedMs, iteration, objective] per improvement. A warm start (cached entry of the same
+// instance with a smaller budget) only spends the remaining budget, continuing from the cached best tours.
+// Streaming requests always go to the worker pool, which supports progress and cancellation.
+async function runSolver(vrpType, algorithmId, instance, { timeBudgetMs, seed, warmStart, stream }) {
+  if (SOLVER_MODE === 'addon' && !stream.onProgress) {
+    const addon = await loadAddon(vrpType, algorithmId);
+    loadedAddons.set(`${vrpType}_${algorithmId.replace('best_solution_', '')}`, addon);
+    const result = await addon.solve(instance, { timeBudgetMs, seed });
+    return { result, trace: [[result.elapsedMs, result.iterations, result.objective]], timeBudgetMs };
+  }
+
+  const base = warmStart ? warmStart.result : { elapsedMs: 0, iterations: 0 };
+  const trace = warmStart ? [...warmStart.trace] : [];
+  const binary = await compileSolver(vrpType, algorithmId);
+  const result = await solverPool.solve(binary, instance, {
+    timeBudgetMs: timeBudgetMs - (warmStart ? warmStart.timeBudgetMs : 0),
+    seed,
+    initialTours: warmStart ? warmStart.result.tours.map(tour => tour.customers) : undefined,
+    signal: stream.signal,
+    onProgress: progress => {
+      trace.push([base.elapsedMs + progress.elapsedMs, base.iterations + progress.iteration, progress.objective]);
+      if (stream.onProgress) stream.onProgress(progress);
+    }
+  });
+  result.elapsedMs += base.elapsedMs;
+  result.iterations += base.iterations;
+  return { result, trace, timeBudgetMs, warmStarted: Boolean(warmStart) };
+}
+
+// Mulberry32: small deterministic PRNG for reproducible instances
+function seededRandom(seed) {
+  let state = seed >>> 0;
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0;
+    let t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+function generateCustomers(numCustomers, algorithmScore, random = Math.random) {
   const customers = [];
   const numClusters = Math.floor(numCustomers / 10) + 1;
   const clusters = [];
@@ -148,22 +437,22 @@ function generateCustomers(numCustomers, algorithmScore) {
   // Generate cluster centers
   for (let i = 0; i < numClusters; i++) {
     clusters.push({
-      x: Math.random() * 700 + 150,
-      y: Math.random() * 400 + 100
+      x: random() * 700 + 150,
+      y: random() * 400 + 100
     });
   }
   
   // Generate customers around clusters
   for (let i = 0; i < numCustomers; i++) {
     const cluster = clusters[i % numClusters];
-    const angle = Math.random() * Math.PI * 2;
-    const distance = Math.random() * 80 + 20;
+    const angle = random() * Math.PI * 2;
+    const distance = random() * 80 + 20;
     
     customers.push({
       id: i + 1,
       x: cluster.x + Math.cos(angle) * distance,
       y: cluster.y + Math.sin(angle) * distance,
-      demand: Math.floor(Math.random() * 15) + 5
+      demand: Math.floor(random() * 15) + 5
     });
   }
   
@@ -248,6 +537,7 @@ if (process.env.NODE_ENV !== 'production') {
     console.log(`   GET  /api/health - Health check`);
     console.log(`   GET  /api/algorithms - List available algorithms`);
     console.log(`   POST /api/solve - Solve VRP problem`);
+    console.log(`   GET  /api/solve/stream - Solve VRP problem with live progress (SSE)`);
   });
 }
 
@@ -0,0 +1,370 @@
+/**
+ * Builds native solvers per generated heuristic: a worker executable
+ * (backend/build/solvers), a Node-API addon (backend/build/addons), a
+ * Google Benchmark operator benchmark (backend/build/bench), an anytime
+ * profiler (backend/build/profile), the native test driver
+ * (backend/build/tests) or a plugin (backend/build/plugins).
+ * The heuristic's select_by_llm_1 / sort_by_llm_1 are linked against the
+ * framework in backend/native.
+ *
+ * Every translation unit is compiled into a content-addressed object,
+ * backend/build/obj/<hash>.o, keyed by the compiler, the flags, the source
+ * and the framework headers; heuristics are compiled with the precompiled
+ * native/HeuristicPch.h. A rebuild therefore only recompiles what changed.
+ * A plugin is a shared object holding nothing but the heuristic; it runs
+ * in a prebuilt plugin host (native/HeuristicPlugin.h), which the worker
+ * pool and evaluate-generation.js use on Linux unless SOLVER_LINK=static.
+ */
+
+const { exec } = require('child_process');
+const crypto = require('crypto');
+const { promisify } = require('util');
+const fs = require('fs');
+const path = require('path');
+
+const execAsync = promisify(exec);
+
+const NATIVE_DIR = path.join(__dirname, '..', 'native');
+const HEURISTICS_DIR = path.join(__dirname, '..', '..', 'generated_heuristics');
+const BUILD_DIR = path.join(__dirname, '..', 'build');
+const NODE_INCLUDE_DIR = process.env.NODE_INCLUDE_DIR ||
+  path.join(path.dirname(process.execPath), '..', 'include', 'node');
+
+const FRAMEWORK_SOURCES = ['Instance.cpp', 'Solution.cpp', 'Utils.cpp', 'LNS.cpp', 'Protocol.cpp', 'InstanceFactory.cpp', 'CycleClock.cpp', 'Metrics.cpp', 'Trace.cpp', 'Islands.cpp', 'TaskScheduler.cpp', 'Speculative.cpp', 'Decomposition.cpp', 'LocalSearch.cpp', 'Acceptance.cpp'];
+const CXX = process.env.CXX || 'g++';
+const CXXFLAGS = '-O2 -std=c++17 -pthread';
+const OBJECT_DIR = path.join(BUILD_DIR, 'obj');
+const PCH_HEADER = 'HeuristicPch.h';
+// A heuristic that declares the framework's structs itself cannot have the framework header force-included
+const OWN_DECLARATIONS = /^\s*struct\s+(Tour|Instance|Solution)\s*\{/m;
+const PLUGIN_ENV = 'VRP_HEURISTIC_PLUGIN';
+const UNDEFINED_DYNAMIC_LOOKUP = process.platform === 'darwin' ? ' -undefined dynamic_lookup' : '';
+
+const TARGETS = {
+  worker: {
+    label: 'solver',
+    dir: 'solvers',
+    suffix: '',
+    entry: 'solver_worker.cpp',
+    flags: '',
+    linkFlags: '',
+    libs: ''
+  },
+  addon: {
+    label: 'addon',
+    dir: 'addons',
+    suffix: '.node',
+    entry: 'solver_addon.cpp',
+    flags: `-fPIC -I "${NODE_INCLUDE_DIR}"`,
+    linkFlags: `-shared${UNDEFINED_DYNAMIC_LOOKUP}`,
+    libs: ''
+  },
+  bench: {
+    label: 'benchmark',
+    dir: 'bench',
+    suffix: '',
+    entry: 'operator_bench.cpp',
+    flags: '',
+    linkFlags: '',
+    libs: '-lbenchmark'
+  },
+  profile: {
+    label: 'profiler',
+    dir: 'profile',
+    suffix: '',
+    entry: 'anytime_profile.cpp',
+    sources: ['Sandbox.cpp'],
+    flags: '',
+    linkFlags: '',
+    libs: ''
+  },
+  // Plugin host only (compilePluginHost): loads every operator set of the island model as a plugin
+  islands: {
+    label: 'island solver',
+    dir: 'islands',
+    suffix: '',
+    entry: 'island_lns.cpp',
+    flags: '',
+    linkFlags: '',
+    libs: ''
+  },
+  // Plugin host only: solves 10k-100k customer instances through decomposition into subproblems
+  decompose: {
+    label: 'decomposition solver',
+    dir: 'decompose',
+    suffix: '',
+    entry: 'decompose_lns.cpp',
+    flags: '',
+    linkFlags: '',
+    libs: ''
+  },
+  // Native test driver (test-native.js, test-route-delta.js); the heuristic supplies the LNS operators
+  tests: {
+    label: 'test driver',
+    dir: 'tests',
+    suffix: '',
+    entry: 'native_tests.cpp',
+    flags: '',
+    linkFlags: '',
+    libs: ''
+  },
+  // Only the heuristic: the framework is resolved from the plugin host that loads it
+  plugin: {
+    label: 'plugin',
+    dir: 'plugins',
+    suffix: '.so',
+    entry: 'PluginExports.cpp',
+    flags: '-fPIC',
+    linkFlags: `-shared${UNDEFINED_DYNAMIC_LOOKUP}`,
+    libs: '',
+    standalone: true
+  }
+};
+
+// Store compiled executables and addons (target:name -> Promise<path>)
+const compiledAlgorithms = new Map();
+// Content hashes of heuristic + framework sources (name -> hex digest)
+const fingerprints = new Map();
+
+/**
+ * Maps an API algorithm id ('best_solution_36.3972' or 'cvrp_36.3972')
+ * to the heuristic source file, or null if there is none.
+ */
+function resolveHeuristic(vrpType, algorithmId) {
+  const scoreMatch = /(\d+\.\d+)$/.exec(algorithmId || '');
+  if (!scoreMatch || !/^[a-z]+$/.test(vrpType || '')) return null;
+
+  const source = path.join(HEURISTICS_DIR, vrpType, 'optimized_heuristics', `best_solution_${scoreMatch[1]}.cpp`);
+  return fs.existsSync(source) ? { name: `${vrpType}_${scoreMatch[1]}`, source } : null;
+}
+
+/**
+ * Hash of everything that determines a solver's behaviour: the heuristic,
+ * the framework sources and headers and the compiler flags. Cached results
+ * are keyed by it so they never outlive the code that produced them.
+ */
+function solverFingerprint(heuristic) {
+  if (!fingerprints.has(heuristic.name)) {
+    const hash = crypto.createHash('sha256').update(CXXFLAGS);
+    const framework = fs.readdirSync(NATIVE_DIR)
+      .filter(file => file.endsWith('.h') || file.endsWith('.cpp'))
+      .sort()
+      .map(file => path.join(NATIVE_DIR, file));
+    for (const file of [heuristic.source, ...framework]) {
+      hash.update(fs.readFileSync(file));
+    }
+    fingerprints.set(heuristic.name, hash.digest('hex'));
+  }
+  return fingerprints.get(heuristic.name);
+}
+
+const sha256 = (...parts) => {
+  const hash = crypto.createHash('sha256');
+  for (const part of parts) hash.update(part).update('\0');
+  return hash.digest('hex');
+};
+
+let compilerVersion = null;
+
+// `$CXX --version`, part of every object key so that a compiler upgrade invalidates the cache
+function compilerIdentity() {
+  if (!compilerVersion) {
+    compilerVersion = execAsync(`${CXX} --version`).then(({ stdout }) => stdout.trim(), () => CXX);
+  }
+  return compilerVersion;
+}
+
+let headersHash = null;
+
+// Objects depend on the framework headers through their includes; hashing all of them is simple and safe
+function frameworkHeadersHash() {
+  if (!headersHash) {
+    const headers = fs.readdirSync(NATIVE_DIR).filter(file => file.endsWith('.h')).sort();
+    headersHash = sha256(...headers.flatMap(file => [file, fs.readFileSync(path.join(NATIVE_DIR, file))]));
+  }
+  return headersHash;
+}
+
+// Content-addressed object path of a translation unit compiled with the given flags
+async function objectPath(source, flags) {
+  const key = sha256(await compilerIdentity(), CXXFLAGS, flags, fs.readFileSync(source), frameworkHeadersHash());
+  return path.join(OBJECT_DIR, `${key}.o`);
+}
+
+// Compilations in flight or done by this process (output path -> Promise<path>)
+const pendingOutputs = new Map();
+
+/**
+ * Runs command, which writes `temporary`, unless output exists, then moves
+ * the result into place. The rename keeps concurrent processes sharing the
+ * cache from ever seeing a partial file. Concurrent callers share one run.
+ */
+function produce(output, temporary, command) {
+  if (!pendingOutputs.has(output)) {
+    const pending = (async () => {
+      if (fs.existsSync(output)) return output;
+      fs.mkdirSync(path.dirname(output), { recursive: true });
+      try {
+        await execAsync(command, { maxBuffer: 16 * 1024 * 1024 });
+        fs.renameSync(temporary, output);
+      } finally {
+        fs.rmSync(temporary, { force: true });
+      }
+      return output;
+    })().catch(error => {
+      pendingOutputs.delete(output);
+      throw error;
+    });
+    pendingOutputs.set(output, pending);
+  }
+  return pendingOutputs.get(output);
+}
+
+async function compileObject(source, flags) {
+  const object = await objectPath(source, flags);
+  const temporary = `${object}.${process.pid}.tmp`;
+  return produce(object, temporary, `${CXX} ${CXXFLAGS} ${flags} -I "${NATIVE_DIR}" -c "${source}" -o "${temporary}"`);
+}
+
+/**
+ * Precompiles HeuristicPch.h for the given flags into
+ * build/pch/<hash>/HeuristicPch.h.gch and resolves to the -include flags
+ * that use it, or to '' if the compiler cannot precompile it.
+ */
+async function pchFlags(flags) {
+  const dir = path.join(BUILD_DIR, 'pch', sha256(await compilerIdentity(), CXXFLAGS, flags, frameworkHeadersHash()));
+  const header = path.join(dir, PCH_HEADER);
+  try {
+    await produce(`${header}.gch`, `${header}.${process.pid}.tmp`,
+      `${CXX} ${CXXFLAGS} ${flags} -I "${NATIVE_DIR}" -x c++-header "${path.join(NATIVE_DIR, PCH_HEADER)}" -o "${header}.${process.pid}.tmp"`);
+    // The compiler looks for the .gch next to the header it is told to include
+    if (!fs.existsSync(header)) {
+      fs.copyFileSync(path.join(NATIVE_DIR, PCH_HEADER), header);
+    }
+    return `-Winvalid-pch -include "${header}"`;
+  } catch (error) {
+    return '';
+  }
+}
+
+async function build(heuristic, target) {
+  const outputDir = path.join(BUILD_DIR, target.dir);
+  const binary = path.join(outputDir, heuristic.name + target.suffix);
+  const frameworkFiles = target.standalone ? [target.entry] : [...FRAMEWORK_SOURCES, ...(target.sources || []), target.entry];
+  const ownDeclarations = OWN_DECLARATIONS.test(fs.readFileSync(heuristic.source, 'utf8'));
+  const units = [
+    { source: heuristic.source, flags: `${target.flags} ${ownDeclarations ? '' : await pchFlags(target.flags)}` },
+    ...frameworkFiles.map(file => ({ source: path.join(NATIVE_DIR, file), flags: target.flags }))
+  ];
+
+  // The link is keyed by its content-addressed inputs, recorded next to the output
+  const objects = await Promise.all(units.map(unit => objectPath(unit.source, unit.flags)));
+  const linkKey = sha256(CXX, CXXFLAGS, target.linkFlags, target.libs, ...objects);
+  const stamp = `${binary}.key`;
+  if (fs.existsSync(binary) && fs.existsSync(stamp) && fs.readFileSync(stamp, 'utf8') === linkKey) {
+    return binary;
+  }
+
+  console.log(`Compiling native ${target.label} ${heuristic.name}...`);
+  await Promise.all(units.map(unit => compileObject(unit.source, unit.flags)));
+  fs.mkdirSync(outputDir, { recursive: true });
+  const temporary = `${binary}.${process.pid}.tmp`;
+  const quoted = objects.map(file => `"${file}"`).join(' ');
+  try {
+    await execAsync(`${CXX} ${CXXFLAGS} ${target.linkFlags} ${quoted} ${target.libs} -o "${temporary}"`, { maxBuffer: 16 * 1024 * 1024 });
+    fs.renameSync(temporary, binary);
+  } finally {
+    fs.rmSync(temporary, { force: true });
+  }
+  fs.writeFileSync(stamp, linkKey);
+  return binary;
+}
+
+function compileTarget(vrpType, algorithmId, targetName) {
+  const heuristic = resolveHeuristic(vrpType, algorithmId);
+  if (!heuristic) {
+    return Promise.reject(new Error(`Unknown algorithm ${vrpType}/${algorithmId}`));
+  }
+  return compileHeuristic(heuristic, targetName);
+}
+
+// One build per key; a failed build is retried by the next caller
+function buildOnce(key, heuristic, target) {
+  if (!compiledAlgorithms.has(key)) {
+    const pending = build(heuristic, target).catch(error => {
+      compiledAlgorithms.delete(key);
+      throw error;
+    });
+    compiledAlgorithms.set(key, pending);
+  }
+  return compiledAlgorithms.get(key);
+}
+
+/**
+ * Builds any heuristic source ({ name, source }) for a target
+ * ('worker', 'addon', 'bench', 'profile', 'tests' or 'plugin') and resolves to the
+ * output path.
+ * Concurrent callers share one compilation.
+ */
+function compileHeuristic(heuristic, targetName) {
+  return buildOnce(`${targetName}:${heuristic.name}`, heuristic, TARGETS[targetName]);
+}
+
+// Plugins need an ELF toolchain; SOLVER_LINK=static builds one executable per heuristic instead
+function usePlugins() {
+  return process.platform === 'linux' && process.env.SOLVER_LINK !== 'static';
+}
+
+// Path of the plugin host of a target ('worker', 'bench', 'profile', 'islands' or 'decompose'), see compilePluginHost
+function pluginHostPath(targetName) {
+  return path.join(BUILD_DIR, TARGETS[targetName].dir, 'plugin-host');
+}
+
+/**
+ * Builds the target's executable with PluginHost.cpp in place of a
+ * heuristic: it runs the plugin named by $VRP_HEURISTIC_PLUGIN. Exported
+ * symbols (-rdynamic) let the plugin link against the host's framework.
+ */
+function compilePluginHost(targetName) {
+  const target = TARGETS[targetName];
+  return buildOnce(`host:${targetName}`, { name: 'plugin-host', source: path.join(NATIVE_DIR, 'PluginHost.cpp') }, {
+    ...target,
+    label: `${target.label} plugin host`,
+    linkFlags: `${target.linkFlags} -rdynamic`,
+    libs: `${target.libs} -ldl`
+  });
+}
+
+/**
+ * Resolves to what the worker pool runs for the given heuristic: its plugin
+ * (with the worker plugin host built) or its worker executable. Compiles on
+ * first use; concurrent callers share one compilation.
+ */
+async function compileSolver(vrpType, algorithmId) {
+  if (!usePlugins()) {
+    return compileTarget(vrpType, algorithmId, 'worker');
+  }
+  const [plugin] = await Promise.all([compileTarget(vrpType, algorithmId, 'plugin'), compilePluginHost('worker')]);
+  return plugin;
+}
+
+/**
+ * Resolves to the loaded Node-API addon for the given heuristic,
+ * compiling it on first use.
+ */
+async function loadAddon(vrpType, algorithmId) {
+  return require(await compileTarget(vrpType, algorithmId, 'addon'));
+}
+
+module.exports = {
+  compileSolver,
+  compileHeuristic,
+  compilePluginHost,
+  pluginHostPath,
+  usePlugins,
+  loadAddon,
+  resolveHeuristic,
+  solverFingerprint,
+  HEURISTICS_DIR,
+  PLUGIN_ENV
+};
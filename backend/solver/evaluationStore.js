@@ -0,0 +1,200 @@
+/**
+ * Evaluation store: an append-only, columnar record of the evaluations of
+ * one generation, kept next to its individuals as evaluations.store.
+ *
+ * The file holds one block per line. A block is a JSON object of the rows
+ * appended together, stored column by column:
+ *   { "version": 1, "appendedAt": "...", "settings": {...},
+ *     "batch": [{ "instance", "numCustomers", "seed" }, ...],
+ *     "rows": n, "columns": { "name": [...], "fitness": [...], ... } }
+ * objectives, runMs and runIterations hold one array per row, aligned with
+ * the block's batch. Rows are never rewritten: a re-evaluation appends a
+ * new row and the latest row of a name wins. A block is written with one
+ * append, and a torn last line left by a crash is skipped on load.
+ *
+ * Ranking needs only a few columns, so loading thousands of rows is a
+ * JSON.parse per block plus array concatenation.
+ */
+
+const fs = require('fs');
+const path = require('path');
+
+const STORE_FILE = 'evaluations.store';
+const STORE_VERSION = 1;
+const OPERATOR_PHASES = ['select', 'sort'];
+const COLUMNS = [
+  'name',
+  'status',
+  'error', // Failure reason, null when the evaluation succeeded
+  'fitness',
+  'evaluationKey',
+  'evaluatedAt',
+  'evaluationMs',
+  'objectives', // Final objective per batch entry
+  'runMs', // LNS wall time per batch entry
+  'runIterations',
+  'iterationsPerSec',
+  'wallMs', // Wall and CPU time and peak resident set of the sandboxed child; null without the sandbox
+  'cpuMs',
+  'maxRssKb',
+  ...OPERATOR_PHASES.flatMap(phase => [`${phase}P50Ns`, `${phase}P99Ns`, `${phase}P999Ns`]),
+  'race' // { iterations, blocks, meanRank } of an individual eliminated by the race
+];
+
+function storePath(populationDir) {
+  return path.join(populationDir, STORE_FILE);
+}
+
+/**
+ * Flattens an evaluation record (see evaluate-generation.js) into the
+ * column values of one row. Runs are matched to the batch by instance and
+ * seed; entries without a run are null.
+ */
+function toRow(record, batch) {
+  const runs = record.race ? [] : record.runs || [];
+  const runOf = entry => runs.find(run => run.instance === entry.instance &&
+    run.numCustomers === entry.numCustomers && run.seed === entry.seed) || null;
+  const aligned = batch.map(runOf);
+  const totalIterations = runs.reduce((sum, run) => sum + run.iterations, 0);
+  const totalMs = runs.reduce((sum, run) => sum + run.elapsedMs, 0);
+  const row = {
+    name: record.name,
+    status: record.status,
+    error: record.error || null,
+    fitness: record.fitness,
+    evaluationKey: record.evaluationKey,
+    evaluatedAt: record.evaluatedAt,
+    evaluationMs: record.evaluationMs,
+    objectives: aligned.map(run => run && run.objective),
+    runMs: aligned.map(run => run && run.elapsedMs),
+    runIterations: aligned.map(run => run && run.iterations),
+    iterationsPerSec: totalMs > 0 ? totalIterations / totalMs * 1000 : null,
+    wallMs: record.sandbox ? record.sandbox.wallMs : null,
+    cpuMs: record.sandbox ? record.sandbox.cpuMs : null,
+    maxRssKb: record.sandbox ? record.sandbox.maxRssKb : null,
+    race: record.race || null
+  };
+  for (const phase of OPERATOR_PHASES) {
+    const latency = record.metrics && record.metrics[phase];
+    row[`${phase}P50Ns`] = latency ? latency.p50Ns : null;
+    row[`${phase}P99Ns`] = latency ? latency.p99Ns : null;
+    row[`${phase}P999Ns`] = latency ? latency.p999Ns : null;
+  }
+  return row;
+}
+
+/**
+ * Buffers records and appends them to a store as blocks of up to
+ * blockRows, so that a crashed evaluation loses at most one block. The
+ * batch is the run order of the fullest evaluated record. Call flush()
+ * when done.
+ */
+class StoreWriter {
+  constructor(file, { settings, blockRows = 32 }) {
+    this.file = file;
+    this.settings = settings;
+    this.blockRows = blockRows;
+    this.batch = null;
+    this.records = [];
+  }
+
+  add(record) {
+    this.records.push(record);
+    if (this.records.length >= this.blockRows) {
+      this.flush();
+    }
+  }
+
+  flush() {
+    if (!this.records.length) return;
+    for (const record of this.records) {
+      const runs = record.race ? [] : record.runs || [];
+      if (!this.batch || runs.length > this.batch.length) {
+        this.batch = runs.map(({ instance, numCustomers, seed }) => ({ instance, numCustomers, seed }));
+      }
+    }
+    const rows = this.records.map(record => toRow(record, this.batch));
+    const columns = {};
+    for (const column of COLUMNS) {
+      columns[column] = rows.map(row => row[column]);
+    }
+    const block = {
+      version: STORE_VERSION,
+      appendedAt: new Date().toISOString(),
+      settings: this.settings,
+      batch: this.batch,
+      rows: rows.length,
+      columns
+    };
+    fs.mkdirSync(path.dirname(this.file), { recursive: true });
+    fs.appendFileSync(this.file, JSON.stringify(block) + '\n');
+    this.records = [];
+  }
+}
+
+/**
+ * Reads a store into { blocks, rows }: the parsed blocks in append order
+ * and the total row count. A missing file is an empty store.
+ */
+function loadStore(file) {
+  let text;
+  try {
+    text = fs.readFileSync(file, 'utf8');
+  } catch (error) {
+    if (error.code === 'ENOENT') return { blocks: [], rows: 0 };
+    throw error;
+  }
+  const blocks = [];
+  for (const line of text.split('\n')) {
+    if (!line) continue;
+    try {
+      const block = JSON.parse(line);
+      if (block.version === STORE_VERSION) blocks.push(block);
+    } catch (error) {
+      // Torn append of a crashed writer
+    }
+  }
+  return { blocks, rows: blocks.reduce((sum, block) => sum + block.rows, 0) };
+}
+
+/**
+ * Values of one column over all rows, in append order. Columns of
+ * settings and batch are not row columns; read them from the blocks.
+ */
+function column(store, name) {
+  const values = [];
+  for (const block of store.blocks) {
+    const blockValues = block.columns[name] || new Array(block.rows).fill(null);
+    for (let r = 0; r < block.rows; r++) values.push(blockValues[r]);
+  }
+  return values;
+}
+
+/**
+ * The latest row of every name as an object with the requested columns
+ * (all by default) plus the settings of its block: Map(name -> row).
+ */
+function latestRows(store, columns = COLUMNS) {
+  const latest = new Map();
+  for (const block of store.blocks) {
+    for (let r = 0; r < block.rows; r++) {
+      const row = { settings: block.settings };
+      for (const name of columns) {
+        row[name] = block.columns[name] ? block.columns[name][r] : null;
+      }
+      latest.set(block.columns.name[r], row);
+    }
+  }
+  return latest;
+}
+
+module.exports = {
+  STORE_FILE,
+  COLUMNS,
+  storePath,
+  toRow,
+  StoreWriter,
+  loadStore,
+  column,
+  latestRows
+};
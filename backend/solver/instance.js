@@ -0,0 +1,57 @@
+/**
+ * Turns the customers generated by server.js into the typed-array instance
+ * layout the native solver expects. Node 0 is the depot.
+ */
+
+const HORIZON = 2500;
+const SERVICE_TIME = 10;
+
+// random: PRNG for prizes and time windows, seeded for reproducible instances
+function createInstance(vrpType, customers, { vehicleCapacity, depot, random = Math.random }) {
+  const n = customers.length + 1;
+  const instance = {
+    vrpType,
+    vehicleCapacity,
+    x: new Float32Array(n),
+    y: new Float32Array(n),
+    demand: new Int32Array(n)
+  };
+
+  instance.x[0] = depot.x;
+  instance.y[0] = depot.y;
+  customers.forEach((customer, i) => {
+    instance.x[i + 1] = customer.x;
+    instance.y[i + 1] = customer.y;
+    instance.demand[i + 1] = Math.min(customer.demand, vehicleCapacity);
+  });
+
+  if (vrpType === 'pcvrp') {
+    // Prizes grow with demand so that large customers are worth a detour
+    instance.prizes = new Float32Array(n);
+    customers.forEach((customer, i) => {
+      instance.prizes[i + 1] = customer.demand * (6 + random() * 8);
+    });
+  }
+
+  if (vrpType === 'vrptw') {
+    instance.startTW = new Float32Array(n);
+    instance.endTW = new Float32Array(n);
+    instance.serviceTime = new Float32Array(n);
+    instance.endTW[0] = HORIZON;
+
+    customers.forEach((customer, i) => {
+      const depotDistance = Math.hypot(customer.x - depot.x, customer.y - depot.y);
+      const width = 100 + random() * 300;
+      // Every window is reachable from the depot and leaves time to return
+      const latestStart = Math.max(depotDistance, HORIZON - depotDistance - SERVICE_TIME - width);
+      const start = depotDistance + random() * (latestStart - depotDistance);
+      instance.startTW[i + 1] = start;
+      instance.endTW[i + 1] = Math.min(start + width, HORIZON - depotDistance - SERVICE_TIME);
+      instance.serviceTime[i + 1] = SERVICE_TIME;
+    });
+  }
+
+  return instance;
+}
+
+module.exports = { createInstance };
@@ -0,0 +1,209 @@
+/**
+ * Binary pipe protocol spoken with the native solver workers.
+ * Mirrors backend/native/WireFormat.h and Protocol.h: every frame is a
+ * little-endian uint32 payload length followed by the payload.
+ */
+
+const MSG_SOLVE = 1;
+const MSG_RESULT = 2;
+const MSG_ERROR = 3;
+const MSG_PROGRESS = 4;
+const MSG_CANCEL = 5;
+const MSG_METRICS = 6;
+
+const PROBLEM_TYPES = { cvrp: 0, pcvrp: 1, vrptw: 2 };
+
+// initialTours (optional): customer id sequences of an earlier best solution to warm-start from
+function encodeSolveRequest(requestId, instance, { seed, timeBudgetMs, progressIntervalMs = 0, initialTours }) {
+  const n = instance.x.length;
+  const arrays = [instance.x, instance.y, instance.demand];
+  if (instance.vrpType === 'pcvrp') {
+    arrays.push(instance.prizes);
+  }
+  if (instance.vrpType === 'vrptw') {
+    arrays.push(instance.startTW, instance.endTW, instance.serviceTime);
+  }
+
+  const headerSize = 1 + 4 + 1 + 4 + 4 + 4 + 4 + 4;
+  const warmStartSize = initialTours
+    ? 4 + initialTours.reduce((sum, tour) => sum + 4 + tour.length * 4, 0)
+    : 0;
+  const payloadSize = headerSize + arrays.length * n * 4 + warmStartSize;
+  const frame = Buffer.allocUnsafe(4 + payloadSize);
+
+  let offset = frame.writeUInt32LE(payloadSize, 0);
+  offset = frame.writeUInt8(MSG_SOLVE, offset);
+  offset = frame.writeUInt32LE(requestId, offset);
+  offset = frame.writeUInt8(PROBLEM_TYPES[instance.vrpType], offset);
+  offset = frame.writeUInt32LE(seed >>> 0, offset);
+  offset = frame.writeUInt32LE(Math.round(timeBudgetMs), offset);
+  offset = frame.writeUInt32LE(Math.round(progressIntervalMs), offset);
+  offset = frame.writeInt32LE(instance.vehicleCapacity, offset);
+  offset = frame.writeUInt32LE(n, offset);
+
+  // Typed arrays are copied byte-for-byte; both ends are little-endian
+  for (const array of arrays) {
+    const bytes = Buffer.from(array.buffer, array.byteOffset, array.byteLength);
+    bytes.copy(frame, offset);
+    offset += bytes.length;
+  }
+
+  if (initialTours) {
+    offset = frame.writeUInt32LE(initialTours.length, offset);
+    for (const tour of initialTours) {
+      offset = frame.writeUInt32LE(tour.length, offset);
+      for (const customer of tour) {
+        offset = frame.writeUInt32LE(customer, offset);
+      }
+    }
+  }
+  return frame;
+}
+
+function encodeCancel(requestId) {
+  const frame = Buffer.allocUnsafe(4 + 5);
+  frame.writeUInt32LE(5, 0);
+  frame.writeUInt8(MSG_CANCEL, 4);
+  frame.writeUInt32LE(requestId, 5);
+  return frame;
+}
+
+function encodeMetricsRequest(requestId) {
+  const frame = Buffer.allocUnsafe(4 + 5);
+  frame.writeUInt32LE(5, 0);
+  frame.writeUInt8(MSG_METRICS, 4);
+  frame.writeUInt32LE(requestId, 5);
+  return frame;
+}
+
+function decodeMessage(payload) {
+  const type = payload.readUInt8(0);
+  const requestId = payload.readUInt32LE(1);
+
+  if (type === MSG_ERROR) {
+    const length = payload.readUInt32LE(5);
+    return { type, requestId, message: payload.toString('utf8', 9, 9 + length) };
+  }
+  if (type === MSG_PROGRESS) {
+    return decodeProgress(payload, requestId);
+  }
+  if (type === MSG_METRICS) {
+    return decodeMetrics(payload, requestId);
+  }
+  if (type !== MSG_RESULT) {
+    throw new Error(`Unknown solver message type ${type}`);
+  }
+
+  let offset = 5;
+  const objective = payload.readFloatLE(offset); offset += 4;
+  const totalCosts = payload.readFloatLE(offset); offset += 4;
+  const iterations = payload.readUInt32LE(offset); offset += 4;
+  const elapsedMs = payload.readFloatLE(offset); offset += 4;
+  const cancelled = payload.readUInt8(offset) === 1; offset += 1;
+  const numTours = payload.readUInt32LE(offset); offset += 4;
+
+  const tours = [];
+  for (let t = 0; t < numTours; t++) {
+    const length = payload.readUInt32LE(offset); offset += 4;
+    const demand = payload.readInt32LE(offset); offset += 4;
+    const costs = payload.readFloatLE(offset); offset += 4;
+    const distance = payload.readFloatLE(offset); offset += 4;
+    const customers = [];
+    for (let i = 0; i < length; i++) {
+      customers.push(payload.readUInt32LE(offset));
+      offset += 4;
+    }
+    tours.push({ customers, demand, costs, distance });
+  }
+
+  return { type, requestId, objective, totalCosts, iterations, elapsedMs, cancelled, tours };
+}
+
+// The route delta (see encodeProgress in Protocol.h) is kept as raw bytes: Node relays it to the
+// browser untouched, which applies it to the tours it already holds.
+function decodeProgress(payload, requestId) {
+  return {
+    type: MSG_PROGRESS,
+    requestId,
+    objective: payload.readFloatLE(5),
+    iteration: payload.readUInt32LE(9),
+    elapsedMs: payload.readFloatLE(13),
+    routeDelta: payload.subarray(5)
+  };
+}
+
+// Counter snapshot of a worker (see encodeMetrics in Protocol.h); u64 counters become Numbers
+function decodeMetrics(payload, requestId) {
+  let offset = 5;
+  const readString = () => {
+    const length = payload.readUInt32LE(offset);
+    const value = payload.toString('utf8', offset + 4, offset + 4 + length);
+    offset += 4 + length;
+    return value;
+  };
+  const readU64 = () => {
+    const value = Number(payload.readBigUInt64LE(offset));
+    offset += 8;
+    return value;
+  };
+  const readF64 = () => {
+    const value = payload.readDoubleLE(offset);
+    offset += 8;
+    return value;
+  };
+
+  const threads = payload.readUInt32LE(offset); offset += 4;
+  const iterations = readU64();
+  const accepted = readU64();
+  const improved = readU64();
+  const cyclesPerNs = readF64();
+  const numPhases = payload.readUInt8(offset); offset += 1;
+  const phases = {};
+  for (let p = 0; p < numPhases; p++) {
+    const name = readString();
+    phases[name] = { calls: readU64(), cycles: readU64(), ms: readF64(), p50Ns: readF64(), p99Ns: readF64(), p999Ns: readF64() };
+  }
+  const numCounters = payload.readUInt32LE(offset); offset += 4;
+  const operatorCounters = {};
+  for (let c = 0; c < numCounters; c++) {
+    const name = readString();
+    operatorCounters[name] = readU64();
+  }
+  return { type: MSG_METRICS, requestId, threads, iterations, accepted, improved, cyclesPerNs, phases, operatorCounters };
+}
+
+/**
+ * Reassembles frames from arbitrarily split stdout chunks.
+ */
+class FrameDecoder {
+  constructor() {
+    this.buffer = Buffer.alloc(0);
+  }
+
+  push(chunk) {
+    this.buffer = this.buffer.length === 0 ? chunk : Buffer.concat([this.buffer, chunk]);
+    const frames = [];
+    while (this.buffer.length >= 4) {
+      const length = this.buffer.readUInt32LE(0);
+      if (this.buffer.length < 4 + length) break;
+      frames.push(this.buffer.subarray(4, 4 + length));
+      this.buffer = this.buffer.subarray(4 + length);
+    }
+    return frames;
+  }
+}
+
+module.exports = {
+  MSG_SOLVE,
+  MSG_RESULT,
+  MSG_ERROR,
+  MSG_PROGRESS,
+  MSG_CANCEL,
+  MSG_METRICS,
+  PROBLEM_TYPES,
+  encodeSolveRequest,
+  encodeCancel,
+  encodeMetricsRequest,
+  decodeMessage,
+  FrameDecoder
+};
@@ -0,0 +1,247 @@
+/**
+ * Content-addressed cache of native solve results.
+ * An entry holds the best solution and the convergence trace of one run and
+ * is keyed by a hash of the instance arrays, the solver fingerprint and the
+ * seed, plus the time budget. Entries live in an in-memory LRU and as JSON
+ * files under backend/build/cache/<key>/<timeBudgetMs>.json; the files are
+ * pruned least recently used first (by mtime, refreshed on every hit) once
+ * they exceed maxDiskBytes. Concurrent identical solves share one
+ * computation, which is cancelled only when every caller sharing it has
+ * given up, and a request for a larger budget than a cached run warm-starts
+ * from that run's best tours.
+ */
+
+const crypto = require('crypto');
+const fs = require('fs');
+const path = require('path');
+
+const CACHE_DIR = path.join(__dirname, '..', 'build', 'cache');
+// Bump when the stored entry layout changes
+const CACHE_VERSION = 1;
+const INSTANCE_ARRAYS = ['x', 'y', 'demand', 'prizes', 'startTW', 'endTW', 'serviceTime'];
+
+/**
+ * Canonical key of a solve: the same instance data, solver and seed always
+ * hash to the same key, whatever object or request produced them.
+ */
+function solveKey(instance, fingerprint, seed) {
+  const hash = crypto.createHash('sha256');
+  hash.update(`${CACHE_VERSION}\0${fingerprint}\0${seed >>> 0}\0${instance.vrpType}\0${instance.vehicleCapacity}\0`);
+  for (const name of INSTANCE_ARRAYS) {
+    const array = instance[name];
+    if (!array) continue;
+    hash.update(`${name}:${array.length}\0`);
+    hash.update(Buffer.from(array.buffer, array.byteOffset, array.byteLength));
+  }
+  return hash.digest('hex');
+}
+
+class SolveCache {
+  constructor({ maxEntries = 256, maxDiskBytes = 512 * 1024 * 1024, directory = CACHE_DIR } = {}) {
+    this.maxEntries = maxEntries;
+    this.maxDiskBytes = maxDiskBytes;
+    this.directory = directory;
+    this.entries = new Map(); // `${key}/${timeBudgetMs}` -> entry, least recently used first
+    this.inflight = new Map(); // id -> { promise, controller, waiters }
+    // Bytes of the entry files, counted by the first pruning scan and kept up to date by store; null before
+    this.diskBytes = null;
+    this.pruning = null;
+    this.counters = { hits: 0, diskHits: 0, misses: 0, coalesced: 0, warmStarts: 0, evictedFiles: 0 };
+  }
+
+  /**
+   * Resolves with the entry for (key, timeBudgetMs), computing it at most once.
+   * compute(warmStart, signal) receives the cached entry with the largest
+   * smaller budget (or null) and must resolve with
+   * { result, trace, timeBudgetMs }. Its signal aborts once the signals of
+   * all callers waiting for it have; those callers get the cancelled result.
+   * Cancelled results are returned but never stored.
+   */
+  async solve(key, timeBudgetMs, compute, signal) {
+    const id = `${key}/${timeBudgetMs}`;
+    const cached = await this.lookup(id);
+    if (cached) {
+      this.counters.hits++;
+      return { ...cached, cached: true };
+    }
+
+    let run = this.inflight.get(id);
+    if (run) {
+      this.counters.coalesced++;
+    } else {
+      this.counters.misses++;
+      run = this.start(id, key, timeBudgetMs, compute);
+    }
+    const entry = await this.wait(id, run, signal);
+    // Cancelled for another reason than this caller giving up; start over for it
+    return entry.result.cancelled && !(signal && signal.aborted) ? this.solve(key, timeBudgetMs, compute, signal) : entry;
+  }
+
+  start(id, key, timeBudgetMs, compute) {
+    const controller = new AbortController();
+    const run = { controller, waiters: 0 };
+    run.promise = (async () => {
+      const warmStart = await this.findWarmStart(key, timeBudgetMs);
+      if (warmStart) this.counters.warmStarts++;
+      const entry = await compute(warmStart, controller.signal);
+      if (!entry.result.cancelled) {
+        this.store(id, entry);
+      }
+      return entry;
+    })();
+    const done = () => {
+      if (this.inflight.get(id) === run) this.inflight.delete(id);
+    };
+    run.promise.then(done, done);
+    this.inflight.set(id, run);
+    return run;
+  }
+
+  // Waits for a shared computation as one of its callers; the last caller to abort cancels it
+  async wait(id, run, signal) {
+    run.waiters++;
+    let left = false;
+    const leave = () => {
+      left = true;
+      if (--run.waiters === 0) {
+        // Later callers must not join a cancelled run
+        if (this.inflight.get(id) === run) this.inflight.delete(id);
+        run.controller.abort();
+      }
+    };
+    if (signal) {
+      if (signal.aborted) leave();
+      else signal.addEventListener('abort', leave, { once: true });
+    }
+    try {
+      return await run.promise;
+    } finally {
+      if (signal) signal.removeEventListener('abort', leave);
+      if (!left) run.waiters--;
+    }
+  }
+
+  stats() {
+    return {
+      entries: this.entries.size,
+      maxEntries: this.maxEntries,
+      diskBytes: this.diskBytes,
+      maxDiskBytes: this.maxDiskBytes,
+      inflight: this.inflight.size,
+      ...this.counters
+    };
+  }
+
+  async lookup(id) {
+    if (this.entries.has(id)) {
+      const entry = this.entries.get(id);
+      this.entries.delete(id);
+      this.entries.set(id, entry);
+      this.touch(id);
+      return entry;
+    }
+    try {
+      const entry = JSON.parse(await fs.promises.readFile(this.file(id), 'utf8'));
+      this.counters.diskHits++;
+      this.remember(id, entry);
+      this.touch(id);
+      return entry;
+    } catch (error) {
+      return null;
+    }
+  }
+
+  // Marks the entry's file as recently used for pruneDisk
+  touch(id) {
+    const now = new Date();
+    fs.promises.utimes(this.file(id), now, now).catch(() => {});
+  }
+
+  async findWarmStart(key, timeBudgetMs) {
+    const budgets = new Set();
+    for (const id of this.entries.keys()) {
+      if (id.startsWith(`${key}/`)) budgets.add(parseInt(id.slice(key.length + 1), 10));
+    }
+    try {
+      for (const file of await fs.promises.readdir(path.join(this.directory, key))) {
+        if (file.endsWith('.json')) budgets.add(parseInt(file, 10));
+      }
+    } catch (error) {
+      // No runs of this instance on disk yet
+    }
+
+    const best = Math.max(-1, ...[...budgets].filter(budget => budget < timeBudgetMs));
+    return best > 0 ? this.lookup(`${key}/${best}`) : null;
+  }
+
+  store(id, entry) {
+    this.remember(id, entry);
+    // Written to a temporary file and renamed so readers never see a partial entry
+    const file = this.file(id);
+    const temporary = `${file}.${process.pid}.tmp`;
+    const json = JSON.stringify(entry);
+    const write = () => fs.promises.mkdir(path.dirname(file), { recursive: true })
+      .then(() => fs.promises.writeFile(temporary, json))
+      .then(() => fs.promises.rename(temporary, file));
+    // pruneDisk may remove the instance's directory while it is empty, i.e. between the mkdir and the rename
+    write()
+      .catch(error => (error.code === 'ENOENT' ? write() : Promise.reject(error)))
+      .then(() => {
+        if (this.diskBytes !== null) this.diskBytes += Buffer.byteLength(json);
+        if (this.diskBytes === null || this.diskBytes > this.maxDiskBytes) return this.pruneDisk();
+      })
+      .catch(error => console.warn(`Could not persist cached solve ${id}: ${error.message}`));
+  }
+
+  /**
+   * Deletes the least recently used entry files until they take at most 90%
+   * of maxDiskBytes, so that not every store has to prune. Rescans the
+   * directory, which other processes sharing it may have written to.
+   */
+  pruneDisk() {
+    if (!this.pruning) {
+      this.pruning = (async () => {
+        const files = [];
+        for (const key of await fs.promises.readdir(this.directory).catch(() => [])) {
+          const dir = path.join(this.directory, key);
+          for (const name of await fs.promises.readdir(dir).catch(() => [])) {
+            if (!name.endsWith('.json')) continue;
+            const file = path.join(dir, name);
+            const stat = await fs.promises.stat(file).catch(() => null);
+            if (stat) files.push({ file, size: stat.size, mtimeMs: stat.mtimeMs });
+          }
+        }
+        let total = files.reduce((sum, f) => sum + f.size, 0);
+        if (total > this.maxDiskBytes) {
+          files.sort((a, b) => a.mtimeMs - b.mtimeMs);
+          for (const { file, size } of files) {
+            if (total <= 0.9 * this.maxDiskBytes) break;
+            await fs.promises.rm(file, { force: true });
+            // Fails while the instance has other entries, which is fine
+            await fs.promises.rmdir(path.dirname(file)).catch(() => {});
+            total -= size;
+            this.counters.evictedFiles++;
+          }
+        }
+        this.diskBytes = total;
+      })().finally(() => {
+        this.pruning = null;
+      });
+    }
+    return this.pruning;
+  }
+
+  remember(id, entry) {
+    this.entries.delete(id);
+    this.entries.set(id, entry);
+    if (this.entries.size > this.maxEntries) {
+      this.entries.delete(this.entries.keys().next().value);
+    }
+  }
+
+  file(id) {
+    return path.join(this.directory, `${id}.json`);
+  }
+}
+
+module.exports = { SolveCache, solveKey };
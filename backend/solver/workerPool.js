@@ -0,0 +1,352 @@
+/**
+ * Pool of long-lived native solver processes.
+ * Each worker runs one compiled heuristic (see compiler.js) and serves one
+ * request at a time. A heuristic is either a worker executable or a plugin
+ * (.so), which runs in the pluginHost executable over the binary pipe protocol in protocol.js. Requests
+ * wait in a bounded FIFO queue; a full queue is reported as QUEUE_FULL so the
+ * API can answer 503 instead of piling up work.
+ *
+ * Generated operators can spin (rejection-sampling loops that never find an
+ * unused customer) or have heavy-tailed call latencies. A heuristic whose
+ * worker blows its time box is quarantined: solves with it are rejected with
+ * QUARANTINED for quarantineMs. One whose select/sort p99.9 latency reaches
+ * tailRatio x its median is reported in stats(), and quarantined as well
+ * with quarantineHeavyTails.
+ */
+
+const { spawn } = require('child_process');
+const os = require('os');
+const path = require('path');
+const {
+  encodeSolveRequest,
+  encodeCancel,
+  encodeMetricsRequest,
+  decodeMessage,
+  FrameDecoder,
+  MSG_ERROR,
+  MSG_PROGRESS,
+  MSG_METRICS
+} = require('./protocol');
+const { PLUGIN_ENV } = require('./compiler');
+
+const METRICS_TIMEOUT_MS = 1000;
+const OPERATOR_PHASES = ['select', 'sort'];
+
+/**
+ * Operator phases whose p99.9 call latency is at least ratio x the median,
+ * judged once a phase has minCalls calls (see Metrics.h).
+ */
+function heavyTailPhases(metrics, { ratio, minCalls }) {
+  return OPERATOR_PHASES.filter(name => {
+    const phase = metrics.phases[name];
+    return phase && phase.calls >= minCalls && phase.p50Ns > 0 && phase.p999Ns >= ratio * phase.p50Ns;
+  });
+}
+
+function solverError(message, code) {
+  const error = new Error(message);
+  error.code = code;
+  return error;
+}
+
+class SolverPool {
+  constructor({
+    maxWorkers = os.cpus().length,
+    maxQueueLength = 4 * os.cpus().length,
+    graceMs = 2000,
+    quarantineMs = 10 * 60 * 1000,
+    tailRatio = 64,
+    tailMinCalls = 10000,
+    quarantineHeavyTails = false,
+    pluginHost = null
+  } = {}) {
+    this.maxWorkers = maxWorkers;
+    this.maxQueueLength = maxQueueLength;
+    this.graceMs = graceMs;
+    this.quarantineMs = quarantineMs;
+    this.tail = { ratio: tailRatio, minCalls: tailMinCalls };
+    this.quarantineHeavyTails = quarantineHeavyTails;
+    this.pluginHost = pluginHost;
+    this.workers = [];
+    this.queue = [];
+    this.nextRequestId = 1;
+    // binary -> { reason, until }
+    this.quarantined = new Map();
+    // binary -> reason, for heuristics found heavy-tailed
+    this.heavyTails = new Map();
+  }
+
+  /**
+   * Solves an instance with the given solver binary.
+   * Resolves with the decoded MSG_RESULT; rejects with code QUEUE_FULL,
+   * TIMEOUT, WORKER_CRASHED, SOLVER_ERROR or CANCELLED.
+   *
+   * onProgress receives MSG_PROGRESS snapshots of improved solutions, at most
+   * one per progressIntervalMs. Aborting signal drops a queued request
+   * (CANCELLED) or stops a running one, which then resolves with the best
+   * solution found so far. initialTours warm-starts the search from an
+   * earlier solution.
+   */
+  solve(binary, instance, {
+    timeBudgetMs = 1000,
+    seed = 0,
+    onProgress,
+    progressIntervalMs = 100,
+    signal,
+    initialTours
+  } = {}) {
+    if (this.queue.length >= this.maxQueueLength) {
+      return Promise.reject(solverError('Solver queue is full', 'QUEUE_FULL'));
+    }
+    if (signal && signal.aborted) {
+      return Promise.reject(solverError('Solve cancelled', 'CANCELLED'));
+    }
+    const quarantine = this.quarantineOf(binary);
+    if (quarantine) {
+      return Promise.reject(solverError(`Heuristic ${path.basename(binary)} is quarantined: ${quarantine.reason}`, 'QUARANTINED'));
+    }
+
+    return new Promise((resolve, reject) => {
+      const requestId = this.nextRequestId++;
+      const job = {
+        binary,
+        requestId,
+        timeBudgetMs,
+        onProgress,
+        frame: encodeSolveRequest(requestId, instance, {
+          seed,
+          timeBudgetMs,
+          progressIntervalMs: onProgress ? progressIntervalMs : 0,
+          initialTours
+        }),
+        resolve,
+        reject
+      };
+      if (signal) {
+        signal.addEventListener('abort', () => this.cancel(job), { once: true });
+      }
+      this.queue.push(job);
+      this.schedule();
+    });
+  }
+
+  cancel(job) {
+    const queued = this.queue.indexOf(job);
+    if (queued !== -1) {
+      this.queue.splice(queued, 1);
+      job.reject(solverError('Solve cancelled', 'CANCELLED'));
+      return;
+    }
+    const worker = this.workers.find(w => w.job === job);
+    if (worker) {
+      worker.child.stdin.write(encodeCancel(job.requestId));
+    }
+  }
+
+  stats() {
+    return {
+      workers: this.workers.length,
+      busy: this.workers.filter(w => w.job).length,
+      queued: this.queue.length,
+      maxWorkers: this.maxWorkers,
+      maxQueueLength: this.maxQueueLength,
+      quarantined: [...this.quarantined.keys()]
+        .filter(binary => this.quarantineOf(binary))
+        .map(binary => ({ heuristic: path.basename(binary), ...this.quarantined.get(binary) })),
+      heavyTails: [...this.heavyTails].map(([binary, reason]) => ({ heuristic: path.basename(binary), reason }))
+    };
+  }
+
+  /**
+   * Hot-path counters (Metrics.h) of every live worker, totals since the
+   * worker started: [{ heuristic, pid, busy, metrics }]. Workers answer
+   * from their reader thread, so busy ones report mid-solve; a worker that
+   * does not answer within a second is reported with metrics: null.
+   */
+  metrics() {
+    return Promise.all(this.workers.map(async worker => {
+      const entry = { heuristic: path.basename(worker.binary), pid: worker.child.pid, busy: Boolean(worker.job) };
+      const metrics = await this.requestMetrics(worker);
+      return { ...entry, metrics, heavyTail: metrics ? heavyTailPhases(metrics, this.tail) : [] };
+    }));
+  }
+
+  requestMetrics(worker) {
+    return new Promise(resolve => {
+      const requestId = this.nextRequestId++;
+      const timer = setTimeout(() => {
+        worker.metricsWaiters.delete(requestId);
+        resolve(null);
+      }, METRICS_TIMEOUT_MS);
+      worker.metricsWaiters.set(requestId, message => {
+        clearTimeout(timer);
+        const { type, requestId: id, ...metrics } = message;
+        resolve(metrics);
+      });
+      worker.child.stdin.write(encodeMetricsRequest(requestId));
+    });
+  }
+
+  quarantine(binary, reason) {
+    if (this.quarantineOf(binary)) return;
+    console.warn(`Quarantining ${path.basename(binary)} for ${this.quarantineMs}ms: ${reason}`);
+    this.quarantined.set(binary, { reason, until: Date.now() + this.quarantineMs });
+    // Queued requests for it would only run into the same problem
+    this.queue = this.queue.filter(job => {
+      if (job.binary !== binary) return true;
+      job.reject(solverError(`Heuristic ${path.basename(binary)} is quarantined: ${reason}`, 'QUARANTINED'));
+      return false;
+    });
+  }
+
+  quarantineOf(binary) {
+    const entry = this.quarantined.get(binary);
+    if (entry && entry.until <= Date.now()) {
+      this.quarantined.delete(binary);
+      return null;
+    }
+    return entry || null;
+  }
+
+  // Heavy-tail check on the worker's cumulative operator latencies after each solve
+  async inspectTail(worker) {
+    const metrics = await this.requestMetrics(worker);
+    if (!metrics) return;
+    for (const name of heavyTailPhases(metrics, this.tail)) {
+      const phase = metrics.phases[name];
+      const reason = `${name} p99.9 ${(phase.p999Ns / 1000).toFixed(0)}us is ` +
+        `${(phase.p999Ns / phase.p50Ns).toFixed(0)}x its median ${(phase.p50Ns / 1000).toFixed(1)}us`;
+      if (!this.heavyTails.has(worker.binary)) {
+        console.warn(`Heavy-tailed operator in ${path.basename(worker.binary)}: ${reason}`);
+      }
+      this.heavyTails.set(worker.binary, reason);
+      if (this.quarantineHeavyTails) {
+        this.quarantine(worker.binary, reason);
+      }
+    }
+  }
+
+  shutdown() {
+    for (const job of this.queue) {
+      job.reject(solverError('Solver pool shut down', 'WORKER_CRASHED'));
+    }
+    this.queue = [];
+    for (const worker of this.workers) {
+      worker.child.kill();
+    }
+  }
+
+  schedule() {
+    for (let i = 0; i < this.queue.length; i++) {
+      const job = this.queue[i];
+      const worker = this.acquireWorker(job.binary);
+      if (!worker) continue;
+
+      this.queue.splice(i--, 1);
+      this.dispatch(worker, job);
+    }
+  }
+
+  // Idle worker for binary, a freshly spawned one, or null if every slot is busy
+  acquireWorker(binary) {
+    const idle = this.workers.find(w => !w.job && w.binary === binary);
+    if (idle) return idle;
+
+    if (this.workers.length >= this.maxWorkers) {
+      // Recycle the least recently used idle worker of another heuristic
+      const candidates = this.workers.filter(w => !w.job);
+      if (candidates.length === 0) return null;
+      const victim = candidates.reduce((a, b) => (a.lastUsed <= b.lastUsed ? a : b));
+      this.retire(victim);
+    }
+    return this.spawnWorker(binary);
+  }
+
+  spawnWorker(binary) {
+    const stdio = ['pipe', 'pipe', 'inherit'];
+    const child = binary.endsWith('.so')
+      ? spawn(this.pluginHost, [], { stdio, env: { ...process.env, [PLUGIN_ENV]: binary } })
+      : spawn(binary, [], { stdio });
+    const worker = { binary, child, job: null, lastUsed: Date.now(), decoder: new FrameDecoder(), metricsWaiters: new Map() };
+
+    child.stdout.on('data', chunk => {
+      for (const frame of worker.decoder.push(chunk)) {
+        this.onMessage(worker, frame);
+      }
+    });
+    child.on('error', error => this.onExit(worker, error.message));
+    child.on('exit', (code, signal) => this.onExit(worker, `exit ${signal || code}`));
+    child.stdin.on('error', () => {});
+
+    this.workers.push(worker);
+    return worker;
+  }
+
+  dispatch(worker, job) {
+    worker.job = job;
+    worker.lastUsed = Date.now();
+    job.timer = setTimeout(() => {
+      // The LNS checks its budget every iteration, so overrunning it means an operator call did not return
+      this.quarantine(worker.binary, `an operator call ran past the ${job.timeBudgetMs}ms budget + ${this.graceMs}ms grace`);
+      this.finish(worker, () => job.reject(solverError(`Solver exceeded its ${job.timeBudgetMs}ms budget`, 'TIMEOUT')));
+      this.retire(worker);
+    }, job.timeBudgetMs + this.graceMs);
+    worker.child.stdin.write(job.frame);
+  }
+
+  onMessage(worker, frame) {
+    const job = worker.job;
+    let message;
+    try {
+      message = decodeMessage(frame);
+    } catch (error) {
+      this.finish(worker, () => job && job.reject(error));
+      this.retire(worker);
+      return;
+    }
+    if (message.type === MSG_METRICS) {
+      const waiter = worker.metricsWaiters.get(message.requestId);
+      worker.metricsWaiters.delete(message.requestId);
+      if (waiter) waiter(message);
+      return;
+    }
+    if (!job || message.requestId !== job.requestId) return;
+    if (message.type === MSG_PROGRESS) {
+      if (job.onProgress) job.onProgress(message);
+      return;
+    }
+
+    this.finish(worker, () => {
+      if (message.type === MSG_ERROR) {
+        job.reject(solverError(message.message, 'SOLVER_ERROR'));
+      } else {
+        job.resolve(message);
+      }
+    });
+    this.inspectTail(worker);
+    this.schedule();
+  }
+
+  onExit(worker, reason) {
+    if (!this.workers.includes(worker)) return;
+    this.workers = this.workers.filter(w => w !== worker);
+    const job = worker.job;
+    this.finish(worker, () => job && job.reject(solverError(`Solver process died (${reason})`, 'WORKER_CRASHED')));
+    this.schedule();
+  }
+
+  finish(worker, settle) {
+    if (worker.job) clearTimeout(worker.job.timer);
+    settle();
+    worker.job = null;
+    worker.lastUsed = Date.now();
+  }
+
+  retire(worker) {
+    this.workers = this.workers.filter(w => w !== worker);
+    worker.child.kill('SIGKILL');
+    setImmediate(() => this.schedule());
+  }
+}
+
+module.exports = { SolverPool, heavyTailPhases };
@@ -3,7 +3,12 @@
  * Tests all endpoints and verifies algorithm-specific behavior
  */
 
+const path = require('path');
+const { pathToFileURL } = require('url');
+
 const BASE_URL = 'http://localhost:3001';
+// The frontend's decoder of the stream's route deltas
+const LIVE_SOLUTION = path.join(__dirname, '..', 'src', 'liveSolution.mjs');
 
 // ANSI color codes for terminal output
 const colors = {
@@ -38,6 +43,22 @@ function logInfo(message) {
 // Test counter
 let passed = 0;
 let failed = 0;
+let skipped = 0;
+
+// Whether the server runs the native solver (from /api/health); only a mock-mode server may lack native results
+let nativeSolver = true;
+
+// Tests 9-11 need native results: a mock-mode server skips them, any other server fails them
+function requireNative(message) {
+  if (nativeSolver) {
+    logFail(message);
+    failed++;
+    return false;
+  }
+  logInfo(`${message}, skipped in mock mode`);
+  skipped++;
+  return true;
+}
 
 // Test 1: Health Check
 async function testHealthCheck() {
@@ -201,7 +222,19 @@ async function testParameterValidation() {
   const invalidRequests = [
     { name: 'Missing vrpType', body: { algorithmId: 'test', parameters: {} } },
     { name: 'Missing algorithmId', body: { vrpType: 'cvrp', parameters: {} } },
-    { name: 'Missing parameters', body: { vrpType: 'cvrp', algorithmId: 'test' } }
+    { name: 'Missing parameters', body: { vrpType: 'cvrp', algorithmId: 'test' } },
+    {
+      name: 'Too many customers',
+      body: { vrpType: 'cvrp', algorithmId: 'best_solution_36.3972', parameters: { numCustomers: 1000000, vehicleCapacity: 100, numVehicles: 3 } }
+    },
+    {
+      name: 'Non-numeric capacity',
+      body: { vrpType: 'cvrp', algorithmId: 'best_solution_36.3972', parameters: { numCustomers: 20, vehicleCapacity: 'lots', numVehicles: 3 } }
+    },
+    {
+      name: 'More vehicles than customers',
+      body: { vrpType: 'cvrp', algorithmId: 'best_solution_36.3972', parameters: { numCustomers: 5, vehicleCapacity: 100, numVehicles: 6 } }
+    }
   ];
   
   let allPassed = true;
@@ -406,6 +439,144 @@ async function testSolutionStructure() {
   }
 }
 
+// Test 9: Streaming Solve (Server-Sent Events)
+async function testSolveStream() {
+  logTest('Streaming Solve Endpoint');
+  try {
+    const query = new URLSearchParams({
+      vrpType: 'cvrp',
+      algorithmId: 'best_solution_36.3972',
+      numCustomers: 50,
+      vehicleCapacity: 100,
+      numVehicles: 5,
+      timeBudgetMs: 1000
+    });
+    const response = await fetch(`${BASE_URL}/api/solve/stream?${query}`);
+    const text = await response.text();
+    const events = text.split('\n\n').filter(Boolean).map(block => {
+      const [eventLine, dataLine] = block.split('\n');
+      const event = eventLine.slice('event: '.length);
+      const data = dataLine.slice('data: '.length);
+      // Progress events carry a base64 binary route delta instead of JSON
+      return { event, data: event === 'progress' ? data : JSON.parse(data) };
+    });
+    
+    const names = events.map(e => e.event);
+    const result = events[events.length - 1];
+    
+    if (response.headers.get('content-type') !== 'text/event-stream' ||
+        names[0] !== 'start' ||
+        result.event !== 'result' ||
+        result.data.solution.routes.length === 0) {
+      logFail(`Unexpected event sequence: ${names.join(', ')}`);
+      failed++;
+      return false;
+    }
+    const progress = events.filter(e => e.event === 'progress');
+    if (progress.length === 0) {
+      return requireNative('Stream delivered no progress events');
+    }
+
+    // The deltas of all progress events rebuild the routes of the result
+    const { applyRouteDelta } = await import(pathToFileURL(LIVE_SOLUTION).href);
+    const live = { tours: [] };
+    progress.forEach(e => applyRouteDelta(live, e.data));
+    const routes = result.data.solution.routes.map(route => route.customers.map(customer => customer.id));
+    if (JSON.stringify(live.tours) === JSON.stringify(routes)) {
+      logPass(`Stream delivered start, ${progress.length} progress and result events; the deltas rebuild the result`);
+      passed++;
+      return true;
+    } else {
+      logFail(`Routes rebuilt from ${progress.length} progress events differ from the result`);
+      failed++;
+      return false;
+    }
+  } catch (error) {
+    logFail(`Streaming error: ${error.message}`);
+    failed++;
+    return false;
+  }
+}
+
+// Test 10: Solve Cache
+async function testSolveCache() {
+  logTest('Solve Result Cache');
+  try {
+    const requestBody = {
+      vrpType: 'cvrp',
+      algorithmId: 'best_solution_36.3972',
+      parameters: {
+        numCustomers: 30,
+        vehicleCapacity: 100,
+        numVehicles: 3,
+        instanceSeed: Date.now() % 100000,
+        timeBudgetMs: 500
+      }
+    };
+    const solve = async () => {
+      const response = await fetch(`${BASE_URL}/api/solve`, {
+        method: 'POST',
+        headers: { 'Content-Type': 'application/json' },
+        body: JSON.stringify(requestBody)
+      });
+      return (await response.json()).solution;
+    };
+    
+    const first = await solve();
+    const second = await solve();
+    
+    if (!first.convergence) {
+      return requireNative('Native solver unavailable, cache not exercised');
+    }
+    if (second.cached && second.totalDistance === first.totalDistance) {
+      logPass('Repeated reproducible request was served from the cache');
+      passed++;
+      return true;
+    } else {
+      logFail('Repeated reproducible request was solved again');
+      failed++;
+      return false;
+    }
+  } catch (error) {
+    logFail(`Cache test error: ${error.message}`);
+    failed++;
+    return false;
+  }
+}
+
+// Test 11: LNS Metrics
+async function testMetrics() {
+  logTest('LNS Hot-Path Metrics');
+  try {
+    const response = await fetch(`${BASE_URL}/api/metrics`);
+    const data = await response.json();
+    
+    if (!response.ok || !data.totals) {
+      logFail(`Metrics endpoint returned ${response.status}`);
+      failed++;
+      return false;
+    }
+    if (data.sources.length === 0) {
+      return requireNative('No native solver running, counters not exercised');
+    }
+    const phases = ['select', 'sort', 'reinsert', 'accept', 'bookkeeping'];
+    if (data.totals.iterations > 0 && phases.every(name => data.totals.phases[name])) {
+      logPass(`${data.totals.iterations} iterations over ${data.sources.length} solver(s)`);
+      logInfo(`Time shares: ${phases.map(name => `${name} ${(data.totals.phases[name].share * 100).toFixed(1)}%`).join(', ')}`);
+      passed++;
+      return true;
+    } else {
+      logFail('Metrics are missing iterations or phases');
+      failed++;
+      return false;
+    }
+  } catch (error) {
+    logFail(`Metrics test error: ${error.message}`);
+    failed++;
+    return false;
+  }
+}
+
 // Run all tests
 async function runAllTests() {
   console.log('\n' + '='.repeat(60));
@@ -414,7 +585,8 @@ async function runAllTests() {
   
   // Check if server is running
   try {
-    await fetch(`${BASE_URL}/api/health`);
+    const health = await (await fetch(`${BASE_URL}/api/health`)).json();
+    nativeSolver = health.solverMode !== 'mock';
   } catch (error) {
     log('\n❌ ERROR: Backend server is not running!', 'red');
     log('Please start the server with: cd backend && npm start', 'yellow');
@@ -430,6 +602,9 @@ async function runAllTests() {
   await testDifferentVRPTypes();
   await testLargeProblem();
   await testSolutionStructure();
+  await testSolveStream();
+  await testSolveCache();
+  await testMetrics();
   
   // Summary
   console.log('\n' + '='.repeat(60));
@@ -437,7 +612,8 @@ async function runAllTests() {
   console.log('='.repeat(60));
   log(`✓ Passed: ${passed}`, 'green');
   log(`✗ Failed: ${failed}`, 'red');
-  log(`Total: ${passed + failed}`, 'blue');
+  if (skipped > 0) log(`ℹ Skipped: ${skipped}`, 'yellow');
+  log(`Total: ${passed + failed + skipped}`, 'blue');
   
   if (failed === 0) {
     log('\n🎉 All tests passed!', 'green');
@@ -0,0 +1,135 @@
+/**
+ * Native Framework Tests
+ * Builds the native test driver (backend/native/native_tests.cpp) with the first example heuristic of every
+ * problem type and runs its tests on that type: solution primitives, undo journal, LNS iterations,
+ * the running objective sums and local search moves. It runs them again with the heuristics of
+ * OWN_LAYOUT_HEURISTICS, which declare their own Solution instead of including Solution.h, so a change to
+ * the layout of its leading fields fails the tests.
+ *
+ * Usage: node test-native.js [--types=cvrp,pcvrp,vrptw]
+ * Needs a C++ toolchain; a failed build counts as a failed test.
+ */
+
+const { execFile } = require('child_process');
+const { promisify } = require('util');
+const { compileHeuristic } = require('./solver/compiler');
+const { listHeuristics } = require('./benchmark-operators');
+
+const execFileAsync = promisify(execFile);
+
+// ANSI color codes for terminal output
+const colors = {
+  reset: '\x1b[0m',
+  green: '\x1b[32m',
+  red: '\x1b[31m',
+  yellow: '\x1b[33m',
+  blue: '\x1b[36m',
+  bold: '\x1b[1m'
+};
+
+function log(message, color = 'reset') {
+  console.log(`${colors[color]}${message}${colors.reset}`);
+}
+
+function logTest(name) {
+  console.log(`\n${colors.bold}${colors.blue}Testing: ${name}${colors.reset}`);
+}
+
+function logPass(message) {
+  log(`✓ ${message}`, 'green');
+}
+
+function logFail(message) {
+  log(`✗ ${message}`, 'red');
+}
+
+// Heuristics that copy the leading fields of Solution and Instance into their own declarations.
+// pcvrp_gen_0_ind_88 also declares its own Solution. It is left out because its Instance follows the PCVRP
+// prompt, which has no time-window fields, so no shared Instance layout matches it.
+const OWN_LAYOUT_HEURISTICS = ['vrptw_48.1591'];
+
+// Test counter
+let passed = 0;
+let failed = 0;
+
+function parseArgs(argv) {
+  const options = { types: ['cvrp', 'pcvrp', 'vrptw'] };
+  for (const arg of argv) {
+    const [key, value] = arg.replace(/^--/, '').split('=');
+    switch (key) {
+      case 'types':
+        options.types = value.split(',');
+        break;
+      default:
+        throw new Error(`Unknown option ${arg}`);
+    }
+  }
+  return options;
+}
+
+// Runs the driver's tests of one problem type, linked with heuristic; every line it prints is one test
+async function testType(type, heuristic) {
+  logTest(`${type.toUpperCase()} framework with ${heuristic ? heuristic.name : 'no heuristic'}`);
+  let output;
+  try {
+    if (!heuristic) throw new Error(`no example heuristic for ${type}`);
+    const driver = await compileHeuristic(heuristic, 'tests');
+    output = await execFileAsync(driver, [type], { maxBuffer: 16 * 1024 * 1024 }).catch(error => {
+      // Failed tests exit non-zero; their lines are still on stdout
+      if (!error.stdout) throw error;
+      return error;
+    });
+  } catch (error) {
+    logFail(`${type}: ${error.message}`);
+    failed++;
+    return;
+  }
+
+  for (const line of output.stdout.trim().split('\n')) {
+    const [status, ...rest] = line.trim().split(/\s+/);
+    if (status === 'ok') {
+      logPass(rest.join(' '));
+      passed++;
+    } else {
+      logFail(rest.join(' ') || line);
+      failed++;
+    }
+  }
+  if (output.stderr) {
+    logFail(output.stderr.trim());
+    failed++;
+  }
+  // A crash ends the output early, after tests that passed
+  if (output.signal) {
+    logFail(`${type}: test driver killed by ${output.signal}`);
+    failed++;
+  }
+}
+
+async function runAllTests() {
+  const options = parseArgs(process.argv.slice(2));
+  console.log('\n' + '='.repeat(60));
+  log('Native Framework Tests', 'bold');
+  console.log('='.repeat(60));
+
+  for (const type of options.types) {
+    const [example] = listHeuristics({ types: [type], sets: ['population'], filter: '' });
+    await testType(type, example);
+    const ownLayout = listHeuristics({ types: [type], sets: ['optimized', 'population'], filter: '' })
+      .filter(h => OWN_LAYOUT_HEURISTICS.includes(h.name));
+    for (const heuristic of ownLayout) {
+      await testType(type, heuristic);
+    }
+  }
+
+  console.log('\n' + '='.repeat(60));
+  log(`✓ Passed: ${passed}`, 'green');
+  log(`✗ Failed: ${failed}`, 'red');
+  console.log('='.repeat(60) + '\n');
+  process.exit(failed === 0 ? 0 : 1);
+}
+
+runAllTests().catch(error => {
+  console.error('Test suite error:', error);
+  process.exit(1);
+});
@@ -0,0 +1,191 @@
+/**
+ * Route Delta Round-Trip Test
+ * Encodes progress frames with the native encoder (backend/native/Protocol.cpp) and rebuilds the tours with the
+ * frontend's decoder (src/liveSolution.mjs), the way /api/solve/stream delivers them to the browser:
+ *   1. scripted snapshots: tours added, removed and emptied, and customer ids that need multi-byte varints
+ *   2. a real worker solve: the deltas of all its progress frames rebuild the result's tours
+ *
+ * Needs a C++ toolchain; a missing native build fails the test instead of skipping it.
+ */
+
+const { execFile } = require('child_process');
+const path = require('path');
+const { pathToFileURL } = require('url');
+const { promisify } = require('util');
+const { compileHeuristic, compileSolver, pluginHostPath, usePlugins } = require('./solver/compiler');
+const { listHeuristics } = require('./benchmark-operators');
+const { createInstance } = require('./solver/instance');
+const { SolverPool } = require('./solver/workerPool');
+
+const execFileAsync = promisify(execFile);
+const LIVE_SOLUTION = path.join(__dirname, '..', 'src', 'liveSolution.mjs');
+
+// ANSI color codes for terminal output
+const colors = {
+  reset: '\x1b[0m',
+  green: '\x1b[32m',
+  red: '\x1b[31m',
+  yellow: '\x1b[33m',
+  blue: '\x1b[36m',
+  bold: '\x1b[1m'
+};
+
+function log(message, color = 'reset') {
+  console.log(`${colors[color]}${message}${colors.reset}`);
+}
+
+function logTest(name) {
+  console.log(`\n${colors.bold}${colors.blue}Testing: ${name}${colors.reset}`);
+}
+
+function logPass(message) {
+  log(`✓ ${message}`, 'green');
+}
+
+function logFail(message) {
+  log(`✗ ${message}`, 'red');
+}
+
+function logInfo(message) {
+  log(`ℹ ${message}`, 'yellow');
+}
+
+// Test counter
+let passed = 0;
+let failed = 0;
+
+// Snapshots in the order they are encoded; each differs from the previous one in the way its label says
+const SNAPSHOTS = [
+  { label: 'first frame carries every tour', tours: [[1, 2, 3], [4, 5], [6]] },
+  { label: 'tour added', tours: [[1, 2, 3], [4, 5], [6], [130, 7]] },
+  { label: 'customer moved between tours', tours: [[1, 3], [4, 2, 5], [6], [130, 7]] },
+  { label: 'tour removed from the middle', tours: [[1, 3], [6], [130, 7]] },
+  { label: 'tour emptied', tours: [[1, 3], [], [130, 7, 6]] },
+  { label: 'emptied tour refilled', tours: [[1, 3], [6], [130, 7]] },
+  { label: 'multi-byte customer ids', tours: [[1, 3], [6, 128, 16383, 16384], [2097152, 130, 7]] },
+  { label: 'middle of a tour replaced', tours: [[1, 3], [6, 255, 16384], [2097152, 7]] },
+  { label: 'trailing tours dropped', tours: [[1, 3]] },
+  { label: 'all tours dropped', tours: [] },
+  { label: 'tours after an empty frame', tours: [[200], [1, 2, 3]] }
+];
+
+const sameTours = (a, b) => JSON.stringify(a) === JSON.stringify(b);
+
+// A live solution without node arrays; only its tours matter here
+const emptyLive = () => ({ tours: [], objective: null, iteration: 0 });
+
+async function buildTestDriver() {
+  const [heuristic] = listHeuristics({ types: ['cvrp'], sets: ['population'], filter: '' });
+  return compileHeuristic(heuristic, 'tests');
+}
+
+// Test 1: Scripted snapshots through the native encoder
+async function testScriptedSnapshots(applyRouteDelta) {
+  logTest('Scripted Snapshots');
+  try {
+    const driver = await buildTestDriver();
+    const input = SNAPSHOTS.map(({ tours }) => [tours.length, ...tours.flatMap(tour => [tour.length, ...tour])].join(' ')).join('\n');
+    const child = execFileAsync(driver, ['encode-progress']);
+    child.child.stdin.end(input + '\n');
+    const { stdout } = await child;
+    const frames = stdout.trim().split('\n');
+
+    if (frames.length !== SNAPSHOTS.length) {
+      logFail(`Encoder wrote ${frames.length} frames for ${SNAPSHOTS.length} snapshots`);
+      failed++;
+      return false;
+    }
+    const live = emptyLive();
+    const mismatches = [];
+    SNAPSHOTS.forEach((snapshot, i) => {
+      applyRouteDelta(live, Buffer.from(frames[i], 'hex').toString('base64'));
+      if (!sameTours(live.tours, snapshot.tours) || live.iteration !== i) {
+        mismatches.push(`${snapshot.label}: got ${JSON.stringify(live.tours)}, expected ${JSON.stringify(snapshot.tours)}`);
+      }
+    });
+
+    if (mismatches.length === 0) {
+      logPass(`${SNAPSHOTS.length} consecutive frames rebuilt every snapshot`);
+      passed++;
+      return true;
+    } else {
+      mismatches.forEach(logFail);
+      failed++;
+      return false;
+    }
+  } catch (error) {
+    logFail(`Scripted snapshot error: ${error.message}`);
+    failed++;
+    return false;
+  }
+}
+
+// Test 2: Progress frames of a real solve
+async function testWorkerSolve(applyRouteDelta) {
+  logTest('Worker Solve Progress Frames');
+  const pool = new SolverPool({ maxWorkers: 1, pluginHost: usePlugins() ? pluginHostPath('worker') : null });
+  try {
+    const binary = await compileSolver('cvrp', 'best_solution_36.3972');
+    let state = 7;
+    const random = () => {
+      state = (state * 1103515245 + 12345) % 2147483648;
+      return state / 2147483648;
+    };
+    const customers = Array.from({ length: 300 }, () => ({ x: random() * 1000, y: random() * 600, demand: 5 + Math.floor(random() * 15) }));
+    const instance = createInstance('cvrp', customers, { vehicleCapacity: 100, depot: { x: 500, y: 300 } });
+
+    const frames = [];
+    const result = await pool.solve(binary, instance, {
+      timeBudgetMs: 1500,
+      seed: 3,
+      progressIntervalMs: 50,
+      onProgress: progress => frames.push(progress.routeDelta.toString('base64'))
+    });
+
+    const live = emptyLive();
+    const tourCounts = new Set();
+    for (const frame of frames) {
+      applyRouteDelta(live, frame);
+      tourCounts.add(live.tours.length);
+    }
+    const expected = result.tours.map(tour => tour.customers);
+    logInfo(`${frames.length} progress frames, ${tourCounts.size} distinct tour counts, final objective ${result.objective.toFixed(1)}`);
+
+    if (frames.length > 1 && sameTours(live.tours, expected) && Math.fround(live.objective) === Math.fround(result.objective)) {
+      logPass(`Rebuilt ${expected.length} tours match the result`);
+      passed++;
+      return true;
+    } else {
+      logFail(`Rebuilt tours differ from the result after ${frames.length} frames`);
+      failed++;
+      return false;
+    }
+  } catch (error) {
+    logFail(`Worker solve error: ${error.message}`);
+    failed++;
+    return false;
+  } finally {
+    pool.shutdown();
+  }
+}
+
+async function runAllTests() {
+  console.log('\n' + '='.repeat(60));
+  log('Route Delta Round-Trip Tests', 'bold');
+  console.log('='.repeat(60));
+
+  const { applyRouteDelta } = await import(pathToFileURL(LIVE_SOLUTION).href);
+  await testScriptedSnapshots(applyRouteDelta);
+  await testWorkerSolve(applyRouteDelta);
+
+  console.log('\n' + '='.repeat(60));
+  log(`✓ Passed: ${passed}`, 'green');
+  log(`✗ Failed: ${failed}`, 'red');
+  console.log('='.repeat(60) + '\n');
+  process.exit(failed === 0 ? 0 : 1);
+}
+
+runAllTests().catch(error => {
+  console.error('Test suite error:', error);
+  process.exit(1);
+});
@@ -1,9 +1,10 @@
-import { useState } from 'react'
+import { useRef, useState } from 'react'
 import AlgorithmSelector from './components/AlgorithmSelector'
 import VRPVisualizer from './components/VRPVisualizer'
 import PerformanceMetrics from './components/PerformanceMetrics'
 import ParameterPanel from './components/ParameterPanel'
 import LoadingSpinner from './components/LoadingSpinner'
+import { applyRouteDelta, createLiveSolution } from './liveSolution.mjs'
 import './App.css'
 
 function App() {
@@ -12,27 +13,131 @@ function App() {
   const [solution, setSolution] = useState(null)
   const [metrics, setMetrics] = useState(null)
   const [isRunning, setIsRunning] = useState(false)
+  const [isStreaming, setIsStreaming] = useState(false)
+  const [live, setLive] = useState(null)
+  const [liveVersion, setLiveVersion] = useState(0)
+  const streamRef = useRef(null)
   const [parameters, setParameters] = useState({
     numCustomers: 50,
     vehicleCapacity: 100,
     numVehicles: 5
   })
 
-  const runAlgorithm = async () => {
+  // Use environment variable or detect production
+  const getApiUrl = () => {
+    const API_URL = import.meta.env.VITE_API_URL || 
+                    (window.location.hostname === 'localhost' 
+                      ? 'http://localhost:3001' 
+                      : 'https://vrpagent-visualizer.vercel.app')
+    
+    // Remove trailing slash to prevent double slash
+    return API_URL.replace(/\/$/, '')
+  }
+
+  const showResult = (data) => {
+    setSolution(data.solution)
+    setMetrics({
+      executionTime: data.metrics.executionTime.toFixed(2),
+      totalDistance: data.metrics.totalDistance.toFixed(2),
+      numRoutes: data.metrics.numRoutes,
+      avgRouteLength: data.metrics.avgRouteLength.toFixed(2),
+      customersServed: data.metrics.customersServed
+    })
+  }
+
+  const showMockSolution = () => {
+    const mockSolution = generateMockSolution(parameters)
+    setSolution(mockSolution)
+    setMetrics({
+      executionTime: '0',
+      totalDistance: mockSolution.totalDistance.toFixed(2),
+      numRoutes: mockSolution.routes.length,
+      avgRouteLength: (mockSolution.totalDistance / mockSolution.routes.length).toFixed(2),
+      customersServed: mockSolution.routes.reduce((sum, r) => sum + r.customers.length, 0)
+    })
+  }
+
+  // Stream incumbent improvements over Server-Sent Events so the canvas shows convergence live.
+  // Falls back to the blocking POST /api/solve when the stream fails before delivering anything.
+  const runAlgorithm = () => {
     if (!selectedAlgorithm) return
     
+    setIsRunning(true)
+    setLive(null)
+    
+    const API_URL = getApiUrl()
+    const query = new URLSearchParams({
+      vrpType,
+      algorithmId: selectedAlgorithm.id,
+      ...parameters
+    })
+    const source = new EventSource(`${API_URL}/api/solve/stream?${query}`)
+    const stream = { source, id: null, live: null, received: false }
+    streamRef.current = stream
+
+    const close = () => {
+      source.close()
+      if (streamRef.current === stream) streamRef.current = null
+      setIsStreaming(false)
+      setIsRunning(false)
+    }
+
+    source.addEventListener('start', (event) => {
+      const data = JSON.parse(event.data)
+      stream.id = data.streamId
+      stream.live = createLiveSolution(data)
+      stream.received = true
+    })
+
+    // Deltas build on each other, so every one is applied here rather than in a render that may skip some
+    source.addEventListener('progress', (event) => {
+      applyRouteDelta(stream.live, event.data)
+      setLive(stream.live)
+      setLiveVersion(version => version + 1)
+      setIsStreaming(true)
+    })
+
+    source.addEventListener('result', (event) => {
+      showResult(JSON.parse(event.data))
+      setLive(null)
+      close()
+    })
+
+    // Named 'error' events come from the server; plain ones signal a broken connection
+    source.addEventListener('error', (event) => {
+      close()
+      if (!stream.received) {
+        runAlgorithmBlocking()
+        return
+      }
+      const data = event.data ? JSON.parse(event.data) : {}
+      if (data.error && data.code !== 'CANCELLED') {
+        console.error('Error running algorithm:', data.error)
+        alert('Failed to run algorithm.')
+      }
+    })
+  }
+
+  const stopAlgorithm = async () => {
+    const stream = streamRef.current
+    if (!stream || !stream.id) return
+    try {
+      await fetch(`${getApiUrl()}/api/solve/stream/${stream.id}/cancel`, { method: 'POST' })
+    } catch (error) {
+      // The server also cancels once the connection closes
+      stream.source.close()
+      streamRef.current = null
+      setIsStreaming(false)
+      setIsRunning(false)
+    }
+  }
+
+  const runAlgorithmBlocking = async () => {
     setIsRunning(true)
     
     try {
       // Call backend API
-      // Use environment variable or detect production
-      let API_URL = import.meta.env.VITE_API_URL || 
-                    (window.location.hostname === 'localhost' 
-                      ? 'http://localhost:3001' 
-                      : 'https://vrpagent-visualizer.vercel.app')
-      
-      // Remove trailing slash to prevent double slash
-      API_URL = API_URL.replace(/\/$/, '')
+      const API_URL = getApiUrl()
       
       console.log('Using API URL:', API_URL) // Debug log
       
@@ -52,30 +157,13 @@ function App() {
         throw new Error('Failed to solve VRP problem')
       }
 
-      const data = await response.json()
-      
-      setSolution(data.solution)
-      setMetrics({
-        executionTime: data.metrics.executionTime.toFixed(2),
-        totalDistance: data.metrics.totalDistance.toFixed(2),
-        numRoutes: data.metrics.numRoutes,
-        avgRouteLength: data.metrics.avgRouteLength.toFixed(2),
-        customersServed: data.metrics.customersServed
-      })
+      showResult(await response.json())
     } catch (error) {
       console.error('Error running algorithm:', error)
       alert('Failed to run algorithm. Make sure the backend server is running on port 3001.')
       
       // Fallback to mock solution
-      const mockSolution = generateMockSolution(parameters)
-      setSolution(mockSolution)
-      setMetrics({
-        executionTime: '0',
-        totalDistance: mockSolution.totalDistance.toFixed(2),
-        numRoutes: mockSolution.routes.length,
-        avgRouteLength: (mockSolution.totalDistance / mockSolution.routes.length).toFixed(2),
-        customersServed: mockSolution.routes.reduce((sum, r) => sum + r.customers.length, 0)
-      })
+      showMockSolution()
     } finally {
       setIsRunning(false)
     }
@@ -153,12 +241,18 @@ function App() {
           >
             <span>{isRunning ? '⏳ Running...' : '▶️ Run Algorithm'}</span>
           </button>
+
+          {isStreaming && (
+            <button className="run-button stop-button" onClick={stopAlgorithm}>
+              <span>⏹️ Stop (keep best so far)</span>
+            </button>
+          )}
           
           {metrics && <PerformanceMetrics metrics={metrics} />}
         </div>
 
         <div className="right-panel">
-          {isRunning ? <LoadingSpinner /> : <VRPVisualizer solution={solution} />}
+          {isRunning && !isStreaming ? <LoadingSpinner /> : <VRPVisualizer solution={solution} live={live} liveVersion={liveVersion} />}
         </div>
       </div>
 
@@ -6,11 +6,16 @@ const COLORS = [
   '#38b2ac', '#ed64a6', '#ecc94b', '#4299e1', '#fc8181'
 ]
 
-function VRPVisualizer({ solution }) {
+function VRPVisualizer({ solution, live, liveVersion }) {
   const canvasRef = useRef(null)
 
   useEffect(() => {
-    if (!solution || !canvasRef.current) return
+    if ((!solution && !live) || !canvasRef.current) return
+
+    // Routes as lists of stops; a live stream looks customers up in its node arrays
+    const routes = live
+      ? live.tours.map(tour => ({ customers: tour.map(id => ({ id, x: live.x[id], y: live.y[id] })) }))
+      : solution.routes
 
     const canvas = canvasRef.current
     const ctx = canvas.getContext('2d')
@@ -35,7 +40,7 @@ function VRPVisualizer({ solution }) {
     ctx.stroke()
 
     // Draw routes
-    solution.routes.forEach((route, routeIndex) => {
+    routes.forEach((route, routeIndex) => {
       const color = COLORS[routeIndex % COLORS.length]
       
       // Draw route lines
@@ -73,9 +78,9 @@ function VRPVisualizer({ solution }) {
 
     // Draw legend
     ctx.fillStyle = '#1e293b'
-    ctx.fillRect(10, 10, 150, solution.routes.length * 25 + 20)
+    ctx.fillRect(10, 10, 150, routes.length * 25 + 20)
     
-    solution.routes.forEach((route, idx) => {
+    routes.forEach((route, idx) => {
       const y = 30 + idx * 25
       ctx.fillStyle = COLORS[idx % COLORS.length]
       ctx.fillRect(20, y - 8, 15, 15)
@@ -85,12 +90,12 @@ function VRPVisualizer({ solution }) {
       ctx.fillText(`Route ${idx + 1} (${route.customers.length})`, 45, y + 4)
     })
 
-  }, [solution])
+  }, [solution, live, liveVersion])
 
   return (
     <div className="vrp-visualizer">
       <h2>Route Visualization</h2>
-      {!solution ? (
+      {!solution && !live ? (
         <div className="empty-state">
           <div className="empty-icon">🗺️</div>
           <p>Select an algorithm and click "Run" to visualize routes</p>
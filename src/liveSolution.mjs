@@ -0,0 +1,53 @@
+// Live solution of /api/solve/stream, rebuilt in the browser from the events' binary payloads. A plain ES module
+// without JSX so that backend/test-route-delta.js can run the same decoder in Node.
+
+const decodeBase64 = (text) => Uint8Array.from(atob(text), c => c.charCodeAt(0))
+
+// Decodes the 'start' event of /api/solve/stream: node arrays indexed by customer id, sent once per instance
+export function createLiveSolution(start) {
+  return {
+    x: new Float32Array(decodeBase64(start.x).buffer),
+    y: new Float32Array(decodeBase64(start.y).buffer),
+    demand: new Int32Array(decodeBase64(start.demand).buffer),
+    tours: [],
+    objective: null,
+    iteration: 0
+  }
+}
+
+// Applies one base64 'progress' route delta (layout in backend/native/Protocol.h) to live.tours in place
+export function applyRouteDelta(live, text) {
+  const bytes = decodeBase64(text)
+  const view = new DataView(bytes.buffer)
+  let offset = 12
+  const varint = () => {
+    let value = 0
+    let shift = 0
+    let byte
+    do {
+      byte = bytes[offset++]
+      value += (byte & 0x7f) * 2 ** shift
+      shift += 7
+    } while (byte & 0x80)
+    return value
+  }
+
+  live.objective = view.getFloat32(0, true)
+  live.iteration = view.getUint32(4, true)
+  live.elapsedMs = view.getFloat32(8, true)
+
+  const numTours = varint()
+  const numChanged = varint()
+  for (let i = 0; i < numChanged; i++) {
+    const index = varint()
+    const keepPrefix = varint()
+    const keepSuffix = varint()
+    const inserted = new Array(varint())
+    for (let j = 0; j < inserted.length; j++) {
+      inserted[j] = varint()
+    }
+    const tour = live.tours[index] || (live.tours[index] = [])
+    tour.splice(keepPrefix, tour.length - keepPrefix - keepSuffix, ...inserted)
+  }
+  live.tours.length = numTours
+}